@@ -24,9 +24,11 @@
 #ifndef GOBY_ACOMMS_BUFFER_DYNAMIC_BUFFER_H
 #define GOBY_ACOMMS_BUFFER_DYNAMIC_BUFFER_H
 
+#include <algorithm>
 #include <deque>
+#include <map>
+#include <set>
 #include <type_traits>
-#include <unordered_map>
 #include <vector>
 
 #include "goby/acomms/acomms_constants.h"
@@ -162,7 +164,9 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
             if (datum_last_access == zero_point_ || datum_last_access + ack_timeout < reference)
             {
                 last_access_ = reference;
+                forget_send(datum_last_access);
                 datum_last_access = last_access_;
+                record_send(datum_last_access);
                 return datum_pair.second;
             }
         }
@@ -174,13 +178,20 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
     all_waiting_for_ack(typename Clock::time_point reference = Clock::now(),
                         typename Clock::duration ack_timeout = std::chrono::microseconds(0)) const
     {
-        for (const auto& datum_pair : data_)
-        {
-            const auto& datum_last_access = datum_pair.first;
-            if (datum_last_access == zero_point_ || datum_last_access + ack_timeout < reference)
-                return false;
-        }
-        return true;
+        if (unsent_ > 0)
+            return false;
+        return send_times_.empty() || !(oldest_send_time() + ack_timeout < reference);
+    }
+
+    /// \brief Earliest time that any value still in the queue was last sent (returned by top()). Only meaningful if there is at least one value that has been sent.
+    typename Clock::time_point oldest_send_time() const { return *send_times_.begin(); }
+
+    /// \brief Time at which the current blackout ends (in_blackout() is false for any reference after this time)
+    typename Clock::time_point blackout_end() const
+    {
+        auto blackout =
+            goby::time::convert_duration<typename Clock::duration>(cfg_.blackout_time_with_units());
+        return last_access_ + blackout;
     }
 
     enum class ValueResult
@@ -230,10 +241,7 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
     /// \param reference time point to use for current reference when calculating blackout
     bool in_blackout(typename Clock::time_point reference = Clock::now()) const
     {
-        auto blackout =
-            goby::time::convert_duration<typename Clock::duration>(cfg_.blackout_time_with_units());
-
-        return reference <= (last_access_ + blackout);
+        return reference <= blackout_end();
     }
     /// \brief Returns if this queue is empty
     bool empty() const { return data_.empty(); }
@@ -242,7 +250,11 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
     size_type size() const { return data_.size(); }
 
     /// \brief Pop the value on the top of the queue
-    void pop() { data_.pop_front(); }
+    void pop()
+    {
+        forget_send(data_.front().first);
+        data_.pop_front();
+    }
 
     /// \brief Push a value to the queue
     ///
@@ -257,10 +269,12 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
             data_.push_front(std::make_pair(zero_point_, Value({reference, t})));
         else
             data_.push_back(std::make_pair(zero_point_, Value({reference, t})));
+        ++unsent_;
 
         while (data_.size() > cfg_.max_queue())
         {
             exceeded.push_back(data_.back().second);
+            forget_send(data_.back().first);
             data_.pop_back();
         }
         return exceeded;
@@ -279,6 +293,7 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
             while (!data_.empty() && reference > (data_.back().second.push_time + ttl))
             {
                 expired.push_back(data_.back().second);
+                forget_send(data_.back().first);
                 data_.pop_back();
             }
         }
@@ -287,6 +302,7 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
             while (!data_.empty() && reference > (data_.front().second.push_time + ttl))
             {
                 expired.push_back(data_.front().second);
+                forget_send(data_.front().first);
                 data_.pop_front();
             }
         }
@@ -306,6 +322,7 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
             const auto& datum_pair = it->second;
             if (datum_pair == value)
             {
+                forget_send(it->first);
                 data_.erase(it);
                 return true;
             }
@@ -319,6 +336,23 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
         return false;
     }
 
+  private:
+    void record_send(typename Clock::time_point last_send)
+    {
+        if (last_send == zero_point_)
+            ++unsent_;
+        else
+            send_times_.insert(last_send);
+    }
+
+    void forget_send(typename Clock::time_point last_send)
+    {
+        if (last_send == zero_point_)
+            --unsent_;
+        else
+            send_times_.erase(send_times_.find(last_send));
+    }
+
   private:
     goby::acomms::protobuf::DynamicBufferConfig cfg_;
 
@@ -327,9 +361,15 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicSub
     typename Clock::time_point last_access_{Clock::now()};
 
     typename Clock::time_point zero_point_{std::chrono::seconds(0)};
+
+    // summary of the last send times in data_ so that all_waiting_for_ack() doesn't need to scan
+    size_type unsent_{0};
+    std::multiset<typename Clock::time_point> send_times_;
 };
 
 /// Represents a time-dependent priority queue for several groups of messages (multiple DynamicSubBuffers)
+///
+/// The priority contest in top() only visits subbuffers that may currently provide a value. Subbuffers found to be empty are dropped from the contest until the next push(), and subbuffers in blackout or waiting for all their messages to be acknowledged are parked until their deadline passes.
 template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuffer
 {
   public:
@@ -341,6 +381,12 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
     }
     ~DynamicBuffer() {}
 
+    // the contest schedule refers to the subbuffers by iterator
+    DynamicBuffer(const DynamicBuffer&) = delete;
+    DynamicBuffer& operator=(const DynamicBuffer&) = delete;
+    DynamicBuffer(DynamicBuffer&&) = default;
+    DynamicBuffer& operator=(DynamicBuffer&&) = default;
+
     using subbuffer_id_type = std::string;
     using size_type = typename DynamicSubBuffer<T, Clock>::size_type;
     using modem_id_type = int;
@@ -424,9 +470,15 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
     {
         auto it = sub_[dest_id].find(sub_id);
         if (it != sub_[dest_id].end())
+        {
             it->second.update(cfgs);
+            // blackout may have been shortened
+            schedule(dest_id, it);
+        }
         else
+        {
             create(dest_id, sub_id, cfgs);
+        }
     }
 
     /// \brief Remove an existing subbuffer
@@ -435,7 +487,13 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
     /// \param sub_id An identifier for this subbuffer
     void remove(modem_id_type dest_id, const subbuffer_id_type& sub_id)
     {
-        sub_[dest_id].erase(sub_id);
+        auto& dest_subs = sub_[dest_id];
+        auto it = dest_subs.find(sub_id);
+        if (it != dest_subs.end())
+        {
+            unschedule(dest_id, it);
+            dest_subs.erase(it);
+        }
     }
 
     /// \brief Push a new message to the buffer
@@ -446,7 +504,9 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
     std::vector<Value> push(const Value& fvt)
     {
         std::vector<Value> exceeded;
-        auto sub_exceeded = sub(fvt.modem_id, fvt.subbuffer_id).push(fvt.data, fvt.push_time);
+        auto it = find_sub(fvt.modem_id, fvt.subbuffer_id);
+        auto sub_exceeded = it->second.push(fvt.data, fvt.push_time);
+        schedule(fvt.modem_id, it);
         for (const auto& e : sub_exceeded)
             exceeded.push_back({fvt.modem_id, fvt.subbuffer_id, e.push_time, e.data});
         return exceeded;
@@ -489,80 +549,74 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
               typename Clock::duration ack_timeout = std::chrono::microseconds(0))
     {
         using goby::glog;
+        using ValueResult = typename DynamicSubBuffer<T, Clock>::ValueResult;
 
         glog.is_debug1() && glog << group(glog_priority_group_)
                                  << "Starting priority contest:" << std::endl;
 
-        typename std::unordered_map<subbuffer_id_type, DynamicSubBuffer<T, Clock>>::iterator
-            winning_sub;
-        double winning_value = -std::numeric_limits<double>::infinity();
-
         auto now = Clock::now();
 
         if (dest_id != goby::acomms::QUERY_DESTINATION_ID && !sub_.count(dest_id))
             throw(DynamicBufferNoDataException());
 
+        wake(now, ack_timeout);
+
+        auto winning_it = contestants_.end();
+        double winning_value = -std::numeric_limits<double>::infinity();
+
         // if QUERY_DESTINATION_ID, search all subbuffers, otherwise just search the ones that were specified by dest_id
-        for (auto sub_id_it = (dest_id == goby::acomms::QUERY_DESTINATION_ID) ? sub_.begin()
-                                                                              : sub_.find(dest_id),
-                  sub_id_end = (dest_id == goby::acomms::QUERY_DESTINATION_ID)
-                                   ? sub_.end()
-                                   : ++sub_.find(dest_id);
-             sub_id_it != sub_id_end; ++sub_id_it)
+        for (auto it = (dest_id == goby::acomms::QUERY_DESTINATION_ID)
+                           ? contestants_.begin()
+                           : contestants_.lower_bound(dest_id),
+                  end = (dest_id == goby::acomms::QUERY_DESTINATION_ID)
+                            ? contestants_.end()
+                            : contestants_.upper_bound(dest_id);
+             it != end;)
         {
-            for (auto sub_it = sub_id_it->second.begin(), sub_end = sub_id_it->second.end();
-                 sub_it != sub_end; ++sub_it)
+            const auto& subbuffer = it->second->second;
+            double value;
+            ValueResult result;
+            std::tie(value, result) = subbuffer.top_value(now, max_bytes, ack_timeout);
+
+            if (glog.is_debug1())
+                log_contestant(*it, value, result);
+
+            switch (result)
             {
-                double value;
-                typename DynamicSubBuffer<T, Clock>::ValueResult result;
-                std::tie(value, result) = sub_it->second.top_value(now, max_bytes, ack_timeout);
-
-                std::string value_or_reason;
-                switch (result)
-                {
-                    case DynamicSubBuffer<T, Clock>::ValueResult::VALUE_PROVIDED:
-                        value_or_reason = std::to_string(value);
-                        break;
-
-                    case DynamicSubBuffer<T, Clock>::ValueResult::EMPTY:
-                        value_or_reason = "empty";
-                        break;
-
-                    case DynamicSubBuffer<T, Clock>::ValueResult::IN_BLACKOUT:
-                        value_or_reason = "blackout";
-                        break;
-
-                    case DynamicSubBuffer<T, Clock>::ValueResult::NEXT_MESSAGE_TOO_LARGE:
-                        value_or_reason = "too large";
-                        break;
-
-                    case DynamicSubBuffer<T, Clock>::ValueResult::ALL_MESSAGES_WAITING_FOR_ACK:
-                        value_or_reason = "ack wait";
-                        break;
-                }
-
-                glog.is_debug1() && glog << group(glog_priority_group_) << "\t" << sub_it->first
-                                         << " [dest: " << sub_id_it->first
-                                         << ", n: " << sub_it->second.size()
-                                         << "]: " << value_or_reason << std::endl;
-
-                if (value > winning_value)
-                {
-                    winning_value = value;
-                    winning_sub = sub_it;
-                    dest_id = sub_id_it->first;
-                }
+                case ValueResult::VALUE_PROVIDED:
+                    if (value > winning_value)
+                    {
+                        winning_value = value;
+                        winning_it = it;
+                    }
+                    ++it;
+                    break;
+
+                case ValueResult::NEXT_MESSAGE_TOO_LARGE: ++it; break;
+
+                case ValueResult::EMPTY: it = contestants_.erase(it); break;
+
+                case ValueResult::IN_BLACKOUT:
+                    park(blackout_parked_, subbuffer.blackout_end(), *it);
+                    it = contestants_.erase(it);
+                    break;
+
+                case ValueResult::ALL_MESSAGES_WAITING_FOR_ACK:
+                    park(ack_parked_, subbuffer.oldest_send_time(), *it);
+                    it = contestants_.erase(it);
+                    break;
             }
         }
 
-        if (winning_value == -std::numeric_limits<double>::infinity())
+        if (winning_it == contestants_.end())
             throw(DynamicBufferNoDataException());
 
-        glog.is_debug1() && glog << group(glog_priority_group_) << "Winner: " << winning_sub->first
-                                 << std::endl;
+        const auto& winner = *winning_it;
+        glog.is_debug1() && glog << group(glog_priority_group_)
+                                 << "Winner: " << winner.second->first << std::endl;
 
-        const auto& top_p = winning_sub->second.top(now, ack_timeout);
-        return {dest_id, winning_sub->first, top_p.push_time, top_p.data};
+        const auto& top_p = winner.second->second.top(now, ack_timeout);
+        return {winner.first, winner.second->first, top_p.push_time, top_p.data};
     }
 
     /// \brief Erase a value
@@ -599,15 +653,142 @@ template <typename T, typename Clock = goby::time::SteadyClock> class DynamicBuf
     /// \throw goby::Exception If subbuffer doesn't exist
     DynamicSubBuffer<T, Clock>& sub(modem_id_type dest_id, const subbuffer_id_type& sub_id)
     {
-        if (!sub_.count(dest_id) || !sub_.at(dest_id).count(sub_id))
-            throw(goby::Exception("Subbuffer ID: " + sub_id +
-                                  " does not exist, must call create(...) first."));
-        return sub_.at(dest_id).at(sub_id);
+        auto it = find_sub(dest_id, sub_id);
+        // the caller may modify the subbuffer, so put it back in the contest
+        schedule(dest_id, it);
+        return it->second;
+    }
+
+  private:
+    using sub_map_type = std::map<subbuffer_id_type, DynamicSubBuffer<T, Clock>>;
+    using contestant_type = std::pair<modem_id_type, typename sub_map_type::iterator>;
+
+    // same order as iterating sub_, so that ties are broken as in a contest of every subbuffer
+    struct ContestOrder
+    {
+        using is_transparent = void;
+        bool operator()(const contestant_type& a, const contestant_type& b) const
+        {
+            return a.first < b.first || (a.first == b.first && a.second->first < b.second->first);
+        }
+        bool operator()(const contestant_type& a, modem_id_type b) const { return a.first < b; }
+        bool operator()(modem_id_type a, const contestant_type& b) const { return a < b.first; }
+    };
+
+    struct Parked
+    {
+        typename Clock::time_point deadline;
+        contestant_type contestant;
+    };
+
+    // min-heap on deadline
+    struct ParkedLater
+    {
+        bool operator()(const Parked& a, const Parked& b) const { return a.deadline > b.deadline; }
+    };
+
+    typename sub_map_type::iterator find_sub(modem_id_type dest_id, const subbuffer_id_type& sub_id)
+    {
+        auto dest_it = sub_.find(dest_id);
+        if (dest_it != sub_.end())
+        {
+            auto it = dest_it->second.find(sub_id);
+            if (it != dest_it->second.end())
+                return it;
+        }
+        throw(goby::Exception("Subbuffer ID: " + sub_id +
+                              " does not exist, must call create(...) first."));
+    }
+
+    void schedule(modem_id_type dest_id, typename sub_map_type::iterator it)
+    {
+        contestants_.insert(std::make_pair(dest_id, it));
+    }
+
+    void unschedule(modem_id_type dest_id, typename sub_map_type::iterator it)
+    {
+        contestants_.erase(std::make_pair(dest_id, it));
+        for (auto* parked : {&blackout_parked_, &ack_parked_})
+        {
+            auto is_removed = [&](const Parked& p) { return p.contestant.second == it; };
+            parked->erase(std::remove_if(parked->begin(), parked->end(), is_removed),
+                          parked->end());
+            std::make_heap(parked->begin(), parked->end(), ParkedLater());
+        }
+    }
+
+    void park(std::vector<Parked>& parked, typename Clock::time_point deadline,
+              const contestant_type& contestant)
+    {
+        parked.push_back({deadline, contestant});
+        std::push_heap(parked.begin(), parked.end(), ParkedLater());
+    }
+
+    // Return parked subbuffers to the contest once their deadline has passed.
+    // Pushes may make a parked subbuffer eligible sooner, but these also call schedule(), so
+    // stale entries left in the heaps only cause a harmless extra check.
+    void wake(typename Clock::time_point reference, typename Clock::duration ack_timeout)
+    {
+        // in_blackout() is true up to and including blackout_end()
+        while (!blackout_parked_.empty() && blackout_parked_.front().deadline < reference)
+        {
+            contestants_.insert(blackout_parked_.front().contestant);
+            std::pop_heap(blackout_parked_.begin(), blackout_parked_.end(), ParkedLater());
+            blackout_parked_.pop_back();
+        }
+
+        // ack_timeout can change between calls, but the heap order on the last send time doesn't
+        while (!ack_parked_.empty() && ack_parked_.front().deadline + ack_timeout < reference)
+        {
+            contestants_.insert(ack_parked_.front().contestant);
+            std::pop_heap(ack_parked_.begin(), ack_parked_.end(), ParkedLater());
+            ack_parked_.pop_back();
+        }
+    }
+
+    void log_contestant(const contestant_type& contestant, double value,
+                        typename DynamicSubBuffer<T, Clock>::ValueResult result) const
+    {
+        using goby::glog;
+        std::string value_or_reason;
+        switch (result)
+        {
+            case DynamicSubBuffer<T, Clock>::ValueResult::VALUE_PROVIDED:
+                value_or_reason = std::to_string(value);
+                break;
+
+            case DynamicSubBuffer<T, Clock>::ValueResult::EMPTY:
+                value_or_reason = "empty";
+                break;
+
+            case DynamicSubBuffer<T, Clock>::ValueResult::IN_BLACKOUT:
+                value_or_reason = "blackout";
+                break;
+
+            case DynamicSubBuffer<T, Clock>::ValueResult::NEXT_MESSAGE_TOO_LARGE:
+                value_or_reason = "too large";
+                break;
+
+            case DynamicSubBuffer<T, Clock>::ValueResult::ALL_MESSAGES_WAITING_FOR_ACK:
+                value_or_reason = "ack wait";
+                break;
+        }
+
+        glog << group(glog_priority_group_) << "\t" << contestant.second->first
+             << " [dest: " << contestant.first << ", n: " << contestant.second->second.size()
+             << "]: " << value_or_reason << std::endl;
     }
 
   private:
     // destination -> subbuffer id (group/type) -> subbuffer
-    std::map<modem_id_type, std::unordered_map<subbuffer_id_type, DynamicSubBuffer<T, Clock>>> sub_;
+    std::map<modem_id_type, sub_map_type> sub_;
+
+    // subbuffers that may be able to provide a value (a superset, pruned lazily by top())
+    std::set<contestant_type, ContestOrder> contestants_;
+    // subbuffers waiting for blackout_end() to pass
+    std::vector<Parked> blackout_parked_;
+    // subbuffers waiting for oldest_send_time() + ack_timeout to pass
+    std::vector<Parked> ack_parked_;
 
     std::string glog_priority_group_;
     static std::atomic<int> count_;
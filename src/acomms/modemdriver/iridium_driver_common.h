@@ -41,6 +41,10 @@ enum
     RATE_SBD = 0
 };
 
+// sent instead of "goby" at the start of a RUDICS call to request RudicsEncoding::BLOCK, and
+// returned by a remote that accepts it
+constexpr const char* rudics_block_encoding_hello = "goby-block";
+
 class OnCallBase
 {
   public:
@@ -331,6 +331,15 @@ void goby::acomms::iridium::fsm::OnCall::in_state_react(const EvRxOnCallSerial&
         glog.is(DEBUG1) && glog << group("iridiumdriver") << "Detected start of Goby RUDICS call"
                                 << std::endl;
     }
+    else if (boost::trim_copy(in) == rudics_block_encoding_hello)
+    {
+        glog.is(DEBUG1) && glog << group("iridiumdriver")
+                                << "Detected start of Goby RUDICS call with block encoding"
+                                << std::endl;
+        if (context<IridiumDriverFSM>().iridium_driver_cfg().rudics_encoding() ==
+            protobuf::Config::RUDICS_BLOCK)
+            encoding_ = RudicsEncoding::BLOCK;
+    }
     else if (boost::trim_copy(in) == "bye")
     {
         glog.is(DEBUG1) && glog << group("iridiumdriver")
@@ -342,7 +351,7 @@ void goby::acomms::iridium::fsm::OnCall::in_state_react(const EvRxOnCallSerial&
         std::string bytes;
         try
         {
-            parse_rudics_packet(&bytes, in);
+            parse_rudics_packet_any_encoding(&bytes, in, encoding_);
 
             goby::acomms::protobuf::ModemTransmission msg;
             parse_iridium_modem_message(bytes, &msg);
@@ -376,7 +385,7 @@ void goby::acomms::iridium::fsm::OnCall::in_state_react(const EvTxOnCallSerial&)
 
         // frame message
         std::string rudics_packet;
-        serialize_rudics_packet(bytes, &rudics_packet);
+        serialize_rudics_packet(bytes, &rudics_packet, iridium_reserved_chars(), true, encoding_);
 
         context<IridiumDriverFSM>().serial_tx_buffer().push_back(rudics_packet);
         data_out.pop_front();
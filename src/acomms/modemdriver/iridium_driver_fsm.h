@@ -50,6 +50,7 @@
 #include <boost/statechart/transition.hpp>        // for transition
 
 #include "goby/acomms/modemdriver/iridium_driver_common.h" // for OnCallBase
+#include "goby/acomms/modemdriver/rudics_packet.h"         // for RudicsEncoding
 #include "goby/acomms/protobuf/driver_base.pb.h"           // for DriverConfig
 #include "goby/acomms/protobuf/iridium_driver.pb.h"        // for Config
 #include "goby/acomms/protobuf/modem_message.pb.h"         // for ModemTran...
@@ -461,7 +462,12 @@ struct OnCall : boost::statechart::state<OnCall, Active::orthogonal<1> >, StateN
         // add a brief identifier that is *different* than the "~" which is what PPP uses
         // add a carriage return to clear out any garbage
         // at the *beginning* of transmission
-        context<IridiumDriverFSM>().serial_tx_buffer().push_front("goby\r");
+        if (context<IridiumDriverFSM>().iridium_driver_cfg().rudics_encoding() ==
+            protobuf::Config::RUDICS_BLOCK)
+            context<IridiumDriverFSM>().serial_tx_buffer().push_front(
+                std::string(rudics_block_encoding_hello) + "\r");
+        else
+            context<IridiumDriverFSM>().serial_tx_buffer().push_front("goby\r");
 
         // connecting necessarily puts the DTE online
         post_event(EvOnline());
@@ -486,6 +492,8 @@ struct OnCall : boost::statechart::state<OnCall, Active::orthogonal<1> >, StateN
         boost::statechart::in_state_reaction<EvSendBye, OnCall, &OnCall::in_state_react>>;
 
   private:
+    // BLOCK once both sides have requested it
+    RudicsEncoding encoding_{RudicsEncoding::BASE_CONVERT};
 };
 
 struct SBD : boost::statechart::simple_state<SBD, Command::orthogonal<1>, SBDReady>, StateNotify
@@ -225,8 +225,14 @@ void goby::acomms::IridiumShoreDriver::send(const protobuf::ModemTransmission& m
         serialize_iridium_modem_message(&bytes, msg);
 
         // frame message
+        using LeftIt = boost::bimap<ModemId, std::shared_ptr<RUDICSConnection>>::left_map::iterator;
+        LeftIt client_it = clients_.left.find(msg.dest());
+        RudicsEncoding encoding = (client_it != clients_.left.end())
+                                      ? client_it->second->encoding()
+                                      : RudicsEncoding::BASE_CONVERT;
+
         std::string rudics_packet;
-        serialize_rudics_packet(bytes, &rudics_packet);
+        serialize_rudics_packet(bytes, &rudics_packet, iridium_reserved_chars(), true, encoding);
         rudics_send(rudics_packet, msg.dest());
         std::shared_ptr<OnCallBase> on_call_base = remote.on_call;
         on_call_base->set_last_tx_time(time::SystemClock::now().time_since_epoch() /
@@ -312,6 +318,21 @@ void goby::acomms::IridiumShoreDriver::rudics_line(
             glog.is(DEBUG1) && glog << "Detected start of Goby RUDICS connection from "
                                     << connection->remote_endpoint_str() << std::endl;
         }
+        else if (data == std::string(rudics_block_encoding_hello) + "\r" ||
+                 data == std::string(1, '\0') + rudics_block_encoding_hello + "\r")
+        {
+            glog.is(DEBUG1) && glog << "Detected start of Goby RUDICS connection from "
+                                    << connection->remote_endpoint_str()
+                                    << " requesting block encoding" << std::endl;
+            if (iridium_shore_driver_cfg().accept_block_rudics_encoding())
+            {
+                // the buffer passed to write_start must outlive the asynchronous write
+                static const std::string block_hello =
+                    std::string(rudics_block_encoding_hello) + "\r";
+                connection->set_encoding(RudicsEncoding::BLOCK);
+                connection->write_start(block_hello);
+            }
+        }
         else if (data == "bye\r")
         {
             using RightIt =
@@ -334,7 +355,7 @@ void goby::acomms::IridiumShoreDriver::rudics_line(
         }
         else
         {
-            parse_rudics_packet(&decoded_line, data);
+            parse_rudics_packet_any_encoding(&decoded_line, data, connection->encoding());
 
             protobuf::ModemTransmission modem_msg;
             parse_iridium_modem_message(decoded_line, &modem_msg);
@@ -30,6 +30,7 @@
 #include <boost/bind.hpp>
 #include <boost/signals2.hpp>
 
+#include "goby/acomms/modemdriver/rudics_packet.h"
 #include "goby/time.h"
 #include "goby/util/binary.h"
 #include "goby/util/debug_logger.h"
@@ -104,6 +105,9 @@ class RUDICSConnection : public std::enable_shared_from_this<RUDICSConnection>
 
     const std::string& remote_endpoint_str() { return remote_endpoint_str_; }
 
+    goby::acomms::RudicsEncoding encoding() const { return encoding_; }
+    void set_encoding(goby::acomms::RudicsEncoding encoding) { encoding_ = encoding; }
+
   private:
     RUDICSConnection(
 #ifdef USE_BOOST_IO_SERVICE
@@ -164,6 +168,7 @@ class RUDICSConnection : public std::enable_shared_from_this<RUDICSConnection>
     boost::asio::streambuf buffer_;
     std::string remote_endpoint_str_;
     int packet_failures_;
+    goby::acomms::RudicsEncoding encoding_{goby::acomms::RudicsEncoding::BASE_CONVERT};
 };
 
 class RUDICSServer
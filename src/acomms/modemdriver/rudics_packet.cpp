@@ -22,8 +22,10 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <algorithm> // for replace, remove_if
-#include <cstring>   // for memcpy
+#include <algorithm> // for replace, remove_if, find, min
+#include <cstdint>   // for uint8_t, uint32_t
+#include <cstring>   // for memcpy, memset
+#include <vector>    // for vector
 
 #include <boost/algorithm/string/classification.hpp> // for is_any_ofF, is_...
 #include <boost/crc.hpp>                             // for crc_32_type
@@ -32,8 +34,126 @@
 #include "goby/util/base_convert.h" // for base_convert
 #include "rudics_packet.h"
 
+namespace
+{
+// number of base digits used to encode r bytes, for r in [0, rudics_block_size]: the smallest m
+// such that base^m >= 256^r
+std::vector<int> block_digits(int base)
+{
+    std::vector<int> digits(goby::acomms::rudics_block_size + 1, 0);
+    // base^m, little-endian base 256
+    std::vector<std::uint32_t> power(1, 1);
+    for (int m = 1, r = 1; r <= goby::acomms::rudics_block_size; ++m)
+    {
+        std::uint32_t carry = 0;
+        for (auto& byte : power)
+        {
+            std::uint32_t v = byte * base + carry;
+            byte = v & 0xFF;
+            carry = v >> 8;
+        }
+        for (; carry; carry >>= 8) power.push_back(carry & 0xFF);
+
+        // any number with r+1 bytes is >= 256^r
+        for (; r <= goby::acomms::rudics_block_size && static_cast<int>(power.size()) >= r + 1;
+             ++r)
+            digits[r] = m;
+    }
+    return digits;
+}
+
+const std::vector<int>& cached_block_digits(int base)
+{
+    static const std::vector<std::vector<int>> all_digits = []() {
+        std::vector<std::vector<int>> all(257);
+        for (int base = 2; base <= 256; ++base) all[base] = block_digits(base);
+        return all;
+    }();
+    if (base < 2 || base > 256)
+        throw(goby::acomms::RudicsPacketException("Invalid number of reserved characters"));
+    return all_digits[base];
+}
+
+// converts each block of rudics_block_size bytes (the last block may be shorter) to a fixed
+// number of base digits, most significant first
+void block_encode(const std::string& bytes, std::string* digits_out, int base)
+{
+    const auto& digits = cached_block_digits(base);
+    digits_out->clear();
+    digits_out->reserve((bytes.size() / goby::acomms::rudics_block_size + 1) *
+                        digits[goby::acomms::rudics_block_size]);
+
+    std::uint8_t block[goby::acomms::rudics_block_size];
+    char out[goby::acomms::rudics_block_size * 8];
+    for (std::string::size_type i = 0, n = bytes.size(); i < n;
+         i += goby::acomms::rudics_block_size)
+    {
+        const int r = std::min<std::string::size_type>(goby::acomms::rudics_block_size, n - i);
+        std::memcpy(block, bytes.data() + i, r);
+
+        // long division of the block by base, skipping leading zero bytes of the quotient
+        int first = 0;
+        for (int d = digits[r] - 1; d >= 0; --d)
+        {
+            std::uint32_t remainder = 0;
+            for (int j = first; j < r; ++j)
+            {
+                std::uint32_t v = (remainder << 8) | block[j];
+                block[j] = v / base;
+                remainder = v % base;
+            }
+            while (first < r && block[first] == 0) ++first;
+            out[d] = static_cast<char>(remainder);
+        }
+        digits_out->append(out, digits[r]);
+    }
+}
+
+void block_decode(const std::string& digits_in, std::string* bytes, int base)
+{
+    const auto& digits = cached_block_digits(base);
+    const int full_block_digits = digits[goby::acomms::rudics_block_size];
+
+    bytes->clear();
+    bytes->reserve((digits_in.size() / full_block_digits + 1) * goby::acomms::rudics_block_size);
+
+    std::uint8_t block[goby::acomms::rudics_block_size];
+    for (std::string::size_type i = 0, n = digits_in.size(); i < n; i += full_block_digits)
+    {
+        const int m = std::min<std::string::size_type>(full_block_digits, n - i);
+        int r = goby::acomms::rudics_block_size;
+        if (m != full_block_digits)
+        {
+            // only the last block may be shorter
+            auto r_it = std::find(digits.begin() + 1, digits.end(), m);
+            if (r_it == digits.end())
+                throw(goby::acomms::RudicsPacketException("Invalid block length"));
+            r = r_it - digits.begin();
+        }
+
+        std::memset(block, 0, r);
+        for (int d = 0; d < m; ++d)
+        {
+            std::uint32_t carry = digits_in[i + d] & 0xFF;
+            if (carry >= static_cast<std::uint32_t>(base))
+                throw(goby::acomms::RudicsPacketException("Invalid digit"));
+            for (int j = r - 1; j >= 0; --j)
+            {
+                std::uint32_t v = block[j] * base + carry;
+                block[j] = v & 0xFF;
+                carry = v >> 8;
+            }
+            if (carry)
+                throw(goby::acomms::RudicsPacketException("Block value out of range"));
+        }
+        bytes->append(reinterpret_cast<const char*>(block), r);
+    }
+}
+} // namespace
+
 void goby::acomms::serialize_rudics_packet(std::string bytes, std::string* rudics_pkt,
-                                           const std::string& reserved, bool include_crc)
+                                           const std::string& reserved, bool include_crc,
+                                           RudicsEncoding encoding)
 {
     if (include_crc)
     {
@@ -46,7 +166,10 @@ void goby::acomms::serialize_rudics_packet(std::string bytes, std::string* rudic
     // 2. convert to base (256 minus reserved)
     const int reduced_base = 256 - reserved.size();
 
-    goby::util::base_convert(bytes, rudics_pkt, 256, reduced_base);
+    if (encoding == RudicsEncoding::BLOCK)
+        block_encode(bytes, rudics_pkt, reduced_base);
+    else
+        goby::util::base_convert(bytes, rudics_pkt, 256, reduced_base);
 
     // 3. replace reserved characters
     for (int i = 0, n = reserved.size(); i < n; ++i)
@@ -60,7 +183,8 @@ void goby::acomms::serialize_rudics_packet(std::string bytes, std::string* rudic
 }
 
 void goby::acomms::parse_rudics_packet(std::string* bytes, std::string rudics_pkt,
-                                       const std::string& reserved, bool include_crc)
+                                       const std::string& reserved, bool include_crc,
+                                       RudicsEncoding encoding)
 {
     const unsigned CR_SIZE = 1;
     if (rudics_pkt.size() < CR_SIZE)
@@ -84,7 +208,10 @@ void goby::acomms::parse_rudics_packet(std::string* bytes, std::string rudics_pk
     }
 
     // 2. convert to base
-    goby::util::base_convert(rudics_pkt, bytes, reduced_base, 256);
+    if (encoding == RudicsEncoding::BLOCK)
+        block_decode(rudics_pkt, bytes, reduced_base);
+    else
+        goby::util::base_convert(rudics_pkt, bytes, reduced_base, 256);
 
     if (include_crc)
     {
@@ -106,6 +233,23 @@ void goby::acomms::parse_rudics_packet(std::string* bytes, std::string rudics_pk
     }
 }
 
+void goby::acomms::parse_rudics_packet_any_encoding(std::string* bytes,
+                                                    const std::string& rudics_pkt,
+                                                    RudicsEncoding encoding)
+{
+    const std::string reserved = iridium_reserved_chars();
+    try
+    {
+        parse_rudics_packet(bytes, rudics_pkt, reserved, true, encoding);
+    }
+    catch (RudicsPacketException& e)
+    {
+        parse_rudics_packet(bytes, rudics_pkt, reserved, true,
+                            encoding == RudicsEncoding::BLOCK ? RudicsEncoding::BASE_CONVERT
+                                                              : RudicsEncoding::BLOCK);
+    }
+}
+
 std::string goby::acomms::uint32_to_byte_string(uint32_t i)
 {
     union u_t {
@@ -39,14 +39,37 @@ class RudicsPacketException : public std::runtime_error
     RudicsPacketException(const std::string& what) : std::runtime_error(what) {}
 };
 
+/// \brief Characters that are not sent in Iridium RUDICS and SBD packets (the default)
+inline std::string iridium_reserved_chars()
+{
+    return std::string("\0\r\n", 3) + std::string(1, 0xff);
+}
+
+/// \brief Conversion of the packet bytes to digits of base (256 - number of reserved characters)
+enum class RudicsEncoding
+{
+    /// the whole packet is converted as one number (quadratic time in the packet size)
+    BASE_CONVERT,
+    /// each block of up to rudics_block_size bytes is converted separately (linear time)
+    BLOCK
+};
+
+/// \brief Number of bytes per block for RudicsEncoding::BLOCK. With up to 20 reserved characters, each full block is encoded as 65 characters.
+constexpr int rudics_block_size = 64;
+
 void serialize_rudics_packet(std::string bytes, std::string* rudics_pkt,
-                             const std::string& reserved = std::string("\0\r\n", 3) +
-                                                           std::string(1, 0xff),
-                             bool include_crc = true);
+                             const std::string& reserved = iridium_reserved_chars(),
+                             bool include_crc = true,
+                             RudicsEncoding encoding = RudicsEncoding::BASE_CONVERT);
 void parse_rudics_packet(std::string* bytes, std::string rudics_pkt,
-                         const std::string& reserved = std::string("\0\r\n", 3) +
-                                                       std::string(1, 0xff),
-                         bool include_crc = true);
+                         const std::string& reserved = iridium_reserved_chars(),
+                         bool include_crc = true,
+                         RudicsEncoding encoding = RudicsEncoding::BASE_CONVERT);
+
+/// \brief Parse a packet using the given encoding, falling back to the other encoding if the CRC does not match (e.g. for a packet sent before the encoding was negotiated)
+void parse_rudics_packet_any_encoding(std::string* bytes, const std::string& rudics_pkt,
+                                      RudicsEncoding encoding);
+
 std::string uint32_to_byte_string(uint32_t i);
 uint32_t byte_string_to_uint32(const std::string& s);
 } // namespace acomms
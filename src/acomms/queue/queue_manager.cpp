@@ -25,6 +25,7 @@
 
 #include <cassert> // for assert
 #include <cstdint> // for int32_t
+#include <exception> // for exception_ptr
 #include <memory>   // for shared...
 #include <ostream>  // for operat...
 #include <vector>   // for vector
@@ -258,6 +259,12 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
         {
             std::list<QueuedMessage> dccl_msgs;
 
+            // each message is encoded once when it is added to the frame: the encoded size is used
+            // to pack the frame and the encoded bytes are reused for the final frame
+            std::string encoded_msgs;
+            unsigned repeated_size_bytes = 0;
+            std::exception_ptr encode_exception;
+
             // set true if we are passing on encrypted data untouched
             bool using_encrypted_body = false;
             std::string passthrough_message;
@@ -357,7 +364,23 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
                 }
                 else
                 {
-                    unsigned repeated_size_bytes = size_repeated(dccl_msgs);
+                    if (!encode_exception)
+                    {
+                        try
+                        {
+                            std::string piece = encode_one(dccl_msgs.back());
+                            encoded_msgs += piece;
+                            repeated_size_bytes += piece.size();
+                        }
+                        catch (DCCLException&)
+                        {
+                            // report when the frame is assembled, as for any other encoding failure
+                            encode_exception = std::current_exception();
+                        }
+                    }
+
+                    if (encode_exception)
+                        repeated_size_bytes += codec_->size(*dccl_msgs.back().dccl_msg);
 
                     glog.is(DEBUG2) && glog << group(glog_out_group_) << "Size repeated "
                                             << repeated_size_bytes << std::endl;
@@ -379,6 +402,9 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
             // finally actually encode the message
             try
             {
+                if (encode_exception)
+                    std::rethrow_exception(encode_exception);
+
                 if (using_encrypted_body)
                 {
                     glog.is(DEBUG2) &&
@@ -386,15 +412,8 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
                              << "Encoding head only, passing through (encrypted?) body."
                              << std::endl;
 
-                    *data = data->substr(0, original_data_size);
-                    // encode all the messages but the last (these must be unencrypted)
-                    if (dccl_msgs.size() > 1)
-                    {
-                        auto it_back = dccl_msgs.end();
-                        --it_back;
-                        *data +=
-                            encode_repeated(std::list<QueuedMessage>(dccl_msgs.begin(), it_back));
-                    }
+                    // all the messages but the last (these must be unencrypted) are already encoded
+                    *data = data->substr(0, original_data_size) + encoded_msgs;
 
                     std::string head;
                     codec_->encode(&head, *dccl_msgs.back().dccl_msg, true);
@@ -402,7 +421,7 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
                 }
                 else
                 {
-                    *data = data->substr(0, original_data_size) + encode_repeated(dccl_msgs);
+                    *data = data->substr(0, original_data_size) + encoded_msgs;
                 }
             }
             catch (DCCLException& e)
@@ -418,30 +437,24 @@ void goby::acomms::QueueManager::handle_modem_data_request(protobuf::ModemTransm
     msg->set_ack_requested(packet_ack_);
 }
 
-std::string goby::acomms::QueueManager::encode_repeated(const std::list<QueuedMessage>& msgs)
+std::string goby::acomms::QueueManager::encode_one(const QueuedMessage& msg)
 {
-    std::string out;
-    for (const QueuedMessage& msg : msgs)
+    if (encrypt_rules_.size())
     {
-        if (encrypt_rules_.size())
-        {
-            protobuf::DCCLConfig cfg;
-            std::map<ModemId, std::string>::const_iterator it =
-                encrypt_rules_.find(msg.meta.dest());
-
-            if (it != encrypt_rules_.end())
-            {
-                cfg.set_crypto_passphrase(it->second);
-            }
+        protobuf::DCCLConfig cfg;
+        std::map<ModemId, std::string>::const_iterator it = encrypt_rules_.find(msg.meta.dest());
 
-            codec_->merge_cfg(cfg);
+        if (it != encrypt_rules_.end())
+        {
+            cfg.set_crypto_passphrase(it->second);
         }
 
-        std::string piece;
-        codec_->encode(&piece, *(msg.dccl_msg));
-        out += piece;
+        codec_->merge_cfg(cfg);
     }
-    return out;
+
+    std::string piece;
+    codec_->encode(&piece, *(msg.dccl_msg));
+    return piece;
 }
 
 std::list<goby::acomms::QueuedMessage>
@@ -503,13 +516,6 @@ goby::acomms::QueueManager::decode_repeated(const std::string& orig_bytes)
     return out;
 }
 
-unsigned goby::acomms::QueueManager::size_repeated(const std::list<QueuedMessage>& msgs)
-{
-    unsigned out = 0;
-    for (const QueuedMessage& msg : msgs) out += codec_->size(*(msg.dccl_msg));
-    return out;
-}
-
 void goby::acomms::QueueManager::clear_packet(const protobuf::ModemTransmission& message)
 {
     for (auto it = waiting_for_ack_.begin(), end = waiting_for_ack_.end(); it != end;)
@@ -253,9 +253,8 @@ class QueueManager
                             goby::acomms::protobuf::NetworkAck::AckType ack_type);
 
     // "overload" those from DCCLCodec to allow changing of crypto passphrase
-    std::string encode_repeated(const std::list<QueuedMessage>& msgs);
+    std::string encode_one(const QueuedMessage& msg);
     std::list<QueuedMessage> decode_repeated(const std::string& orig_bytes);
-    unsigned size_repeated(const std::list<QueuedMessage>& msgs);
 
   private:
     friend class Queue;
@@ -48,7 +48,7 @@ namespace hdf5
 class WriterApp : public goby::middleware::Application<goby::middleware::protobuf::HDF5Config>
 {
   public:
-    WriterApp() : writer_(app_cfg().output_file())
+    WriterApp() : writer_(app_cfg().output_file(), true, app_cfg().writer())
     {
         load();
         collect();
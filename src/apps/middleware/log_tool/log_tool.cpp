@@ -22,12 +22,18 @@
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>                       // for max
+#include <condition_variable>              // for condition_variable
+#include <cstdint>                         // for uint64_t
 #include <dccl/dynamic_protobuf_manager.h> // for Dynami...
+#include <deque>                           // for deque
 #include <dlfcn.h>                         // for dlclose
 #include <map>                             // for map
 #include <memory>                          // for unique...
+#include <mutex>                           // for mutex
 #include <ostream>                         // for operat...
+#include <sstream>                         // for stringstream
 #include <string>                          // for operat...
+#include <thread>                          // for thread
 #include <utility>                         // for pair
 #include <vector>                          // for vector
 
@@ -39,6 +45,7 @@
 #include "goby/middleware/log/dccl_log_plugin.h"              // for DCCLPl...
 #include "goby/middleware/log/json_log_plugin.h"
 #include "goby/middleware/log/log_entry.h"               // for LogEntry
+#include "goby/middleware/log/log_index.h"               // for LogIndex
 #include "goby/middleware/log/log_plugin.h"              // for LogPlugin
 #include "goby/middleware/marshalling/interface.h"       // for Marsha...
 #include "goby/middleware/protobuf/log_tool_config.pb.h" // for LogToo...
@@ -98,6 +105,24 @@ class LogTool : public goby::middleware::Application<protobuf::LogToolConfig>
         }
     }
 
+    struct ConvertedEntry
+    {
+        // DEBUG_TEXT or JSON output
+        std::string text;
+        std::vector<goby::middleware::HDF5ProtobufEntry> h5_entries;
+    };
+
+    // returns false at the end of the log (or of the time window)
+    bool read_entry(goby::middleware::log::LogEntry& log_entry);
+    void convert(goby::middleware::log::LogEntry& log_entry, ConvertedEntry& converted);
+    void write(ConvertedEntry& converted);
+
+    // reads on this thread, converts on num_threads threads and writes (in log order) on another
+    void run_pipeline(int num_threads);
+    void run_converter();
+    void run_writer();
+    void wait_for_pipeline_idle();
+
     // never gets called
     void run() override {}
 
@@ -108,7 +133,8 @@ class LogTool : public goby::middleware::Application<protobuf::LogToolConfig>
     // scheme to plugin
     std::map<int, std::unique_ptr<goby::middleware::log::LogPlugin>> plugins_;
 
-    std::ifstream f_in_;
+    goby::middleware::log::LogInputFile log_file_;
+    std::istream& f_in_;
     std::string output_file_path_;
 
     std::ofstream f_out_;
@@ -116,6 +142,21 @@ class LogTool : public goby::middleware::Application<protobuf::LogToolConfig>
 #ifdef HAS_HDF5
     std::unique_ptr<goby::middleware::hdf5::Writer> h5_writer_;
 #endif
+
+    goby::time::SystemClock::time_point start_time_, end_time_;
+
+    // entries read but not yet written, per converter thread
+    static constexpr std::uint64_t pipeline_depth_per_thread_{64};
+    std::mutex pipeline_mutex_;
+    std::condition_variable to_convert_cv_;
+    std::condition_variable converted_cv_;
+    std::condition_variable written_cv_;
+    std::deque<std::pair<std::uint64_t, std::unique_ptr<goby::middleware::log::LogEntry>>>
+        to_convert_;
+    std::map<std::uint64_t, ConvertedEntry> converted_;
+    std::uint64_t read_seq_{0};
+    std::uint64_t written_seq_{0};
+    bool read_done_{false};
 };
 } // namespace middleware
 } // namespace apps
@@ -124,7 +165,9 @@ class LogTool : public goby::middleware::Application<protobuf::LogToolConfig>
 int main(int argc, char* argv[]) { return goby::run<goby::apps::middleware::LogTool>(argc, argv); }
 
 goby::apps::middleware::LogTool::LogTool()
-    : f_in_(app_cfg().input_file().c_str()), output_file_path_(create_output_filename())
+    : log_file_(app_cfg().input_file()),
+      f_in_(log_file_.stream()),
+      output_file_path_(create_output_filename())
 {
     switch (app_cfg().format())
     {
@@ -133,7 +176,7 @@ goby::apps::middleware::LogTool::LogTool()
 #ifdef HAS_HDF5
         case protobuf::LogToolConfig::HDF5:
             h5_writer_ = std::make_unique<goby::middleware::hdf5::Writer>(
-                output_file_path_, app_cfg().write_hdf5_zero_length_dim());
+                output_file_path_, app_cfg().write_hdf5_zero_length_dim(), app_cfg().hdf5());
             break;
 #endif
         default:
@@ -160,105 +203,277 @@ goby::apps::middleware::LogTool::LogTool()
     plugins_[goby::middleware::MarshallingScheme::JSON] =
         std::make_unique<goby::middleware::log::JSONPlugin>();
 
-    for (auto& p : plugins_) p.second->register_read_hooks(f_in_);
+    for (auto& p : plugins_)
+    {
+        if (log_file_.mapped())
+            p.second->register_read_hooks(f_in_);
+        else
+            p.second->register_read_hooks(log_file_.ifstream());
+    }
+
+    auto seconds_to_time_point = [](double seconds) {
+        return goby::time::convert<goby::time::SystemClock::time_point>(
+            seconds * boost::units::si::seconds);
+    };
 
+    if (app_cfg().has_start_time())
+    {
+        start_time_ = seconds_to_time_point(app_cfg().start_time());
+        // without a mapping, earlier entries are read and skipped instead
+        if (log_file_.mapped())
+        {
+            goby::middleware::log::LogIndex index;
+            index.load_or_build(*log_file_.mapped());
+            index.seek(f_in_, start_time_);
+        }
+    }
+    if (app_cfg().has_end_time())
+        end_time_ = seconds_to_time_point(app_cfg().end_time());
+
+    int num_threads = app_cfg().num_threads();
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (num_threads > 1)
+    {
+        run_pipeline(num_threads);
+    }
+    else
+    {
+        goby::middleware::log::LogEntry log_entry;
+        while (read_entry(log_entry))
+        {
+            ConvertedEntry converted;
+            convert(log_entry, converted);
+            write(converted);
+        }
+    }
+
+    quit();
+}
+
+bool goby::apps::middleware::LogTool::read_entry(goby::middleware::log::LogEntry& log_entry)
+{
     while (true)
     {
         try
         {
-            goby::middleware::log::LogEntry log_entry;
             log_entry.parse(&f_in_);
-            try
-            {
-                auto plugin = plugins_.find(log_entry.scheme());
-                if (plugin == plugins_.end())
-                    throw(goby::middleware::log::LogException("No plugin available for scheme: " +
-                                                              std::to_string(log_entry.scheme())));
-
-                switch (app_cfg().format())
-                {
-                    case protobuf::LogToolConfig::DEBUG_TEXT:
-                    {
-                        auto debug_text_msg = plugin->second->debug_text_message(log_entry);
-                        f_out_ << log_entry.scheme() << " | " << log_entry.group() << " | "
-                               << log_entry.type() << " | "
-                               << goby::time::convert<boost::posix_time::ptime>(
-                                      log_entry.timestamp())
-                               << " | " << debug_text_msg << std::endl;
-                        break;
-                    }
-                    case protobuf::LogToolConfig::HDF5:
-                    {
-#ifdef HAS_HDF5
-                        auto h5_entries = plugin->second->hdf5_entry(log_entry);
-                        for (const auto& entry : h5_entries) h5_writer_->add_entry(entry);
-#endif
-                        break;
-                    }
-                    case protobuf::LogToolConfig::JSON:
-                    {
-                        std::shared_ptr<nlohmann::json> j = plugin->second->json_message(log_entry);
-                        (*j)["_scheme_"] = log_entry.scheme();
-                        (*j)["_utime_"] =
-                            goby::time::convert<goby::time::MicroTime>(log_entry.timestamp())
-                                .value();
-                        (*j)["_strtime_"] = goby::time::str(log_entry.timestamp());
-                        (*j)["_group_"] = log_entry.group();
-                        (*j)["_type_"] = log_entry.type();
-                        f_out_ << j->dump() << std::endl;
-                        break;
-                    }
-                }
-            }
-
-            catch (goby::middleware::log::LogException& e)
-            {
-                glog.is_warn() && glog << "Failed to parse message (scheme: " << log_entry.scheme()
-                                       << ", group: " << log_entry.group()
-                                       << ", type: " << log_entry.type() << std::endl;
-
-                switch (app_cfg().format())
-                {
-                    case protobuf::LogToolConfig::DEBUG_TEXT:
-                        f_out_ << log_entry.scheme() << " | " << log_entry.group() << " | "
-                               << log_entry.type() << " | "
-                               << goby::time::convert<boost::posix_time::ptime>(
-                                      log_entry.timestamp())
-                               << " | "
-                               << "Unable to parse message of " << log_entry.data().size()
-                               << " bytes. Reason: " << e.what() << std::endl;
-                        break;
-                    case protobuf::LogToolConfig::HDF5:
-                        // nothing useful to write to the HDF5 file
-                        break;
-
-                    case protobuf::LogToolConfig::JSON:
-                        auto j = std::make_shared<nlohmann::json>();
-                        (*j)["_scheme_"] = log_entry.scheme();
-                        (*j)["_utime_"] =
-                            goby::time::convert<goby::time::MicroTime>(log_entry.timestamp())
-                                .value();
-                        (*j)["_strtime_"] = goby::time::str(log_entry.timestamp());
-                        (*j)["_group_"] = log_entry.group();
-                        (*j)["_type_"] = log_entry.type();
-                        (*j)["_error_"] = "Could not parse message";
-                        break;
-                }
-            }
         }
         catch (goby::middleware::log::LogException& e)
         {
             glog.is_warn() && glog << "Exception processing input log (will attempt to continue): "
                                    << e.what() << std::endl;
+            continue;
         }
         catch (std::exception& e)
         {
             if (!f_in_.eof())
                 glog.is_warn() && glog << "Error processing input log: " << e.what() << std::endl;
+            return false;
+        }
 
-            break;
+        if (app_cfg().has_start_time() && log_entry.timestamp() < start_time_)
+            continue;
+        if (app_cfg().has_end_time() && log_entry.timestamp() > end_time_)
+            return false;
+
+        return true;
+    }
+}
+
+void goby::apps::middleware::LogTool::convert(goby::middleware::log::LogEntry& log_entry,
+                                              ConvertedEntry& converted)
+{
+    try
+    {
+        auto plugin = plugins_.find(log_entry.scheme());
+        if (plugin == plugins_.end())
+            throw(goby::middleware::log::LogException("No plugin available for scheme: " +
+                                                      std::to_string(log_entry.scheme())));
+
+        switch (app_cfg().format())
+        {
+            case protobuf::LogToolConfig::DEBUG_TEXT:
+            {
+                auto debug_text_msg = plugin->second->debug_text_message(log_entry);
+                std::stringstream ss;
+                ss << log_entry.scheme() << " | " << log_entry.group() << " | "
+                   << log_entry.type() << " | "
+                   << goby::time::convert<boost::posix_time::ptime>(log_entry.timestamp())
+                   << " | " << debug_text_msg << "\n";
+                converted.text = ss.str();
+                break;
+            }
+            case protobuf::LogToolConfig::HDF5:
+            {
+#ifdef HAS_HDF5
+                converted.h5_entries = plugin->second->hdf5_entry(log_entry);
+#endif
+                break;
+            }
+            case protobuf::LogToolConfig::JSON:
+            {
+                std::shared_ptr<nlohmann::json> j = plugin->second->json_message(log_entry);
+                (*j)["_scheme_"] = log_entry.scheme();
+                (*j)["_utime_"] =
+                    goby::time::convert<goby::time::MicroTime>(log_entry.timestamp()).value();
+                (*j)["_strtime_"] = goby::time::str(log_entry.timestamp());
+                (*j)["_group_"] = log_entry.group();
+                (*j)["_type_"] = log_entry.type();
+                converted.text = j->dump() + "\n";
+                break;
+            }
         }
     }
+    catch (std::exception& e)
+    {
+        // LogException from the plugin, or an exception from the underlying parser
+        glog.is_warn() && glog << "Failed to parse message (scheme: " << log_entry.scheme()
+                               << ", group: " << log_entry.group()
+                               << ", type: " << log_entry.type() << std::endl;
 
-    quit();
+        switch (app_cfg().format())
+        {
+            case protobuf::LogToolConfig::DEBUG_TEXT:
+            {
+                std::stringstream ss;
+                ss << log_entry.scheme() << " | " << log_entry.group() << " | "
+                   << log_entry.type() << " | "
+                   << goby::time::convert<boost::posix_time::ptime>(log_entry.timestamp())
+                   << " | "
+                   << "Unable to parse message of " << log_entry.data().size()
+                   << " bytes. Reason: " << e.what() << "\n";
+                converted.text = ss.str();
+                break;
+            }
+            case protobuf::LogToolConfig::HDF5:
+                // nothing useful to write to the HDF5 file
+                break;
+
+            case protobuf::LogToolConfig::JSON:
+                auto j = std::make_shared<nlohmann::json>();
+                (*j)["_scheme_"] = log_entry.scheme();
+                (*j)["_utime_"] =
+                    goby::time::convert<goby::time::MicroTime>(log_entry.timestamp()).value();
+                (*j)["_strtime_"] = goby::time::str(log_entry.timestamp());
+                (*j)["_group_"] = log_entry.group();
+                (*j)["_type_"] = log_entry.type();
+                (*j)["_error_"] = "Could not parse message";
+                break;
+        }
+    }
+}
+
+void goby::apps::middleware::LogTool::write(ConvertedEntry& converted)
+{
+    if (!converted.text.empty())
+        f_out_ << converted.text;
+
+#ifdef HAS_HDF5
+    for (auto& entry : converted.h5_entries) h5_writer_->add_entry(std::move(entry));
+#endif
+}
+
+void goby::apps::middleware::LogTool::run_pipeline(int num_threads)
+{
+    goby::glog.set_lock_action(goby::util::logger_lock::lock);
+
+    glog.is_verbose() && glog << "Converting using " << num_threads << " threads" << std::endl;
+
+    // the Protobuf hooks add file descriptors to the DynamicProtobufManager, which must not happen
+    // while the converter threads may be using it
+    for (auto& hook_p : goby::middleware::log::LogEntry::filter_hook)
+    {
+        auto hook = hook_p.second;
+        hook_p.second = [this, hook](const std::vector<unsigned char>& data) {
+            wait_for_pipeline_idle();
+            hook(data);
+        };
+    }
+
+    const std::uint64_t max_in_flight = pipeline_depth_per_thread_ * num_threads;
+
+    std::vector<std::thread> converters;
+    for (int i = 0; i < num_threads; ++i)
+        converters.emplace_back([this]() { run_converter(); });
+    std::thread writer([this]() { run_writer(); });
+
+    while (true)
+    {
+        auto log_entry = std::make_unique<goby::middleware::log::LogEntry>();
+        if (!read_entry(*log_entry))
+            break;
+
+        std::unique_lock<std::mutex> lock(pipeline_mutex_);
+        written_cv_.wait(lock, [&]() { return read_seq_ - written_seq_ < max_in_flight; });
+        to_convert_.emplace_back(read_seq_++, std::move(log_entry));
+        to_convert_cv_.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pipeline_mutex_);
+        read_done_ = true;
+    }
+    to_convert_cv_.notify_all();
+    converted_cv_.notify_all();
+
+    for (auto& converter : converters) converter.join();
+    writer.join();
+}
+
+void goby::apps::middleware::LogTool::run_converter()
+{
+    std::unique_lock<std::mutex> lock(pipeline_mutex_);
+    while (true)
+    {
+        to_convert_cv_.wait(lock, [this]() { return !to_convert_.empty() || read_done_; });
+        if (to_convert_.empty())
+            return;
+
+        auto seq = to_convert_.front().first;
+        auto log_entry = std::move(to_convert_.front().second);
+        to_convert_.pop_front();
+        lock.unlock();
+
+        ConvertedEntry converted;
+        convert(*log_entry, converted);
+        log_entry.reset();
+
+        lock.lock();
+        converted_.insert(std::make_pair(seq, std::move(converted)));
+        if (seq == written_seq_)
+            converted_cv_.notify_one();
+    }
+}
+
+void goby::apps::middleware::LogTool::run_writer()
+{
+    std::unique_lock<std::mutex> lock(pipeline_mutex_);
+    while (true)
+    {
+        converted_cv_.wait(lock, [this]() {
+            return converted_.count(written_seq_) || (read_done_ && written_seq_ == read_seq_);
+        });
+
+        auto it = converted_.find(written_seq_);
+        if (it == converted_.end())
+            return;
+
+        ConvertedEntry converted(std::move(it->second));
+        converted_.erase(it);
+        lock.unlock();
+
+        write(converted);
+
+        lock.lock();
+        ++written_seq_;
+        written_cv_.notify_all();
+    }
+}
+
+void goby::apps::middleware::LogTool::wait_for_pipeline_idle()
+{
+    std::unique_lock<std::mutex> lock(pipeline_mutex_);
+    written_cv_.wait(lock, [this]() { return written_seq_ == read_seq_; });
 }
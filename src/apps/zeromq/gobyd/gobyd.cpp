@@ -48,6 +48,7 @@
 #include "goby/middleware/terminate/terminate.h"      // for check_...
 #include "goby/middleware/transport/interthread.h"    // for InterT...
 #include "goby/middleware/transport/intervehicle.h"   // for InterV...
+#include "goby/time/steady_clock.h"                   // for SteadyClock
 #include "goby/util/debug_logger.h"
 #include "goby/zeromq/protobuf/gobyd_config.pb.h"        // for GobyDa...
 #include "goby/zeromq/protobuf/interprocess_config.pb.h" // for InterP...
@@ -72,6 +73,7 @@ class Daemon : public goby::middleware::Application<protobuf::GobyDaemonConfig>
 
   private:
     void run() override;
+    void publish_router_status();
 
     goby::zeromq::Manager make_manager()
     {
@@ -92,6 +94,8 @@ class Daemon : public goby::middleware::Application<protobuf::GobyDaemonConfig>
     goby::middleware::InterThreadTransporter interthread_;
     goby::zeromq::InterProcessPortal<goby::middleware::InterThreadTransporter> interprocess_;
     std::unique_ptr<goby::middleware::InterVehiclePortal<decltype(interprocess_)>> intervehicle_;
+
+    goby::time::SteadyClock::time_point next_router_status_time_{goby::time::SteadyClock::now()};
 };
 
 class DaemonConfigurator : public goby::middleware::ProtobufConfigurator<protobuf::GobyDaemonConfig>
@@ -178,9 +182,14 @@ goby::apps::zeromq::Daemon::~Daemon()
 
 void goby::apps::zeromq::Daemon::run()
 {
+    // wake up for the next RouterStatus, if enabled
+    auto timeout = app_cfg().router_status_period() > 0
+                       ? next_router_status_time_
+                       : goby::time::SteadyClock::time_point::max();
+
     if (intervehicle_)
     {
-        intervehicle_->poll();
+        intervehicle_->poll(timeout);
 
         //        intervehicle_->poll(std::chrono::milliseconds(100) / time::SimulatorSettings::warp_factor);
         //        goby::middleware::intervehicle::protobuf::Status status;
@@ -189,6 +198,23 @@ void goby::apps::zeromq::Daemon::run()
     }
     else
     {
-        interprocess_.poll();
+        interprocess_.poll(timeout);
     }
+
+    if (app_cfg().router_status_period() > 0 && goby::time::SteadyClock::now() >= timeout)
+        publish_router_status();
+}
+
+void goby::apps::zeromq::Daemon::publish_router_status()
+{
+    auto status = router_.status();
+    glog.is(DEBUG1) && glog << "Router status: " << status.ShortDebugString() << std::endl;
+    interprocess_.publish<goby::zeromq::groups::router_status>(status);
+
+    next_router_status_time_ +=
+        std::chrono::duration_cast<goby::time::SteadyClock::duration>(
+            std::chrono::duration<double>(app_cfg().router_status_period()));
+    // don't try to catch up if we fell behind
+    if (next_router_status_time_ < goby::time::SteadyClock::now())
+        next_router_status_time_ = goby::time::SteadyClock::now();
 }
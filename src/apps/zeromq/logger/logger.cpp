@@ -22,20 +22,23 @@
 // You should have received a copy of the GNU General Public License
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <algorithm>     // for copy, max
-#include <atomic>        // for atomic
-#include <chrono>        // for time_p...
-#include <csignal>       // for sigaction
-#include <dlfcn.h>       // for dlclose
-#include <fcntl.h>       // for S_IRGRP
-#include <fstream>       // for operat...
-#include <functional>    // for _Bind
-#include <map>           // for operat...
-#include <string>        // for allocator
-#include <sys/stat.h>    // for chmod
-#include <thread>        // for thread
-#include <unordered_map> // for operat...
-#include <vector>        // for vector
+#include <algorithm>          // for copy, max
+#include <atomic>             // for atomic
+#include <chrono>             // for time_p...
+#include <condition_variable> // for condit...
+#include <csignal>            // for sigaction
+#include <dlfcn.h>            // for dlclose
+#include <fcntl.h>            // for S_IRGRP
+#include <fstream>            // for operat...
+#include <functional>         // for _Bind
+#include <map>                // for operat...
+#include <mutex>              // for mutex
+#include <string>             // for allocator
+#include <sys/stat.h>         // for chmod
+#include <thread>             // for thread
+#include <unistd.h>           // for fdatasync
+#include <unordered_map>      // for operat...
+#include <vector>             // for vector
 
 #include <boost/units/quantity.hpp>             // for operator*
 #include <boost/units/systems/si/frequency.hpp> // for frequency
@@ -51,6 +54,7 @@
 #include "goby/middleware/log/protobuf_log_plugin.h" // for Protob...
 #include "goby/middleware/marshalling/interface.h"   // for Marsha...
 #include "goby/middleware/protobuf/logger.pb.h"
+#include "goby/middleware/transport/detail/bounded_mpsc_queue.h" // for Bounde...
 #include "goby/time/convert.h"                           // for file_str
 #include "goby/util/debug_logger/flex_ostream.h"         // for operat...
 #include "goby/zeromq/application/single_thread.h"       // for Single...
@@ -68,16 +72,301 @@ namespace apps
 {
 namespace zeromq
 {
+/// Writes LogEntry objects to the .goby file from a dedicated thread so that the InterProcessPortal thread never waits on disk I/O
+///
+/// All access to the log file and the (static) LogEntry indexing and plugin hooks happens on the writer thread once it is started.
+class LogWriter
+{
+  public:
+    LogWriter(const protobuf::LoggerConfig& cfg)
+        : cfg_(cfg),
+          log_file_base_(std::string(cfg.log_dir() + "/" + cfg.interprocess().platform() + "_")),
+          queue_(cfg.write_queue_size()),
+          buffer_((cfg.write_buffer_size() + block_size_ - 1) / block_size_ * block_size_)
+    {
+        // open synchronously so that a bad log_dir is reported at startup
+        open_log();
+        writer_thread_ = std::thread([this]() { run(); });
+    }
+
+    ~LogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            stop_ = true;
+        }
+        writer_cv_.notify_one();
+        writer_thread_.join();
+        close_log();
+    }
+
+    /// Queue an entry to be written (call only from a single thread)
+    void write(std::unique_ptr<goby::middleware::log::LogEntry> entry)
+    {
+        Item item;
+        item.entry = std::move(entry);
+        push(std::move(item));
+    }
+
+    /// Close the current log and open a new one, after all the previously queued entries are written
+    void rotate()
+    {
+        Item item;
+        item.action = Item::Action::ROTATE;
+        push(std::move(item), true);
+    }
+
+    /// Fill in the writer statistics, resetting the latency statistics for the next period
+    void status(goby::middleware::protobuf::LoggerStatus* status)
+    {
+        status->set_queue_depth(enqueued_ - dequeued_);
+        status->set_queue_capacity(queue_.capacity());
+        status->set_written_entries(written_entries_);
+        status->set_written_bytes(written_bytes_);
+        status->set_dropped_entries(queue_.overflow_count());
+
+        std::uint64_t batches = batches_.exchange(0);
+        std::uint64_t total_latency = total_latency_us_.exchange(0);
+        status->set_max_write_latency_us(max_latency_us_.exchange(0));
+        status->set_mean_write_latency_us(batches > 0 ? total_latency / batches : 0);
+    }
+
+  private:
+    struct Item
+    {
+        enum class Action
+        {
+            WRITE,
+            ROTATE
+        };
+        Action action{Action::WRITE};
+        std::unique_ptr<goby::middleware::log::LogEntry> entry;
+    };
+
+    void push(Item&& item, bool always_block = false)
+    {
+        bool blocked = false;
+        while (!queue_.push(std::move(item)))
+        {
+            if (!always_block && cfg_.queue_full_action() == protobuf::LoggerConfig::DROP)
+            {
+                queue_.increment_overflow();
+                auto dropped = queue_.overflow_count();
+                // only report on powers of two to avoid flooding the glog
+                if ((dropped & (dropped - 1)) == 0)
+                    glog.is_warn() && glog << "Log write queue full (" << queue_.capacity()
+                                           << " entries), dropped " << dropped
+                                           << " entries total" << std::endl;
+                return;
+            }
+
+            if (!blocked)
+            {
+                glog.is_debug1() && glog << "Log write queue full, waiting for writer thread"
+                                         << std::endl;
+                blocked = true;
+            }
+            notify_writer();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        ++enqueued_;
+        notify_writer();
+    }
+
+    void notify_writer()
+    {
+        // writer_sleeping_ is set before the writer's last check of the queue, so either it sees the new item or we see it sleeping
+        if (writer_sleeping_.exchange(false))
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            writer_cv_.notify_one();
+        }
+    }
+
+    void run()
+    {
+        auto next_sync = std::chrono::steady_clock::now() + sync_period();
+        Item item;
+        bool have_item = false;
+        for (;;)
+        {
+            auto batch_start = std::chrono::steady_clock::now();
+            int batch_size = 0;
+            std::size_t batch_bytes = 0;
+            bool rotate = false;
+            // the filebuf only writes to disk when its buffer is full (or flushed), so this batches many entries into each write
+            while (batch_bytes < buffer_.size() && (have_item || queue_.pop(item)))
+            {
+                have_item = false;
+                ++dequeued_;
+                if (item.action == Item::Action::ROTATE)
+                {
+                    rotate = true;
+                    break;
+                }
+                item.entry->serialize(&*log_);
+                batch_bytes += item.entry->data().size();
+                ++batch_size;
+                item.entry.reset();
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (batch_size > 0)
+            {
+                log_->flush();
+                now = std::chrono::steady_clock::now();
+                written_entries_ += batch_size;
+                written_bytes_ += batch_bytes;
+                record_latency(now - batch_start);
+            }
+
+            if (rotate)
+            {
+                close_log();
+                open_log();
+                glog.is_verbose() && glog << "Log rotated" << std::endl;
+                next_sync = now + sync_period();
+            }
+            else if (sync_fd_ >= 0 && now >= next_sync)
+            {
+                fdatasync(sync_fd_);
+                next_sync = now + sync_period();
+            }
+
+            if (batch_size > 0 || rotate)
+                continue;
+
+            // queue is empty: flag that we're going to sleep, then check once more so that a push() racing with us is not missed
+            writer_sleeping_ = true;
+            if (queue_.pop(item))
+            {
+                writer_sleeping_ = false;
+                have_item = true;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(writer_mutex_);
+            if (stop_)
+                break;
+            auto timeout = (sync_fd_ >= 0) ? sync_period() : std::chrono::milliseconds(1000);
+            writer_cv_.wait_for(lock, timeout, [this]() { return !writer_sleeping_ || stop_; });
+            writer_sleeping_ = false;
+        }
+        log_->flush();
+    }
+
+    void record_latency(std::chrono::steady_clock::duration latency)
+    {
+        std::uint32_t latency_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        ++batches_;
+        total_latency_us_ += latency_us;
+        std::uint32_t max = max_latency_us_;
+        while (latency_us > max && !max_latency_us_.compare_exchange_weak(max, latency_us)) {}
+    }
+
+    std::chrono::milliseconds sync_period() const
+    {
+        return std::chrono::milliseconds(cfg_.sync_period_ms());
+    }
+
+    void open_log()
+    {
+        pb_plugin_.reset(new goby::middleware::log::ProtobufPlugin);
+        dccl_plugin_.reset(new goby::middleware::log::DCCLPlugin);
+
+        log_file_path_ = log_file_base_ + goby::time::file_str() + ".goby";
+        log_.reset(new std::ofstream);
+        // must be set before open()
+        log_->rdbuf()->pubsetbuf(&buffer_[0], buffer_.size());
+        log_->open(log_file_path_.c_str(), std::ofstream::binary);
+
+        if (!log_->is_open())
+            glog.is_die() && glog << "Failed to open log in directory: " << cfg_.log_dir()
+                                  << std::endl;
+        else
+            glog.is_verbose() && glog << "Logging to: " << log_file_path_ << std::endl;
+
+        if (cfg_.sync_period_ms() > 0)
+        {
+            sync_fd_ = ::open(log_file_path_.c_str(), O_WRONLY);
+            if (sync_fd_ < 0)
+                glog.is_warn() && glog << "Cannot open log for fdatasync, continuing without"
+                                       << std::endl;
+        }
+
+        pb_plugin_->register_write_hooks(*log_);
+        dccl_plugin_->register_write_hooks(*log_);
+
+        std::string file_symlink = log_file_base_ + "latest.goby";
+        remove(file_symlink.c_str());
+        int result = symlink(realpath(log_file_path_.c_str(), NULL), file_symlink.c_str());
+        if (result != 0)
+            glog.is_warn() &&
+                glog << "Cannot create symlink to latest file. Continuing onwards anyway"
+                     << std::endl;
+    }
+
+    void close_log()
+    {
+        glog.is_verbose() && glog << "Closing log at: " << log_file_path_ << std::endl;
+        log_->close();
+        log_.reset();
+        goby::middleware::log::LogEntry::reset();
+
+        if (sync_fd_ >= 0)
+        {
+            fdatasync(sync_fd_);
+            ::close(sync_fd_);
+            sync_fd_ = -1;
+        }
+
+        pb_plugin_.reset();
+        dccl_plugin_.reset();
+
+        // set read only
+        chmod(log_file_path_.c_str(), S_IRUSR | S_IRGRP);
+    }
+
+  private:
+    static constexpr std::size_t block_size_{4096};
+
+    const protobuf::LoggerConfig& cfg_;
+    std::string log_file_base_;
+    std::string log_file_path_;
+    std::unique_ptr<std::ofstream> log_;
+    int sync_fd_{-1};
+
+    std::unique_ptr<goby::middleware::log::ProtobufPlugin> pb_plugin_;
+    std::unique_ptr<goby::middleware::log::DCCLPlugin> dccl_plugin_;
+
+    goby::middleware::detail::BoundedMPSCQueue<Item> queue_;
+    std::vector<char> buffer_;
+
+    std::thread writer_thread_;
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+    std::atomic<bool> writer_sleeping_{false};
+    bool stop_{false};
+
+    // statistics
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> dequeued_{0};
+    std::atomic<std::uint64_t> written_entries_{0};
+    std::atomic<std::uint64_t> written_bytes_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint64_t> total_latency_us_{0};
+    std::atomic<std::uint32_t> max_latency_us_{0};
+};
+
 class Logger : public goby::zeromq::SingleThreadApplication<protobuf::LoggerConfig>
 {
   public:
     Logger()
         : goby::zeromq::SingleThreadApplication<protobuf::LoggerConfig>(1 *
                                                                         boost::units::si::hertz),
-          log_file_base_(std::string(cfg().log_dir() + "/" + cfg().interprocess().platform() + "_"))
+          writer_(new LogWriter(cfg()))
     {
-        open_log();
-
         logging_ = cfg().log_at_startup();
 
         namespace sp = std::placeholders;
@@ -121,9 +410,7 @@ class Logger : public goby::zeromq::SingleThreadApplication<protobuf::LoggerConf
                         break;
 
                     case goby::middleware::protobuf::LoggerRequest::ROTATE_LOG:
-                        glog.is_verbose() && glog << "Log rotated" << std::endl;
-                        close_log();
-                        open_log();
+                        writer_->rotate();
                         break;
                 }
             });
@@ -131,7 +418,8 @@ class Logger : public goby::zeromq::SingleThreadApplication<protobuf::LoggerConf
 
     ~Logger() override
     {
-        close_log();
+        // write everything queued before unloading libraries that may be needed by the plugins
+        writer_.reset();
 
         for (void* handle : dl_handles_) dlclose(handle);
     }
@@ -139,64 +427,24 @@ class Logger : public goby::zeromq::SingleThreadApplication<protobuf::LoggerConf
     static std::atomic<bool> do_quit;
 
   private:
-    void open_log()
-    {
-        pb_plugin_.reset(new goby::middleware::log::ProtobufPlugin);
-        dccl_plugin_.reset(new goby::middleware::log::DCCLPlugin);
-
-        log_file_path_ = log_file_base_ + goby::time::file_str() + ".goby";
-        log_.reset(new std::ofstream(log_file_path_.c_str(), std::ofstream::binary));
-
-        if (!log_->is_open())
-            glog.is_die() && glog << "Failed to open log in directory: " << cfg().log_dir()
-                                  << std::endl;
-        else
-            glog.is_verbose() && glog << "Logging to: " << log_file_path_ << std::endl;
-
-        pb_plugin_->register_write_hooks(*log_);
-        dccl_plugin_->register_write_hooks(*log_);
-
-        std::string file_symlink = log_file_base_ + "latest.goby";
-        remove(file_symlink.c_str());
-        int result = symlink(realpath(log_file_path_.c_str(), NULL), file_symlink.c_str());
-        if (result != 0)
-            glog.is_warn() &&
-                glog << "Cannot create symlink to latest file. Continuing onwards anyway"
-                     << std::endl;
-    }
-
-    void close_log()
-    {
-        glog.is_verbose() && glog << "Closing log at: " << log_file_path_ << std::endl;
-        log_->close();
-        log_.reset();
-        goby::middleware::log::LogEntry::reset();
-        
-        pb_plugin_.reset();
-        dccl_plugin_.reset();
-
-        // set read only
-        chmod(log_file_path_.c_str(), S_IRUSR | S_IRGRP);
-    }
-
     void log(const std::vector<unsigned char>& data, int scheme, const std::string& type,
              const goby::middleware::Group& group);
     void loop() override
     {
         if (do_quit)
             quit();
+
+        goby::middleware::protobuf::LoggerStatus status;
+        writer_->status(&status);
+        glog.is_debug1() && glog << "Writer status: " << status.ShortDebugString() << std::endl;
+        interprocess().publish<goby::middleware::groups::logger_status>(status);
     }
 
   private:
-    std::string log_file_base_;
-    std::string log_file_path_;
-    std::unique_ptr<std::ofstream> log_;
+    std::unique_ptr<LogWriter> writer_;
 
     std::vector<void*> dl_handles_;
 
-    std::unique_ptr<goby::middleware::log::ProtobufPlugin> pb_plugin_;
-    std::unique_ptr<goby::middleware::log::DCCLPlugin> dccl_plugin_;
-
     bool logging_{true};
 };
 } // namespace zeromq
@@ -246,6 +494,7 @@ void goby::apps::zeromq::Logger::log(const std::vector<unsigned char>& data, int
                              << " bytes to log to [scheme, type, group] = [" << scheme << ", "
                              << type << ", " << group << "]" << std::endl;
 
-    goby::middleware::log::LogEntry entry(data, scheme, type, group);
-    entry.serialize(&*log_);
+    writer_->write(
+        std::unique_ptr<goby::middleware::log::LogEntry>(
+            new goby::middleware::log::LogEntry(data, scheme, type, group)));
 }
@@ -25,6 +25,7 @@
 
 #include "goby/middleware/log/dccl_log_plugin.h" // for DCCLPl...
 #include "goby/middleware/log/log_entry.h"       // for LogEntry
+#include "goby/middleware/log/log_index.h"       // for LogIndex, LogInputFile
 #include "goby/zeromq/application/single_thread.h"
 #include "goby/zeromq/protobuf/interprocess_config.pb.h"
 #include "goby/zeromq/protobuf/logger_config.pb.h"
@@ -44,7 +45,8 @@ class Playback : public goby::zeromq::SingleThreadApplication<protobuf::Playback
     Playback()
         : goby::zeromq::SingleThreadApplication<protobuf::PlaybackConfig>(100 *
                                                                           boost::units::si::hertz),
-          f_in_(cfg().input_file().c_str()),
+          log_file_(cfg().input_file()),
+          f_in_(log_file_.stream()),
           playback_start_(goby::time::SystemClock::now() +
                           goby::time::convert_duration<goby::time::SystemClock::duration>(
                               cfg().playback_start_delay_with_units())),
@@ -67,10 +69,20 @@ class Playback : public goby::zeromq::SingleThreadApplication<protobuf::Playback
         plugins_[goby::middleware::MarshallingScheme::DCCL] =
             std::make_unique<goby::middleware::log::DCCLPlugin>();
 
-        for (auto& p : plugins_) p.second->register_read_hooks(f_in_);
+        for (auto& p : plugins_)
+        {
+            if (log_file_.mapped())
+                p.second->register_read_hooks(f_in_);
+            else
+                p.second->register_read_hooks(log_file_.ifstream());
+        }
 
         read_next_entry();
         log_start_ = next_log_entry_.timestamp();
+
+        if (cfg().start_from() > 0)
+            seek(log_start_ + goby::time::convert_duration<goby::time::SystemClock::duration>(
+                                  cfg().start_from_with_units()));
     }
 
     ~Playback() override
@@ -129,6 +141,30 @@ class Playback : public goby::zeromq::SingleThreadApplication<protobuf::Playback
         }
     }
 
+    void seek(goby::time::SystemClock::time_point start)
+    {
+        // without a mapping, read forward from the current entry instead
+        if (log_file_.mapped())
+        {
+            goby::middleware::log::LogIndex index;
+            index.load_or_build(*log_file_.mapped());
+            index.seek(f_in_, start);
+        }
+
+        do_quit_ = false;
+        do
+        {
+            read_next_entry();
+        } while (!do_quit_ && next_log_entry_.timestamp() < start);
+
+        // play back relative to the new start
+        log_start_ = start;
+
+        glog.is_verbose() && glog << "Starting playback from: "
+                                  << goby::time::convert<boost::posix_time::ptime>(start)
+                                  << std::endl;
+    }
+
     bool is_time_to_publish()
     {
         if (do_quit_)
@@ -177,7 +213,8 @@ class Playback : public goby::zeromq::SingleThreadApplication<protobuf::Playback
     // scheme to plugin
     std::map<int, std::unique_ptr<goby::middleware::log::LogPlugin>> plugins_;
 
-    std::ifstream f_in_;
+    goby::middleware::log::LogInputFile log_file_;
+    std::istream& f_in_;
 
     goby::middleware::log::LogEntry next_log_entry_;
 
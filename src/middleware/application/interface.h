@@ -38,6 +38,7 @@
 #include "goby/middleware/application/configurator.h"
 #include "goby/middleware/marshalling/detail/dccl_serializer_parser.h"
 #include "goby/middleware/protobuf/app_config.pb.h"
+#include "goby/middleware/transport/interthread.h"
 #include "goby/time.h"
 #include "goby/util/debug_logger.h"
 #include "goby/util/geodesy.h"
@@ -249,6 +250,9 @@ template <typename Config> void goby::middleware::Application<Config>::configure
 
     if (app3_base_configuration_->glog_config().show_dccl_log())
         goby::middleware::detail::DCCLSerializerParserHelperBase::setup_dlog();
+
+    if (app3_base_configuration_->glog_config().async())
+        glog.enable_async(app3_base_configuration_->glog_config().async_buffer_size());
 }
 
 template <typename Config>
@@ -311,12 +315,35 @@ int goby::run(const goby::middleware::ConfiguratorInterface<typename App::Config
             goby::time::SimulatorSettings::using_sim_time = true;
             goby::time::SimulatorSettings::warp_factor =
                 App::app3_base_configuration_->simulation().time().warp_factor();
+            goby::time::SimulatorSettings::using_virtual_time =
+                App::app3_base_configuration_->simulation().time().virtual_time();
             if (App::app3_base_configuration_->simulation().time().has_reference_microtime())
                 goby::time::SimulatorSettings::reference_time =
                     std::chrono::system_clock::time_point(std::chrono::microseconds(
                         App::app3_base_configuration_->simulation().time().reference_microtime()));
         }
 
+        // set up interthread mailboxes (before any InterThreadTransporter is constructed)
+        const auto& interthread_cfg = App::app3_base_configuration_->interthread();
+        switch (interthread_cfg.mailbox_backend())
+        {
+            case goby::middleware::protobuf::AppConfig::InterThread::MUTEX_QUEUE:
+                goby::middleware::InterThreadSettings::mailbox_backend =
+                    goby::middleware::InterThreadSettings::MailboxBackend::MUTEX_QUEUE;
+                break;
+            case goby::middleware::protobuf::AppConfig::InterThread::LOCK_FREE_RING:
+                goby::middleware::InterThreadSettings::mailbox_backend =
+                    goby::middleware::InterThreadSettings::MailboxBackend::LOCK_FREE_RING;
+                break;
+        }
+        goby::middleware::InterThreadSettings::ring_capacity = interthread_cfg.ring_capacity();
+
+        // select DCCL codec sharing (before any DCCL encoding or decoding)
+        if (App::app3_base_configuration_->dccl().codec_mode() ==
+            goby::middleware::protobuf::AppConfig::DCCL::THREAD_LOCAL)
+            goby::middleware::detail::DCCLSerializerParserHelperBase::set_codec_mode(
+                goby::middleware::detail::DCCLSerializerParserHelperBase::CodecMode::THREAD_LOCAL);
+
         // instantiate the application (with the configuration already set)
         App app;
         return_value = app.__run();
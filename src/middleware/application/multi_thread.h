@@ -42,6 +42,7 @@
 #include "goby/middleware/transport/interprocess.h"
 #include "goby/middleware/transport/interthread.h"
 #include "goby/middleware/transport/intervehicle.h"
+#include "goby/time/virtual_clock.h"
 
 namespace goby
 {
@@ -427,8 +428,16 @@ void goby::middleware::MultiThreadApplicationBase<Config, Transporter>::_launch_
         thread_manager.name += "/" + std::to_string(index);
     thread_manager.uid = thread_uid_++;
 
+    // hold virtual time until the new thread is polling
+    const bool virtual_time = goby::time::VirtualClock::enabled();
+    if (virtual_time)
+        goby::time::VirtualClock::expect();
+
     // copy configuration
-    auto thread_lambda = [this, type_i, index, cfg, &thread_manager]() {
+    auto thread_lambda = [this, type_i, index, cfg, &thread_manager, virtual_time]() {
+        if (virtual_time)
+            goby::time::VirtualClock::join();
+
         try
         {
             std::shared_ptr<ThreadType> goby_thread(
@@ -24,6 +24,7 @@
 #ifndef GOBY_MIDDLEWARE_APPLICATION_THREAD_H
 #define GOBY_MIDDLEWARE_APPLICATION_THREAD_H
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -39,6 +40,7 @@
 #include "goby/middleware/common.h"
 #include "goby/middleware/group.h"
 #include "goby/time/simulation.h"
+#include "goby/time/steady_clock.h"
 
 namespace goby
 {
@@ -63,6 +65,8 @@ template <typename Config, typename TransporterType> class Thread
 
     boost::units::quantity<boost::units::si::frequency> loop_frequency_;
     std::chrono::steady_clock::time_point loop_time_;
+    // used instead of loop_time_ when time::VirtualClock::enabled()
+    time::SteadyClock::time_point virtual_loop_time_;
     unsigned long long loop_count_{0};
     const Config cfg_;
     int index_;
@@ -163,7 +167,16 @@ template <typename Config, typename TransporterType> class Thread
           uid_(-1)
     {
         if (loop_frequency_hertz() > 0 &&
-            loop_frequency_hertz() != std::numeric_limits<double>::infinity())
+            loop_frequency_hertz() != std::numeric_limits<double>::infinity() &&
+            time::VirtualClock::enabled())
+        {
+            auto ticks_since_epoch =
+                time::SteadyClock::now().time_since_epoch() / virtual_loop_interval();
+            virtual_loop_time_ =
+                time::SteadyClock::time_point((ticks_since_epoch + 1) * virtual_loop_interval());
+        }
+        else if (loop_frequency_hertz() > 0 &&
+                 loop_frequency_hertz() != std::numeric_limits<double>::infinity())
         {
             unsigned long long microsec_interval =
                 1000000.0 / (loop_frequency_hertz() * time::SimulatorSettings::warp_factor);
@@ -187,6 +200,12 @@ template <typename Config, typename TransporterType> class Thread
     }
 
     double loop_frequency_hertz() const { return loop_frequency_ / boost::units::si::hertz; }
+    time::SteadyClock::duration virtual_loop_interval() const
+    {
+        return std::max(time::SteadyClock::duration(1),
+                        time::SteadyClock::duration(static_cast<time::SteadyClock::rep>(
+                            1000000.0 / loop_frequency_hertz())));
+    }
     decltype(loop_frequency_) loop_frequency() const { return loop_frequency_; }
     double loop_max_frequency() const { return std::numeric_limits<double>::infinity(); }
     void run_once();
@@ -276,16 +295,21 @@ void goby::middleware::Thread<Config, TransporterType>::run_once()
     }
     else if (loop_frequency_hertz() > 0)
     {
-        int events = transporter_->poll(loop_time_);
+        const bool virtual_time = time::VirtualClock::enabled();
+        int events = virtual_time ? transporter_->poll(virtual_loop_time_)
+                                  : transporter_->poll(loop_time_);
 
         // timeout
         if (events == 0)
         {
             loop();
             ++loop_count_;
-            loop_time_ += std::chrono::nanoseconds(
-                (unsigned long long)(1000000000ull / (loop_frequency_hertz() *
-                                                      time::SimulatorSettings::warp_factor)));
+            if (virtual_time)
+                virtual_loop_time_ += virtual_loop_interval();
+            else
+                loop_time_ += std::chrono::nanoseconds(
+                    (unsigned long long)(1000000000ull / (loop_frequency_hertz() *
+                                                          time::SimulatorSettings::warp_factor)));
         }
     }
     else
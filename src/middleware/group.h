@@ -25,6 +25,8 @@
 #ifndef GOBY_MIDDLEWARE_GROUP_H
 #define GOBY_MIDDLEWARE_GROUP_H
 
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
@@ -55,6 +57,8 @@ namespace middleware
 /// // For use on all layers (string and numeric)
 /// constexpr goby::middleware::Group example_status{"status", 2};
 /// \endcode
+///
+/// Each Group carries an identifier computed from its string value (a FNV-1a hash, evaluated at compile time for \c constexpr Groups and once on construction for DynamicGroup). Equality and hashing use this identifier and the numeric value, so neither allocates; the strings themselves are only compared when the identifiers match.
 class Group
 {
   public:
@@ -67,7 +71,10 @@ class Group
                                                        1};
 
     /// \brief Construct a group with a (C-style) string and possibly a numeric value (when this Group will be used on intervehicle and outer layers).
-    constexpr Group(const char* c, std::uint32_t i = invalid_numeric_group) : c_(c), i_(i) {}
+    constexpr Group(const char* c, std::uint32_t i = invalid_numeric_group)
+        : c_(c), i_(i), id_(string_id(c))
+    {
+    }
 
     /// \brief Construct a group with only a numeric value
     constexpr Group(std::uint32_t i = invalid_numeric_group) : i_(i) {}
@@ -78,6 +85,24 @@ class Group
     /// \brief Access the group's string value as a C string
     constexpr const char* c_str() const { return c_; }
 
+    /// \brief Identifier for the group's string value (equal strings have equal identifiers, but not necessarily the reverse)
+    constexpr std::uint64_t string_id() const { return id_; }
+
+    /// \brief Compute the string identifier (64-bit FNV-1a) of a C string
+    static constexpr std::uint64_t string_id(const char* c)
+    {
+        std::uint64_t h = 14695981039346656037ull;
+        if (c != nullptr)
+        {
+            for (; *c != '\0'; ++c)
+            {
+                h ^= static_cast<unsigned char>(*c);
+                h *= 1099511628211ull;
+            }
+        }
+        return h;
+    }
+
     /// \brief Access the group's string value as a C++ string
     operator std::string() const
     {
@@ -95,19 +120,27 @@ class Group
     }
 
   protected:
-    void set_c_str(const char* c) { c_ = c; }
+    void set_c_str(const char* c)
+    {
+        c_ = c;
+        id_ = string_id(c);
+    }
 
   private:
     const char* c_{nullptr};
     std::uint32_t i_{invalid_numeric_group};
+    std::uint64_t id_{string_id(nullptr)};
 };
 
 inline bool operator==(const Group& a, const Group& b)
 {
-    if (a.c_str() != nullptr && b.c_str() != nullptr)
-        return (std::string(a.c_str()) == std::string(b.c_str())) && (a.numeric() == b.numeric());
+    if (a.numeric() != b.numeric())
+        return false;
+    else if (a.c_str() != nullptr && b.c_str() != nullptr)
+        return a.c_str() == b.c_str() ||
+               (a.string_id() == b.string_id() && std::strcmp(a.c_str(), b.c_str()) == 0);
     else
-        return a.numeric() == b.numeric();
+        return true;
 }
 
 inline bool operator!=(const Group& a, const Group& b) { return !(a == b); }
@@ -141,7 +174,10 @@ template <> struct hash<goby::middleware::Group>
 {
     size_t operator()(const goby::middleware::Group& group) const noexcept
     {
-        return std::hash<std::string>{}(std::string(group));
+        // string_id() is already well mixed, so just fold in the numeric value
+        std::uint64_t h = group.c_str() != nullptr ? group.string_id() : 0;
+        h ^= static_cast<std::uint64_t>(group.numeric()) * 0x9e3779b97f4a7c15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
     }
 };
 } // namespace std
@@ -24,23 +24,27 @@
 #ifndef GOBY_MIDDLEWARE_IO_DETAIL_IO_INTERFACE_H
 #define GOBY_MIDDLEWARE_IO_DETAIL_IO_INTERFACE_H
 
-#include <chrono>    // for seconds
-#include <exception> // for exception
-#include <memory>    // for shared_ptr
-#include <mutex>     // for mutex, lock_...
-#include <ostream>   // for endl, size_t
-#include <string>    // for string, oper...
-#include <thread>    // for thread
-#include <unistd.h>  // for usleep
-
-#include <boost/asio/write.hpp>        // for async_write
-#include <boost/system/error_code.hpp> // for error_code
+#include <atomic>        // for atomic
+#include <cerrno>        // for errno
+#include <chrono>        // for seconds
+#include <cstring>       // for strerror
+#include <exception>     // for exception
+#include <memory>        // for shared_ptr
+#include <ostream>       // for endl, size_t
+#include <string>        // for string, oper...
+#include <sys/eventfd.h> // for eventfd
+#include <unistd.h>      // for usleep, dup
+
+#include <boost/asio/posix/stream_descriptor.hpp> // for stream_descriptor
+#include <boost/asio/write.hpp>                   // for async_write
+#include <boost/system/error_code.hpp>            // for error_code
 
 #include "goby/exception.h"                           // for Exception
 #include "goby/middleware/application/multi_thread.h" // for SimpleThread
 #include "goby/middleware/common.h"                   // for thread_id
 #include "goby/middleware/io/groups.h"                // for status
 #include "goby/middleware/protobuf/io.pb.h"           // for IOError, IOS...
+#include "goby/middleware/transport/poller_wakeup.h"  // for PollerWakeup
 #include "goby/time/steady_clock.h"                   // for SteadyClock
 #include "goby/util/asio_compat.h"
 #include "goby/util/debug_logger.h" // for glog
@@ -72,6 +76,43 @@ ProtobufEndpoint endpoint_convert(const ASIOEndpoint& asio_ep)
     return pb_ep;
 }
 
+/// \brief PollerWakeup that signals an eventfd, so that a boost::asio::io_context waiting on it returns when data are published to the thread
+class EventFdWakeup : public goby::middleware::PollerWakeup
+{
+  public:
+    EventFdWakeup() : fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (fd_ < 0)
+            throw goby::Exception(std::string("Failed to create eventfd: ") +
+                                  std::strerror(errno));
+    }
+    ~EventFdWakeup() override { ::close(fd_); }
+
+    EventFdWakeup(const EventFdWakeup&) = delete;
+    EventFdWakeup& operator=(const EventFdWakeup&) = delete;
+
+    void notify() override
+    {
+        // only write once until the reader has been woken
+        if (!pending_.exchange(true, std::memory_order_acq_rel))
+            eventfd_write(fd_, 1);
+    }
+
+    /// \brief Called by the woken thread before it polls for the published data
+    void clear()
+    {
+        eventfd_t value;
+        eventfd_read(fd_, &value);
+        pending_.store(false, std::memory_order_release);
+    }
+
+    int fd() const { return fd_; }
+
+  private:
+    const int fd_;
+    std::atomic<bool> pending_{false};
+};
+
 template <const goby::middleware::Group& line_in_group,
           const goby::middleware::Group& line_out_group, PubSubLayer publish_layer,
           PubSubLayer subscribe_layer, typename IOConfig, typename SocketType,
@@ -123,39 +164,31 @@ class IOThread : public ThreadType<IOConfig>,
 
     void initialize() override
     {
-        // thread to handle synchonization between boost::asio and goby condition_variable signaling
-        incoming_mail_notify_thread_.reset(new std::thread([this]() {
-            while (this->alive())
-            {
-                std::unique_lock<std::mutex> lock(incoming_mail_notify_mutex_);
-                this->interthread().cv()->wait(lock);
-                // post empty handler to cause loop() to return and allow incoming mail to be handled
-                io_.post([]() {});
-            }
-        }));
+        // synchronize boost::asio and goby interthread signaling: publishers to this thread write
+        // to the eventfd, which causes loop() to return and allow incoming mail to be handled
+        incoming_mail_wakeup_ = std::make_shared<EventFdWakeup>();
+        incoming_mail_descriptor_.reset(new boost::asio::posix::stream_descriptor(io_));
+        int fd = ::dup(incoming_mail_wakeup_->fd());
+        if (fd < 0)
+            throw goby::Exception(std::string("Failed to duplicate eventfd: ") +
+                                  std::strerror(errno));
+        incoming_mail_descriptor_->assign(fd);
+        this->interthread().set_wakeup(incoming_mail_wakeup_);
+        async_wait_incoming_mail();
 
         this->set_name(thread_name_);
     }
 
     void finalize() override
     {
-        // join incoming mail thread
-        {
-            std::lock_guard<std::mutex> l(incoming_mail_notify_mutex_);
-            this->interthread().cv()->notify_all();
-        }
-        incoming_mail_notify_thread_->join();
-        incoming_mail_notify_thread_.reset();
+        this->interthread().set_wakeup(nullptr);
+        incoming_mail_descriptor_.reset();
     }
 
     virtual ~IOThread()
     {
         socket_.reset();
 
-        // for non clean shutdown, avoid abort
-        if (incoming_mail_notify_thread_)
-            incoming_mail_notify_thread_->detach();
-
         auto status = std::make_shared<protobuf::IOStatus>();
         status->set_state(protobuf::IO__LINK_CLOSED);
 
@@ -240,18 +273,32 @@ class IOThread : public ThreadType<IOConfig>,
     /// \brief If the socket is not open, try to open it. Otherwise, block until either 1) data is read or 2) we have incoming mail
     void loop() override;
 
+    void async_wait_incoming_mail()
+    {
+        incoming_mail_descriptor_->async_wait(
+            boost::asio::posix::stream_descriptor::wait_read,
+            [this](const boost::system::error_code& ec) {
+                if (ec == boost::asio::error::operation_aborted)
+                    return;
+                // clear before returning from loop() so that mail published after the
+                // subsequent poll() writes to the eventfd again
+                incoming_mail_wakeup_->clear();
+                async_wait_incoming_mail();
+            });
+    }
+
   private:
     boost::asio::io_context io_;
     std::unique_ptr<SocketType> socket_;
 
+    std::shared_ptr<EventFdWakeup> incoming_mail_wakeup_;
+    std::unique_ptr<boost::asio::posix::stream_descriptor> incoming_mail_descriptor_;
+
     const goby::time::SteadyClock::duration min_backoff_interval_{std::chrono::seconds(1)};
     const goby::time::SteadyClock::duration max_backoff_interval_{std::chrono::seconds(128)};
     goby::time::SteadyClock::duration backoff_interval_{min_backoff_interval_};
     goby::time::SteadyClock::time_point next_open_attempt_{goby::time::SteadyClock::now()};
 
-    std::mutex incoming_mail_notify_mutex_;
-    std::unique_ptr<std::thread> incoming_mail_notify_thread_;
-
     std::string glog_group_;
     std::string thread_name_;
     bool glog_group_added_{false};
@@ -360,7 +407,7 @@ void goby::middleware::io::detail::IOThread<line_in_group, line_out_group, publi
     {
         // run the io service (blocks until either we read something
         // from the socket or a subscription is available
-        // as signaled from an empty handler in the incoming_mail_notify_thread)
+        // as signaled by the incoming mail eventfd)
         io_.run_one();
     }
     else
@@ -24,15 +24,23 @@
 #ifndef GOBY_MIDDLEWARE_IO_LINE_BASED_COMMON_H
 #define GOBY_MIDDLEWARE_IO_LINE_BASED_COMMON_H
 
-#include <atomic>   // for atomic
-#include <locale>   // for ctype, use_facet, locale
-#include <map>      // for map
-#include <regex>    // for _NFA, match_results, regex, regex_search
-#include <sstream>  // for basic_stringbuf<>::int_type, basic_stringbuf<>::...
-#include <stddef.h> // for size_t
-#include <string>   // for string
-#include <utility>  // for make_pair, pair
-#include <vector>   // for vector
+#include <algorithm>   // for search, min
+#include <atomic>      // for atomic
+#include <cstring>     // for memchr, memcmp
+#include <locale>      // for ctype, use_facet, locale
+#include <map>         // for map
+#include <memory>      // for shared_ptr, make_shared
+#include <regex>       // for _NFA, match_results, regex, regex_search
+#include <sstream>     // for basic_stringbuf<>::int_type, basic_stringbuf<>::...
+#include <stddef.h>    // for size_t
+#include <string>      // for string
+#include <type_traits> // for integral_constant, is_convertible
+#include <utility>     // for make_pair, pair
+#include <vector>      // for vector
+
+#include <boost/asio/buffer.hpp>           // for const_buffer
+#include <boost/asio/buffers_iterator.hpp> // for buffers_iterator
+#include <boost/type_traits/integral_constant.hpp> // for true_type
 
 namespace boost
 {
@@ -86,6 +94,153 @@ class match_regex
     std::regex eol_regex_;
 };
 
+namespace detail
+{
+/// \brief True for iterators over a single contiguous block of chars (e.g. the input sequence of a boost::asio::streambuf), which can be searched with memchr
+template <typename Iterator> struct is_contiguous_char_iterator : std::false_type
+{
+};
+
+template <> struct is_contiguous_char_iterator<const char*> : std::true_type
+{
+};
+
+template <typename Buffer>
+struct is_contiguous_char_iterator<boost::asio::buffers_iterator<Buffer, char>>
+    : std::integral_constant<bool, std::is_convertible<Buffer, boost::asio::const_buffer>::value>
+{
+};
+
+/// \brief Converts an end-of-line std::regex to the string it matches, if the regex only matches a single literal string (e.g. "\\r\\n" or "\\*")
+/// \return true if eol is a literal (and literal is set), false if eol is a real pattern
+inline bool eol_regex_to_literal(const std::string& eol, std::string* literal)
+{
+    const std::string metachars("^$\\.*+?()[]{}|");
+    literal->clear();
+    for (std::string::size_type i = 0, n = eol.size(); i < n; ++i)
+    {
+        char c = eol[i];
+        if (c != '\\')
+        {
+            if (metachars.find(c) != std::string::npos)
+                return false;
+            literal->push_back(c);
+            continue;
+        }
+
+        if (++i == n)
+            return false;
+
+        char e = eol[i];
+        switch (e)
+        {
+            case 'r': literal->push_back('\r'); break;
+            case 'n': literal->push_back('\n'); break;
+            case 't': literal->push_back('\t'); break;
+            case 'f': literal->push_back('\f'); break;
+            case 'v': literal->push_back('\v'); break;
+            default:
+                // escaped metacharacter, other escapes (\\d, \\s, \\b, \\x, ...) are patterns
+                if (metachars.find(e) == std::string::npos && e != '/' && e != '-')
+                    return false;
+                literal->push_back(e);
+                break;
+        }
+    }
+    return !literal->empty();
+}
+} // namespace detail
+
+/// \brief Provides a matching function object for the boost::asio::async_read_until based on a literal delimiter string
+///
+/// Unlike match_regex, when no delimiter is found this returns the position from which a partial delimiter could begin, so async_read_until only searches the newly received bytes on the next call.
+class match_literal
+{
+  public:
+    explicit match_literal(std::string delimiter) : delimiter_(std::move(delimiter)) {}
+
+    template <typename Iterator>
+    std::pair<Iterator, bool> operator()(Iterator begin, Iterator end) const
+    {
+        return search(begin, end, detail::is_contiguous_char_iterator<Iterator>());
+    }
+
+    const std::string& delimiter() const { return delimiter_; }
+
+  private:
+    template <typename Iterator>
+    std::pair<Iterator, bool> search(Iterator begin, Iterator end, std::true_type) const
+    {
+        const std::size_t size = end - begin;
+        const std::size_t length = delimiter_.size();
+        if (size >= length)
+        {
+            const char* data = &*begin;
+            const char* first = data;
+            const char* last = data + size - length + 1;
+            while (first < last)
+            {
+                first = static_cast<const char*>(std::memchr(first, delimiter_[0], last - first));
+                if (!first)
+                    break;
+                if (std::memcmp(first + 1, delimiter_.data() + 1, length - 1) == 0)
+                    return std::make_pair(begin + ((first - data) + length), true);
+                ++first;
+            }
+        }
+        return no_match(begin, end);
+    }
+
+    template <typename Iterator>
+    std::pair<Iterator, bool> search(Iterator begin, Iterator end, std::false_type) const
+    {
+        Iterator match = std::search(begin, end, delimiter_.begin(), delimiter_.end());
+        if (match != end)
+            return std::make_pair(match + delimiter_.size(), true);
+        return no_match(begin, end);
+    }
+
+    // resume the next search at the last (length - 1) bytes, which may start a delimiter
+    template <typename Iterator>
+    std::pair<Iterator, bool> no_match(Iterator begin, Iterator end) const
+    {
+        const std::size_t size = end - begin;
+        return std::make_pair(end - std::min(size, delimiter_.size() - 1), false);
+    }
+
+  private:
+    std::string delimiter_;
+};
+
+/// \brief Provides a matching function object for the boost::asio::async_read_until for an end-of-line string (e.g. goby::middleware::protobuf::SerialConfig::end_of_line) that may be a std::regex
+///
+/// Uses match_literal if the regex only matches a single literal string (e.g. "\\n" or "\\r\\n"), otherwise match_regex.
+class match_eol
+{
+  public:
+    explicit match_eol(const std::string& eol) : literal_(std::string())
+    {
+        std::string literal;
+        if (detail::eol_regex_to_literal(eol, &literal))
+            literal_ = match_literal(literal);
+        else
+            regex_ = std::make_shared<match_regex>(eol);
+    }
+
+    template <typename Iterator>
+    std::pair<Iterator, bool> operator()(Iterator begin, Iterator end) const
+    {
+        return regex_ ? (*regex_)(begin, end) : literal_(begin, end);
+    }
+
+    bool is_literal() const { return !regex_; }
+
+  private:
+    match_literal literal_;
+    // shared since async_read_until copies the match condition for every read
+    std::shared_ptr<const match_regex> regex_;
+};
+
 } // namespace io
 } // namespace middleware
 } // namespace goby
@@ -97,6 +252,13 @@ namespace asio
 template <> struct is_match_condition<goby::middleware::io::match_regex> : public boost::true_type
 {
 };
+template <>
+struct is_match_condition<goby::middleware::io::match_literal> : public boost::true_type
+{
+};
+template <> struct is_match_condition<goby::middleware::io::match_eol> : public boost::true_type
+{
+};
 } // namespace asio
 } // namespace boost
 
@@ -33,7 +33,7 @@
 
 #include "goby/middleware/io/detail/io_interface.h"  // for PubSubLayer
 #include "goby/middleware/io/detail/pty_interface.h" // for PTYThread
-#include "goby/middleware/io/line_based/common.h"    // for match_regex
+#include "goby/middleware/io/line_based/common.h"    // for match_eol
 
 namespace goby
 {
@@ -89,7 +89,7 @@ class PTYThreadLineBased : public detail::PTYThread<line_in_group, line_out_grou
     void async_read() override;
 
   private:
-    match_regex eol_matcher_;
+    match_eol eol_matcher_;
     boost::asio::streambuf buffer_;
 };
 } // namespace io
@@ -34,7 +34,7 @@
 
 #include "goby/middleware/io/detail/io_interface.h"         // for PubSubLayer
 #include "goby/middleware/io/detail/tcp_client_interface.h" // for TCPClien...
-#include "goby/middleware/io/line_based/common.h"           // for match_regex
+#include "goby/middleware/io/line_based/common.h"           // for match_eol
 #include "goby/middleware/protobuf/io.pb.h"                 // for IOData
 
 namespace goby
@@ -95,7 +95,7 @@ class TCPClientThreadLineBased
     void async_read() override;
 
   private:
-    match_regex eol_matcher_;
+    match_eol eol_matcher_;
     boost::asio::streambuf buffer_;
 };
 } // namespace io
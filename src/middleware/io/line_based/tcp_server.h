@@ -36,7 +36,7 @@
 
 #include "goby/middleware/io/detail/io_interface.h"         // for PubSubLayer
 #include "goby/middleware/io/detail/tcp_server_interface.h" // for TCPServe...
-#include "goby/middleware/io/line_based/common.h"           // for match_regex
+#include "goby/middleware/io/line_based/common.h"           // for match_eol
 #include "goby/middleware/protobuf/io.pb.h"                 // for IOData
 #include "goby/middleware/protobuf/tcp_config.pb.h"         // for TCPServe...
 namespace goby
@@ -89,7 +89,7 @@ class TCPSessionLineBased : public detail::TCPSession<TCPServerThreadType>
     }
 
   private:
-    match_regex eol_matcher_;
+    match_eol eol_matcher_;
     boost::asio::streambuf buffer_;
 };
 
@@ -0,0 +1,231 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MIDDLEWARE_LOG_DETAIL_LOG_SCAN_H
+#define GOBY_MIDDLEWARE_LOG_DETAIL_LOG_SCAN_H
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint16_t, uint32_t, uint64_t
+#include <cstring> // for memcmp
+#include <map>     // for map
+#include <string>  // for string
+#include <utility> // for pair
+
+#include <boost/crc.hpp> // for crc_32_type
+
+#include "goby/middleware/log/log_entry.h"
+#include "goby/middleware/marshalling/interface.h" // for MarshallingScheme
+
+namespace goby
+{
+namespace middleware
+{
+namespace log
+{
+namespace detail
+{
+template <typename Unsigned> Unsigned read_netint(const char* p)
+{
+    constexpr int size = sizeof(Unsigned);
+    Unsigned u(0);
+    for (int i = 0; i < size; ++i)
+        u |= static_cast<Unsigned>(p[i] & 0xff) << ((size - (i + 1)) * 8);
+    return u;
+}
+
+/// \brief Header fields of one entry of a .goby file held in memory, as read by LogScanner
+struct RawLogEntry
+{
+    std::uint64_t offset{0};
+    std::uint16_t scheme{0};
+    std::uint16_t group_index{0};
+    std::uint16_t type_index{0};
+    // microseconds since UNIX (0 for files before version 3)
+    std::uint64_t timestamp{0};
+    const char* data{nullptr};
+    std::size_t data_size{0};
+};
+
+/// \brief Walks the entry headers of a complete .goby file held in memory (e.g. a MappedLogFile) without the static state used by LogEntry::parse()
+///
+/// Corrupt or truncated entries are skipped by searching for the next magic word, as LogEntry::parse() does.
+class LogScanner
+{
+  public:
+    LogScanner(const char* data, std::size_t size) : data_(data), size_(size)
+    {
+        // same logic as LogEntry::parse_version()
+        if (size_ >= static_cast<std::size_t>(LogEntry::version_bytes_) &&
+            std::memcmp(data_, magic_, LogEntry::magic_bytes_) != 0)
+        {
+            version_ = read_netint<std::uint32_t>(data_);
+            if (version_ > static_cast<std::uint32_t>(LogEntry::current_version_))
+                version_ = LogEntry::current_version_;
+            pos_ = LogEntry::version_bytes_;
+        }
+
+        fixed_field_size_ = LogEntry::scheme_bytes_ + LogEntry::group_bytes_ +
+                            LogEntry::type_bytes_ + LogEntry::crc_bytes_;
+        if (has_timestamp())
+            fixed_field_size_ += LogEntry::timestamp_bytes_;
+    }
+
+    std::uint32_t version() const { return version_; }
+    // timestamps were added in version 3
+    bool has_timestamp() const { return version_ >= 3; }
+    // the group/type to index mapping became per scheme in version 2
+    bool per_scheme_mapping() const { return version_ >= 2; }
+
+    /// \brief Read the next valid entry
+    /// \return false if there are no more entries
+    bool next(RawLogEntry* entry)
+    {
+        while (pos_ + header_bytes_ <= size_)
+        {
+            if (read(pos_, entry, true))
+            {
+                pos_ += header_bytes_ + fixed_field_size_ + entry->data_size;
+                return true;
+            }
+            ++pos_;
+        }
+        return false;
+    }
+
+    /// \brief Read the entry at a known offset (e.g. from an index)
+    /// \return false if there is no valid entry at this offset
+    bool read(std::size_t offset, RawLogEntry* entry, bool check_crc = true) const
+    {
+        if (offset + header_bytes_ > size_)
+            return false;
+
+        const char* p = data_ + offset;
+        if (std::memcmp(p, magic_, LogEntry::magic_bytes_) != 0)
+            return false;
+
+        auto entry_size = read_netint<std::uint32_t>(p + LogEntry::magic_bytes_);
+        if (entry_size < fixed_field_size_ || offset + header_bytes_ + entry_size > size_)
+            return false;
+
+        std::uint32_t crc_offset = header_bytes_ + entry_size - LogEntry::crc_bytes_;
+        if (check_crc)
+        {
+            boost::crc_32_type crc;
+            crc.process_bytes(p, crc_offset);
+            if (crc.checksum() != read_netint<std::uint32_t>(p + crc_offset))
+                return false;
+        }
+
+        const char* f = p + header_bytes_;
+        entry->offset = offset;
+        entry->scheme = read_netint<std::uint16_t>(f);
+        f += LogEntry::scheme_bytes_;
+        entry->group_index = read_netint<std::uint16_t>(f);
+        f += LogEntry::group_bytes_;
+        entry->type_index = read_netint<std::uint16_t>(f);
+        f += LogEntry::type_bytes_;
+        entry->timestamp = 0;
+        if (has_timestamp())
+        {
+            entry->timestamp = read_netint<std::uint64_t>(f);
+            f += LogEntry::timestamp_bytes_;
+        }
+        entry->data = f;
+        entry->data_size = (p + crc_offset) - f;
+        return true;
+    }
+
+  private:
+    static constexpr int header_bytes_{LogEntry::magic_bytes_ + LogEntry::size_bytes_};
+    static constexpr const char* magic_{"GBY3"};
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_{0};
+    std::uint32_t version_{1};
+    std::uint32_t fixed_field_size_;
+};
+
+/// \brief Per file group and type index tables (LogEntry holds these statically)
+class LogTables
+{
+  public:
+    explicit LogTables(bool per_scheme_mapping) : per_scheme_mapping_(per_scheme_mapping) {}
+
+    /// \brief Record the mapping if this is a group or type index entry
+    /// \return true if the entry was a group or type index entry
+    bool add(const RawLogEntry& entry)
+    {
+        if (entry.scheme != LogEntry::scheme_group_index_ &&
+            entry.scheme != LogEntry::scheme_type_index_)
+            return false;
+
+        const char* f = entry.data;
+        const char* data_end = entry.data + entry.data_size;
+        int mapping_scheme = goby::middleware::MarshallingScheme::NULL_SCHEME;
+        if (per_scheme_mapping_ && data_end - f >= LogEntry::scheme_bytes_)
+        {
+            mapping_scheme = read_netint<std::uint16_t>(f);
+            f += LogEntry::scheme_bytes_;
+        }
+
+        if (entry.scheme == LogEntry::scheme_group_index_)
+            groups_[std::make_pair(mapping_scheme, entry.group_index)] = std::string(f, data_end);
+        else
+            types_[std::make_pair(mapping_scheme, entry.type_index)] = std::string(f, data_end);
+        return true;
+    }
+
+    /// \brief Group name of a data entry, or nullptr if the file has no mapping for it
+    const std::string* group(const RawLogEntry& entry) const
+    {
+        auto it = groups_.find(std::make_pair(mapping_scheme(entry), entry.group_index));
+        return it == groups_.end() ? nullptr : &it->second;
+    }
+
+    /// \brief Type name of a data entry, or nullptr if the file has no mapping for it
+    const std::string* type(const RawLogEntry& entry) const
+    {
+        auto it = types_.find(std::make_pair(mapping_scheme(entry), entry.type_index));
+        return it == types_.end() ? nullptr : &it->second;
+    }
+
+  private:
+    int mapping_scheme(const RawLogEntry& entry) const
+    {
+        return per_scheme_mapping_ ? entry.scheme
+                                   : goby::middleware::MarshallingScheme::NULL_SCHEME;
+    }
+
+  private:
+    bool per_scheme_mapping_;
+    // (scheme, index) -> name
+    std::map<std::pair<int, std::uint16_t>, std::string> groups_, types_;
+};
+
+} // namespace detail
+} // namespace log
+} // namespace middleware
+} // namespace goby
+
+#endif
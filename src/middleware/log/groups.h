@@ -34,6 +34,7 @@ namespace middleware
 namespace groups
 {
 constexpr goby::middleware::Group logger_request{"goby::logger::request"};
+constexpr goby::middleware::Group logger_status{"goby::logger::status"};
 
 } // namespace groups
 } // namespace middleware
@@ -37,7 +37,8 @@
 #include "hdf5.h"
 #include "hdf5_plugin.h" // for HDF5ProtobufE...
 
-void goby::middleware::hdf5::Channel::add_message(const goby::middleware::HDF5ProtobufEntry& entry)
+goby::middleware::hdf5::MessageCollection&
+goby::middleware::hdf5::Channel::add_message(const goby::middleware::HDF5ProtobufEntry& entry)
 {
     const std::string& msg_name = entry.msg->GetDescriptor()->full_name();
     typedef std::map<std::string, MessageCollection>::iterator It;
@@ -49,6 +50,7 @@ void goby::middleware::hdf5::Channel::add_message(const goby::middleware::HDF5Pr
         it = itpair.first;
     }
     it->second.entries.insert(std::make_pair(time::MicroTime(entry.time).value(), entry));
+    return it->second;
 }
 
 H5::Group& goby::middleware::hdf5::GroupFactory::fetch_group(const std::string& group_path)
@@ -82,10 +84,13 @@ goby::middleware::hdf5::GroupFactory::GroupWrapper::fetch_group(std::deque<std::
     }
 }
 
-goby::middleware::hdf5::Writer::Writer(const std::string& output_file, bool write_zero_length_dim)
+goby::middleware::hdf5::Writer::Writer(const std::string& output_file, bool write_zero_length_dim,
+                                       const protobuf::HDF5WriterConfig& cfg)
     : h5file_(output_file, H5F_ACC_TRUNC),
       group_factory_(h5file_),
-      write_zero_length_dim_(write_zero_length_dim)
+      write_zero_length_dim_(write_zero_length_dim),
+      cfg_(cfg),
+      last_flush_(goby::time::SteadyClock::now())
 {
 }
 
@@ -102,21 +107,62 @@ void goby::middleware::hdf5::Writer::add_entry(goby::middleware::HDF5ProtobufEnt
         it = itpair.first;
     }
 
-    it->second.add_message(entry);
+    auto& message_collection = it->second.add_message(entry);
+
+    if (cfg_.streaming())
+    {
+        if (message_collection.entries.size() >= cfg_.chunk_length())
+            write_chunk("/" + it->first + "/" + message_collection.name, message_collection);
+
+        if (cfg_.flush_period() > 0 &&
+            goby::time::SteadyClock::now() - last_flush_ >=
+                std::chrono::duration<double>(cfg_.flush_period()))
+            write();
+    }
 }
 
 void goby::middleware::hdf5::Writer::write()
 {
-    for (const auto& channel : channels_) write_channel("/" + channel.first, channel.second);
+    for (auto& channel : channels_) write_channel("/" + channel.first, channel.second);
+
+    if (cfg_.streaming())
+    {
+        h5file_.flush(H5F_SCOPE_GLOBAL);
+        last_flush_ = goby::time::SteadyClock::now();
+    }
 }
 
 void goby::middleware::hdf5::Writer::write_channel(const std::string& group,
-                                                   const goby::middleware::hdf5::Channel& channel)
+                                                   goby::middleware::hdf5::Channel& channel)
 {
-    glog.is_verbose() && glog << "Writing HDF5 group: " << group << std::endl;
+    if (cfg_.streaming())
+    {
+        for (auto& entry : channel.entries) write_chunk(group + "/" + entry.first, entry.second);
+    }
+    else
+    {
+        glog.is_verbose() && glog << "Writing HDF5 group: " << group << std::endl;
 
-    for (const auto& entry : channel.entries)
-        write_message_collection(group + "/" + entry.first, entry.second);
+        for (const auto& entry : channel.entries)
+            write_message_collection(group + "/" + entry.first, entry.second);
+    }
+}
+
+void goby::middleware::hdf5::Writer::write_chunk(
+    const std::string& group, goby::middleware::hdf5::MessageCollection& message_collection)
+{
+    if (message_collection.entries.empty())
+        return;
+
+    glog.is_debug1() && glog << "Writing " << message_collection.entries.size()
+                             << " messages to HDF5 group: " << group << std::endl;
+
+    row_offset_ = message_collection.rows_written;
+    write_message_collection(group, message_collection);
+    row_offset_ = 0;
+
+    message_collection.rows_written += message_collection.entries.size();
+    message_collection.entries.clear();
 }
 
 void goby::middleware::hdf5::Writer::write_message_collection(
@@ -322,6 +368,10 @@ void goby::middleware::hdf5::Writer::write_enum_attributes(
     H5::Group& grp = group_factory_.fetch_group(group);
     H5::DataSet ds = grp.openDataSet(field_desc->name());
 
+    // already written by a previous chunk (streaming mode)
+    if (ds.attrExists("enum_names"))
+        return;
+
     const google::protobuf::EnumDescriptor* enum_desc = field_desc->enum_type();
 
     std::vector<const char*> names(enum_desc->value_count(), (const char*)nullptr);
@@ -417,19 +467,43 @@ void goby::middleware::hdf5::Writer::write_vector(const std::string& group,
     }
     hs.push_back(max_size);
 
-    std::unique_ptr<H5::DataSpace> dataspace;
-    H5::Group& grp = group_factory_.fetch_group(group);
-    if (data_char.size() || write_zero_length_dim_)
-        dataspace = std::make_unique<H5::DataSpace>(hs.size(), hs.data(), hs.data());
+    H5::DataSet dataset;
+    if (cfg_.streaming())
+    {
+        H5::DataSet size_dataset;
+        if (write_extendible(size_dataset, group, dataset_name + "_size",
+                             predicate<std::uint32_t>(), sizes.size() ? &sizes[0] : nullptr,
+                             hs_outer, std::uint32_t(0)))
+        {
+            std::uint32_t size_default_value(0);
+            const int rank = 1;
+            hsize_t att_hs[] = {1};
+            H5::DataSpace att_space(rank, att_hs, att_hs);
+            H5::Attribute att = size_dataset.createAttribute(
+                "default_value", predicate<std::uint32_t>(), att_space);
+            att.write(predicate<std::uint32_t>(), &size_default_value);
+        }
+
+        if (!write_extendible(dataset, group, dataset_name, H5::PredType::NATIVE_CHAR,
+                              data_char.size() ? &data_char[0] : nullptr, hs, '\0'))
+            return;
+    }
     else
-        dataspace = std::make_unique<H5::DataSpace>(H5S_NULL);
+    {
+        std::unique_ptr<H5::DataSpace> dataspace;
+        H5::Group& grp = group_factory_.fetch_group(group);
+        if (data_char.size() || write_zero_length_dim_)
+            dataspace = std::make_unique<H5::DataSpace>(hs.size(), hs.data(), hs.data());
+        else
+            dataspace = std::make_unique<H5::DataSpace>(H5S_NULL);
 
-    H5::DataSet dataset = grp.createDataSet(dataset_name, H5::PredType::NATIVE_CHAR, *dataspace);
+        dataset = grp.createDataSet(dataset_name, H5::PredType::NATIVE_CHAR, *dataspace);
 
-    if (data_char.size())
-        dataset.write(&data_char[0], H5::PredType::NATIVE_CHAR);
+        if (data_char.size())
+            dataset.write(&data_char[0], H5::PredType::NATIVE_CHAR);
 
-    write_vector(group, dataset_name + "_size", sizes, hs_outer, std::uint32_t(0));
+        write_vector(group, dataset_name + "_size", sizes, hs_outer, std::uint32_t(0));
+    }
 
     const int rank = 1;
     hsize_t att_hs[] = {1};
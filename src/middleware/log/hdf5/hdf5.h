@@ -37,6 +37,9 @@
 #include <google/protobuf/descriptor.h> // for FieldDescriptor
 #include <google/protobuf/message.h>    // for Message, Reflection
 
+#include "goby/middleware/protobuf/hdf5.pb.h" // for HDF5WriterConfig
+#include "goby/time/steady_clock.h"           // for SteadyClock
+
 #include "hdf5_predicate.h"       // for predicate
 #include "hdf5_protobuf_values.h" // for PBMeta, retrieve_default_value
 
@@ -55,6 +58,9 @@ struct MessageCollection
 
     // time -> ProtobufEntry
     std::multimap<std::uint64_t, HDF5ProtobufEntry> entries;
+
+    // number of messages already written to the file (streaming mode)
+    std::uint64_t rows_written{0};
 };
 
 struct Channel
@@ -62,7 +68,7 @@ struct Channel
     Channel(std::string n) : name(std::move(n)) {}
     std::string name;
 
-    void add_message(const goby::middleware::HDF5ProtobufEntry& entry);
+    MessageCollection& add_message(const goby::middleware::HDF5ProtobufEntry& entry);
 
     // message name -> hdf5::Message
     std::map<std::string, MessageCollection> entries;
@@ -101,14 +107,18 @@ class GroupFactory
 class Writer
 {
   public:
-    Writer(const std::string& output_file, bool write_zero_length_dim = true);
+    Writer(const std::string& output_file, bool write_zero_length_dim = true,
+           const protobuf::HDF5WriterConfig& cfg = protobuf::HDF5WriterConfig());
 
     void add_entry(goby::middleware::HDF5ProtobufEntry entry);
 
+    /// \brief Write all messages to the file. In streaming mode, writes the messages still buffered and may be called more than once
     void write();
 
   private:
-    void write_channel(const std::string& group, const goby::middleware::hdf5::Channel& channel);
+    void write_channel(const std::string& group, goby::middleware::hdf5::Channel& channel);
+    void write_chunk(const std::string& group,
+                     goby::middleware::hdf5::MessageCollection& message_collection);
     void
     write_message_collection(const std::string& group,
                              const goby::middleware::hdf5::MessageCollection& message_collection);
@@ -144,12 +154,25 @@ class Writer
                       const std::vector<std::string>& data, const std::vector<hsize_t>& hs,
                       const std::string& default_value);
 
+    // streaming mode: writes data of shape hs to rows [row_offset_, row_offset_ + hs[0]) of an
+    // extendible dataset (created if needed, with all other cells set to fill)
+    // returns true if the dataset was created
+    template <typename T>
+    bool write_extendible(H5::DataSet& dataset, const std::string& group,
+                          const std::string& dataset_name, const H5::DataType& datatype,
+                          const T* data, const std::vector<hsize_t>& hs, const T& fill);
+
   private:
     // channel name -> hdf5::Channel
     std::map<std::string, goby::middleware::hdf5::Channel> channels_;
     H5::H5File h5file_;
     goby::middleware::hdf5::GroupFactory group_factory_;
     bool write_zero_length_dim_;
+    protobuf::HDF5WriterConfig cfg_;
+
+    // first row of the message collection currently being written (streaming mode)
+    hsize_t row_offset_{0};
+    goby::time::SteadyClock::time_point last_flush_;
 };
 
 template <typename T>
@@ -220,16 +243,26 @@ void Writer::write_vector(const std::string& group, const std::string dataset_na
                           const std::vector<T>& data, const std::vector<hsize_t>& hs,
                           const T& default_value)
 {
-    std::unique_ptr<H5::DataSpace> dataspace;
-    H5::Group& grp = group_factory_.fetch_group(group);
-    if (data.size() || write_zero_length_dim_)
-        dataspace = std::make_unique<H5::DataSpace>(hs.size(), hs.data(), hs.data());
+    H5::DataSet dataset;
+    if (cfg_.streaming())
+    {
+        if (!write_extendible(dataset, group, dataset_name, predicate<T>(),
+                              data.size() ? &data[0] : nullptr, hs, retrieve_empty_value<T>()))
+            return;
+    }
     else
-        dataspace = std::make_unique<H5::DataSpace>(H5S_NULL);
-
-    H5::DataSet dataset = grp.createDataSet(dataset_name, predicate<T>(), *dataspace);
-    if (data.size())
-        dataset.write(&data[0], predicate<T>());
+    {
+        std::unique_ptr<H5::DataSpace> dataspace;
+        H5::Group& grp = group_factory_.fetch_group(group);
+        if (data.size() || write_zero_length_dim_)
+            dataspace = std::make_unique<H5::DataSpace>(hs.size(), hs.data(), hs.data());
+        else
+            dataspace = std::make_unique<H5::DataSpace>(H5S_NULL);
+
+        dataset = grp.createDataSet(dataset_name, predicate<T>(), *dataspace);
+        if (data.size())
+            dataset.write(&data[0], predicate<T>());
+    }
 
     const int rank = 1;
     hsize_t att_hs[] = {1};
@@ -237,6 +270,70 @@ void Writer::write_vector(const std::string& group, const std::string dataset_na
     H5::Attribute att = dataset.createAttribute("default_value", predicate<T>(), att_space);
     att.write(predicate<T>(), &default_value);
 }
+
+template <typename T>
+bool Writer::write_extendible(H5::DataSet& dataset, const std::string& group,
+                              const std::string& dataset_name, const H5::DataType& datatype,
+                              const T* data, const std::vector<hsize_t>& hs, const T& fill)
+{
+    H5::Group& grp = group_factory_.fetch_group(group);
+    const int rank = hs.size();
+
+    std::vector<hsize_t> required(hs);
+    required[0] += row_offset_;
+
+    bool created = false;
+    if (H5Lexists(grp.getId(), dataset_name.c_str(), H5P_DEFAULT) > 0)
+    {
+        dataset = grp.openDataSet(dataset_name);
+        std::vector<hsize_t> dims(rank);
+        dataset.getSpace().getSimpleExtentDims(dims.data());
+        bool extend = false;
+        for (int i = 0; i < rank; ++i)
+        {
+            if (required[i] > dims[i])
+            {
+                dims[i] = required[i];
+                extend = true;
+            }
+        }
+        if (extend)
+            dataset.extend(dims.data());
+    }
+    else
+    {
+        std::vector<hsize_t> max_dims(rank, H5S_UNLIMITED);
+        H5::DataSpace dataspace(rank, required.data(), max_dims.data());
+
+        std::vector<hsize_t> chunk_dims(rank);
+        chunk_dims[0] = std::max<hsize_t>(cfg_.chunk_length(), 1);
+        for (int i = 1; i < rank; ++i) chunk_dims[i] = std::max<hsize_t>(hs[i], 1);
+
+        H5::DSetCreatPropList props;
+        props.setChunk(rank, chunk_dims.data());
+        props.setFillValue(datatype, &fill);
+        if (cfg_.shuffle())
+            props.setShuffle();
+        if (cfg_.deflate_level() > 0)
+            props.setDeflate(cfg_.deflate_level());
+
+        dataset = grp.createDataSet(dataset_name, datatype, dataspace, props);
+        created = true;
+    }
+
+    hsize_t size = 1;
+    for (auto h : hs) size *= h;
+    if (size > 0)
+    {
+        std::vector<hsize_t> start(rank, 0);
+        start[0] = row_offset_;
+        H5::DataSpace file_space = dataset.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, hs.data(), start.data());
+        H5::DataSpace mem_space(rank, hs.data());
+        dataset.write(data, datatype, mem_space, file_space);
+    }
+    return created;
+}
 } // namespace hdf5
 } // namespace middleware
 } // namespace goby
@@ -50,6 +50,7 @@ class JSONPlugin : public LogPlugin
     }
 
     void register_read_hooks(const std::ifstream& in_log_file) override {}
+    void register_read_hooks(const std::istream& in_log_file) override {}
 
     void register_write_hooks(std::ofstream& out_log_file) override {}
 
@@ -88,220 +88,243 @@ void LogEntry::parse_version(std::istream* s)
 
 void LogEntry::parse(std::istream* s)
 {
-    using namespace goby::util::logger;
-    using goby::glog;
+    if (version_ == invalid_version)
+        parse_version(s);
+
+    auto old_except_mask = s->exceptions();
+    s->exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
+
+    while (!_parse_one(s)) {}
+
+    s->exceptions(old_except_mask);
+}
 
+bool LogEntry::parse_one(std::istream* s)
+{
     if (version_ == invalid_version)
         parse_version(s);
 
     auto old_except_mask = s->exceptions();
     s->exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
 
+    bool data_entry = _parse_one(s);
+
+    s->exceptions(old_except_mask);
+    return data_entry;
+}
+
+bool LogEntry::_parse_one(std::istream* s)
+{
+    using namespace goby::util::logger;
+    using goby::glog;
+
     int legacy_scheme = goby::middleware::MarshallingScheme::NULL_SCHEME;
 
     uint<scheme_bytes_>::type scheme(0);
 
     bool filter_matched = false;
-    do
+
+    char next_char = s->peek();
+    if (next_char != magic_[0])
     {
-        char next_char = s->peek();
-        if (next_char != magic_[0])
-        {
-            glog.is(WARN) && glog << "Next byte [0x" << std::hex
-                                  << (static_cast<int>(next_char) & 0xFF) << std::dec
-                                  << "] is not the start of the expected magic word [" << magic_
-                                  << "]. Seeking until next magic word." << std::endl;
-        }
+        glog.is(WARN) && glog << "Next byte [0x" << std::hex
+                              << (static_cast<int>(next_char) & 0xFF) << std::dec
+                              << "] is not the start of the expected magic word [" << magic_
+                              << "]. Seeking until next magic word." << std::endl;
+    }
 
-        std::string magic_read(magic_.size(), '\0');
-        int discarded = 0;
+    std::string magic_read(magic_.size(), '\0');
+    int discarded = 0;
 
-        for (;;)
+    for (;;)
+    {
+        s->read(&magic_read[0], magic_.size());
+        if (magic_read == magic_)
         {
-            s->read(&magic_read[0], magic_.size());
-            if (magic_read == magic_)
-            {
-                break;
-            }
-            else
-            {
-                ++discarded;
-                // rewind to read the next byte
-                s->seekg(s->tellg() - std::streamoff(magic_.size() - 1));
-            }
+            break;
+        }
+        else
+        {
+            ++discarded;
+            // rewind to read the next byte
+            s->seekg(s->tellg() - std::streamoff(magic_.size() - 1));
         }
+    }
 
-        if (discarded != 0)
-            glog.is(WARN) && glog << "Found next magic word after skipping " << discarded
-                                  << " bytes" << std::endl;
+    if (discarded != 0)
+        glog.is(WARN) && glog << "Found next magic word after skipping " << discarded
+                              << " bytes" << std::endl;
 
-        boost::crc_32_type crc;
-        crc.process_bytes(&magic_read[0], magic_.size());
+    boost::crc_32_type crc;
+    crc.process_bytes(&magic_read[0], magic_.size());
 
-        auto size(read_one<uint<size_bytes_>::type>(s, &crc));
-        decltype(size) fixed_field_size = scheme_bytes_ + group_bytes_ + type_bytes_ + crc_bytes_;
-        if (version_ >= VERSION_ADD_TIMESTAMP)
-            fixed_field_size += timestamp_bytes_;
+    auto size(read_one<uint<size_bytes_>::type>(s, &crc));
+    decltype(size) fixed_field_size = scheme_bytes_ + group_bytes_ + type_bytes_ + crc_bytes_;
+    if (version_ >= VERSION_ADD_TIMESTAMP)
+        fixed_field_size += timestamp_bytes_;
 
-        if (size < fixed_field_size)
-            throw(log::LogException("Invalid size read: " + std::to_string(size) +
-                                    " as message must be at least " +
-                                    std::to_string(fixed_field_size) + " bytes long"));
+    if (size < fixed_field_size)
+        throw(log::LogException("Invalid size read: " + std::to_string(size) +
+                                " as message must be at least " +
+                                std::to_string(fixed_field_size) + " bytes long"));
 
-        auto data_size = size - fixed_field_size;
-        glog.is(DEBUG2) && glog << "Reading entry of " << size << " bytes (" << data_size
-                                << " bytes data)" << std::endl;
+    auto data_size = size - fixed_field_size;
+    glog.is(DEBUG2) && glog << "Reading entry of " << size << " bytes (" << data_size
+                            << " bytes data)" << std::endl;
 
-        scheme = read_one<uint<scheme_bytes_>::type>(s, &crc);
-        auto group_index(read_one<uint<group_bytes_>::type>(s, &crc));
-        auto type_index(read_one<uint<type_bytes_>::type>(s, &crc));
-        if (version_ >= VERSION_ADD_TIMESTAMP)
-        {
-            auto timestamp(read_one<uint<timestamp_bytes_>::type>(s, &crc));
-            glog.is(DEBUG2) && glog << "Timestamp: " << timestamp << " microseconds" << std::endl;
-            timestamp_ = goby::time::convert<decltype(timestamp_)>(
-                timestamp * boost::units::si::micro * boost::units::si::seconds);
-        }
+    scheme = read_one<uint<scheme_bytes_>::type>(s, &crc);
+    auto group_index(read_one<uint<group_bytes_>::type>(s, &crc));
+    auto type_index(read_one<uint<type_bytes_>::type>(s, &crc));
+    if (version_ >= VERSION_ADD_TIMESTAMP)
+    {
+        auto timestamp(read_one<uint<timestamp_bytes_>::type>(s, &crc));
+        glog.is(DEBUG2) && glog << "Timestamp: " << timestamp << " microseconds" << std::endl;
+        timestamp_ = goby::time::convert<decltype(timestamp_)>(
+            timestamp * boost::units::si::micro * boost::units::si::seconds);
+    }
 
-        auto data_start_pos = s->tellg();
-        try
-        {
-            data_.resize(data_size);
-            s->read(reinterpret_cast<char*>(&data_[0]), data_size);
+    auto data_start_pos = s->tellg();
+    try
+    {
+        data_.resize(data_size);
+        s->read(reinterpret_cast<char*>(&data_[0]), data_size);
 
-            crc.process_bytes(&data_[0], data_.size());
+        crc.process_bytes(&data_[0], data_.size());
 
-            auto calculated_crc = crc.checksum();
-            auto given_crc(read_one<uint<crc_bytes_>::type>(s));
+        auto calculated_crc = crc.checksum();
+        auto given_crc(read_one<uint<crc_bytes_>::type>(s));
 
-            if (calculated_crc != given_crc)
-            {
-                // return to where we started reading data as the size might have been corrupt
-                s->seekg(data_start_pos);
-                data_.clear();
-                throw(
-                    log::LogException("Invalid CRC on packet: given: " + std::to_string(given_crc) +
-                                      ", calculated: " + std::to_string(calculated_crc)));
-            }
-        }
-        catch (std::ios_base::failure& e)
+        if (calculated_crc != given_crc)
         {
-            // clear EOF, etc.
-            s->clear();
-            // return to where data reading starting in case size was corrupted
+            // return to where we started reading data as the size might have been corrupt
             s->seekg(data_start_pos);
-            throw(log::LogException("Failed to read " + std::to_string(size) +
-                                    " bytes of data; seeking back to start of data read in hopes "
-                                    "of finding valid next message."));
+            data_.clear();
+            throw(
+                log::LogException("Invalid CRC on packet: given: " + std::to_string(given_crc) +
+                                  ", calculated: " + std::to_string(calculated_crc)));
         }
+    }
+    catch (std::ios_base::failure& e)
+    {
+        // clear EOF, etc.
+        s->clear();
+        // return to where data reading starting in case size was corrupted
+        s->seekg(data_start_pos);
+        throw(log::LogException("Failed to read " + std::to_string(size) +
+                                " bytes of data; seeking back to start of data read in hopes "
+                                "of finding valid next message."));
+    }
 
-        if (scheme == scheme_group_index_)
+    if (scheme == scheme_group_index_)
+    {
+        if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
         {
-            if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
-            {
-                std::string group(data_.begin(), data_.end());
-
-                // The first type of .goby files that used a single mapping of type/group
-                // string for all schemes. This worked fine unless the two schemes are in use that had a common type name.
-                glog.is(DEBUG1) && glog << "Mapping group [" << group
-                                        << "] to index: " << group_index << std::endl;
-
-                groups_[legacy_scheme].left.insert({group, group_index});
-            }
-            else
-            {
-                std::string group_scheme_str(data_.begin(), data_.begin() + scheme_bytes_);
-                auto group_scheme = string_to_netint<uint<scheme_bytes_>::type>(group_scheme_str);
+            std::string group(data_.begin(), data_.end());
 
-                std::string group(data_.begin() + scheme_bytes_, data_.end());
-                glog.is(DEBUG1) && glog << "For scheme [" << group_scheme << "], mapping group ["
-                                        << group << "] to index: " << group_index << std::endl;
-                groups_[group_scheme].left.insert({group, group_index});
+            // The first type of .goby files that used a single mapping of type/group
+            // string for all schemes. This worked fine unless the two schemes are in use that had a common type name.
+            glog.is(DEBUG1) && glog << "Mapping group [" << group
+                                    << "] to index: " << group_index << std::endl;
 
-                if (new_group_hook[group_scheme])
-                    new_group_hook[group_scheme](goby::middleware::DynamicGroup(group));
-            }
-            data_.clear();
+            groups_[legacy_scheme].left.insert({group, group_index});
         }
-        else if (scheme == scheme_type_index_)
+        else
         {
-            if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
-            {
-                std::string type(data_.begin(), data_.end());
-                glog.is(DEBUG1) && glog << "Mapping type [" << type << "] to index: " << type_index
-                                        << std::endl;
-                types_[legacy_scheme].left.insert({type, type_index});
-            }
-            else
-            {
-                std::string type_scheme_str(data_.begin(), data_.begin() + scheme_bytes_);
-                auto type_scheme = string_to_netint<uint<scheme_bytes_>::type>(type_scheme_str);
-
-                std::string type(data_.begin() + scheme_bytes_, data_.end());
-                glog.is(DEBUG1) && glog << "For scheme [" << type_scheme << "], mapping type ["
-                                        << type << "] to index: " << type_index << std::endl;
-                types_[type_scheme].left.insert({type, type_index});
+            std::string group_scheme_str(data_.begin(), data_.begin() + scheme_bytes_);
+            auto group_scheme = string_to_netint<uint<scheme_bytes_>::type>(group_scheme_str);
 
-                if (new_type_hook[type_scheme])
-                    new_type_hook[type_scheme](type);
-            }
+            std::string group(data_.begin() + scheme_bytes_, data_.end());
+            glog.is(DEBUG1) && glog << "For scheme [" << group_scheme << "], mapping group ["
+                                    << group << "] to index: " << group_index << std::endl;
+            groups_[group_scheme].left.insert({group, group_index});
 
-            data_.clear();
+            if (new_group_hook[group_scheme])
+                new_group_hook[group_scheme](goby::middleware::DynamicGroup(group));
+        }
+        data_.clear();
+    }
+    else if (scheme == scheme_type_index_)
+    {
+        if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
+        {
+            std::string type(data_.begin(), data_.end());
+            glog.is(DEBUG1) && glog << "Mapping type [" << type << "] to index: " << type_index
+                                    << std::endl;
+            types_[legacy_scheme].left.insert({type, type_index});
         }
         else
         {
-            scheme_ = scheme;
+            std::string type_scheme_str(data_.begin(), data_.begin() + scheme_bytes_);
+            auto type_scheme = string_to_netint<uint<scheme_bytes_>::type>(type_scheme_str);
 
-            std::string type = "_unknown" + std::to_string(type_index) + "_";
-            auto type_it = types_[scheme].right.find(type_index),
-                 type_end_it = types_[scheme].right.end();
+            std::string type(data_.begin() + scheme_bytes_, data_.end());
+            glog.is(DEBUG1) && glog << "For scheme [" << type_scheme << "], mapping type ["
+                                    << type << "] to index: " << type_index << std::endl;
+            types_[type_scheme].left.insert({type, type_index});
 
-            if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
-            {
-                type_it = types_[legacy_scheme].right.find(type_index);
-                type_end_it = types_[legacy_scheme].right.end();
-            }
+            if (new_type_hook[type_scheme])
+                new_type_hook[type_scheme](type);
+        }
 
-            if (type_it != type_end_it)
-                type = type_it->second;
-            else
-                glog.is(WARN) && glog << "No type entry in file for type index: " << type_index
-                                      << std::endl;
+        data_.clear();
+    }
+    else
+    {
+        scheme_ = scheme;
 
-            type_ = type;
+        auto type_it = types_[scheme].right.find(type_index),
+             type_end_it = types_[scheme].right.end();
 
-            std::string group = "_unknown" + std::to_string(group_index) + "_";
-            auto group_it = groups_[scheme].right.find(group_index),
-                 group_end_it = groups_[scheme].right.end();
+        if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
+        {
+            type_it = types_[legacy_scheme].right.find(type_index);
+            type_end_it = types_[legacy_scheme].right.end();
+        }
 
-            if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
-            {
-                group_it = groups_[legacy_scheme].right.find(group_index);
-                group_end_it = groups_[legacy_scheme].right.end();
-            }
+        if (type_it != type_end_it)
+        {
+            type_ = type_it->second;
+        }
+        else
+        {
+            type_ = "_unknown" + std::to_string(type_index) + "_";
+            glog.is(WARN) && glog << "No type entry in file for type index: " << type_index
+                                  << std::endl;
+        }
 
-            if (group_it != group_end_it)
-                group = group_it->second;
-            else
-                glog.is(WARN) && glog << "No group entry in file for group index: " << group_index
-                                      << std::endl;
+        auto group_it = groups_[scheme].right.find(group_index),
+             group_end_it = groups_[scheme].right.end();
 
-            group_ = goby::middleware::DynamicGroup(group);
+        if (version_ < VERSION_ADD_SCHEME_TO_GROUP_TYPE_MAPPING)
+        {
+            group_it = groups_[legacy_scheme].right.find(group_index);
+            group_end_it = groups_[legacy_scheme].right.end();
+        }
 
-            LogFilter filt{scheme_, group, type_};
-            if (filter_hook.count(filt))
+        if (group_it != group_end_it)
+        {
+            group_ = goby::middleware::DynamicGroup(group_it->second);
+        }
+        else
+        {
+            group_ = goby::middleware::DynamicGroup("_unknown" + std::to_string(group_index) +
+                                                   "_");
+            glog.is(WARN) && glog << "No group entry in file for group index: " << group_index
+                                  << std::endl;
+        }
+
+        if (!filter_hook.empty())
+        {
+            auto filter_it = filter_hook.find(LogFilter{scheme_, group_.c_str(), type_});
+            if (filter_it != filter_hook.end())
             {
                 filter_matched = true;
-                filter_hook[filt](data_);
-            }
-            else
-            {
-                filter_matched = false;
+                filter_it->second(data_);
             }
         }
-    } while (scheme == scheme_group_index_ || scheme == scheme_type_index_ || filter_matched);
+    }
 
-    s->exceptions(old_except_mask);
+    return !(scheme == scheme_group_index_ || scheme == scheme_type_index_ || filter_matched);
 }
 
 void LogEntry::serialize(std::ostream* s) const
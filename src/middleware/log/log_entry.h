@@ -24,6 +24,7 @@
 #ifndef GOBY_MIDDLEWARE_LOG_LOG_ENTRY_H
 #define GOBY_MIDDLEWARE_LOG_LOG_ENTRY_H
 
+#include <array>           // for array
 #include <boost/bimap.hpp> // for bimap
 #include <boost/crc.hpp>   // for crc_32_type
 #include <cstdint>         // for uint16_t, uint32_t, uint64_t, uin...
@@ -137,6 +138,12 @@ class LogEntry
     void parse_version(std::istream* s);
     void parse(std::istream* s);
 
+    /// \brief Parse exactly one entry from the stream, which may be a group or type index entry or an entry consumed by a filter_hook
+    ///
+    /// Used to replay the indexing entries when seeking within a log (see LogIndex).
+    /// \return true if a data entry was read (i.e. the same as what parse() would have returned), false otherwise
+    bool parse_one(std::istream* s);
+
     // used by the unit tests to override version numbers
     static void set_current_version(decltype(version_) version) { current_version_ = version; }
 
@@ -166,6 +173,9 @@ class LogEntry
     }
 
   private:
+    // returns true if a data entry was read
+    bool _parse_one(std::istream* s);
+
     void _serialize(std::ostream* s, uint<scheme_bytes_>::type scheme,
                     uint<group_bytes_>::type group_index, uint<type_bytes_>::type type_index,
                     const char* data, int data_size) const;
@@ -173,13 +183,16 @@ class LogEntry
     template <typename Unsigned>
     Unsigned read_one(std::istream* s, boost::crc_32_type* crc = nullptr)
     {
-        auto size = std::numeric_limits<Unsigned>::digits / 8;
-        std::string str(size, '\0');
-        s->read(&str[0], size);
+        constexpr auto size = std::numeric_limits<Unsigned>::digits / 8;
+        std::array<char, size> bytes;
+        s->read(bytes.data(), size);
         if (crc)
-            crc->process_bytes(&str[0], size);
+            crc->process_bytes(bytes.data(), size);
 
-        return string_to_netint<Unsigned>(str);
+        Unsigned u(0);
+        for (int i = 0; i < size; ++i)
+            u |= static_cast<Unsigned>(bytes[i] & 0xff) << ((size - (i + 1)) * 8);
+        return u;
     }
 
     template <typename Unsigned> std::string netint_to_string(Unsigned u) const
@@ -0,0 +1,340 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "log_index.h"
+
+#include <algorithm> // for partition_point, min
+#include <cerrno>    // for errno
+#include <chrono>    // for duration_cast
+#include <cstring>   // for strerror
+#include <fcntl.h>   // for open, O_RDONLY
+#include <fstream>   // for ifstream, ofstream
+#include <limits>    // for numeric_limits
+#include <set>       // for set
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close
+
+#include <boost/crc.hpp> // for crc_32_type
+
+#include "goby/middleware/log/detail/log_scan.h"
+#include "goby/middleware/log/log_entry.h"
+#include "goby/util/debug_logger/flex_ostream.h" // for glog
+
+using goby::glog;
+using goby::middleware::log::LogEntry;
+
+namespace
+{
+// covers the file header and (at least the end of) the last entry
+constexpr std::size_t fingerprint_bytes{4096};
+} // namespace
+
+goby::middleware::log::MappedLogFile::MappedLogFile(std::string path)
+    : path_(std::move(path)), stream_(&buf_)
+{
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw(LogException("Failed to open " + path_ + ": " + std::strerror(errno)));
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0)
+    {
+        int err = errno;
+        ::close(fd);
+        throw(LogException("Failed to stat " + path_ + ": " + std::strerror(err)));
+    }
+
+    // pipes, FIFOs, etc. cannot be mapped (and report a size of zero)
+    if (!S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        throw(LogException("Cannot mmap " + path_ + ": not a regular file"));
+    }
+    if (static_cast<std::uint64_t>(st.st_size) > std::numeric_limits<std::size_t>::max())
+    {
+        ::close(fd);
+        throw(LogException("Cannot mmap " + path_ + ": too large for the address space"));
+    }
+
+    size_ = st.st_size;
+    mtime_ = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    // mmap() does not allow zero length mappings
+    if (size_ > 0)
+    {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            int err = errno;
+            ::close(fd);
+            throw(LogException("Failed to mmap " + path_ + ": " + std::strerror(err)));
+        }
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+    }
+    // the mapping remains valid after the descriptor is closed
+    ::close(fd);
+
+    buf_.set(data_, size_);
+}
+
+std::uint32_t goby::middleware::log::MappedLogFile::fingerprint() const
+{
+    boost::crc_32_type crc;
+    auto n = std::min(fingerprint_bytes, size_);
+    if (n > 0)
+    {
+        crc.process_bytes(data_, n);
+        crc.process_bytes(data_ + size_ - n, n);
+    }
+    return crc.checksum();
+}
+
+goby::middleware::log::LogInputFile::LogInputFile(const std::string& path)
+{
+    try
+    {
+        mapped_.reset(new MappedLogFile(path));
+    }
+    catch (LogException& e)
+    {
+        glog.is_warn() && glog << e.what() << ", reading with std::ifstream instead" << std::endl;
+        ifstream_.open(path.c_str());
+        if (!ifstream_.is_open())
+            throw(LogException("Failed to open " + path));
+    }
+}
+
+std::istream& goby::middleware::log::LogInputFile::stream()
+{
+    if (mapped_)
+        return mapped_->stream();
+    else
+        return ifstream_;
+}
+
+goby::middleware::log::MappedLogFile::~MappedLogFile()
+{
+    if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+
+goby::middleware::log::MappedLogFile::Buffer::pos_type
+goby::middleware::log::MappedLogFile::Buffer::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                      std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in))
+        return pos_type(off_type(-1));
+
+    off_type base = 0;
+    switch (dir)
+    {
+        case std::ios_base::beg: base = 0; break;
+        case std::ios_base::cur: base = gptr() - eback(); break;
+        case std::ios_base::end: base = egptr() - eback(); break;
+        default: return pos_type(off_type(-1));
+    }
+
+    off_type target = base + off;
+    if (target < 0 || target > egptr() - eback())
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + target, egptr());
+    return pos_type(target);
+}
+
+void goby::middleware::log::LogIndex::build(const char* data, std::size_t size)
+{
+    index_.Clear();
+    index_.set_log_size(size);
+    index_.set_checkpoint_bytes(checkpoint_bytes_);
+    for (const auto& filter_p : LogEntry::filter_hook)
+    {
+        auto& filter = *index_.add_filter();
+        filter.set_scheme(filter_p.first.scheme);
+        filter.set_group(filter_p.first.group);
+        filter.set_type(filter_p.first.type);
+    }
+
+    detail::LogScanner scanner(data, size);
+    index_.set_version(scanner.version());
+    detail::LogTables tables(scanner.per_scheme_mapping());
+
+    std::uint64_t max_timestamp = 0;
+    bool have_checkpoint = false;
+    std::uint64_t last_checkpoint = 0;
+
+    detail::RawLogEntry entry;
+    while (scanner.next(&entry))
+    {
+        if (tables.add(entry))
+        {
+            index_.add_replay_offset(entry.offset);
+            continue;
+        }
+
+        bool filtered = false;
+        if (!LogEntry::filter_hook.empty())
+        {
+            const auto* group = tables.group(entry);
+            const auto* type = tables.type(entry);
+            if (group && type &&
+                LogEntry::filter_hook.count(LogFilter{entry.scheme, *group, *type}))
+                filtered = true;
+        }
+
+        if (filtered)
+        {
+            index_.add_replay_offset(entry.offset);
+        }
+        else if (scanner.has_timestamp())
+        {
+            if (!have_checkpoint || entry.offset - last_checkpoint >= checkpoint_bytes_)
+            {
+                auto& checkpoint = *index_.add_checkpoint();
+                checkpoint.set_offset(entry.offset);
+                checkpoint.set_max_timestamp_before(max_timestamp);
+                checkpoint.set_replay_count(index_.replay_offset_size());
+                have_checkpoint = true;
+                last_checkpoint = entry.offset;
+            }
+            max_timestamp = std::max(max_timestamp, entry.timestamp);
+        }
+    }
+
+    glog.is_debug1() && glog << "Built log index with " << index_.checkpoint_size()
+                             << " checkpoints and " << index_.replay_offset_size()
+                             << " replay entries" << std::endl;
+}
+
+void goby::middleware::log::LogIndex::build(const MappedLogFile& log)
+{
+    build(log.data(), log.size());
+    index_.set_log_mtime(log.mtime());
+    index_.set_log_fingerprint(log.fingerprint());
+}
+
+bool goby::middleware::log::LogIndex::filters_match() const
+{
+    std::set<LogFilter> index_filters;
+    for (const auto& filter : index_.filter())
+        index_filters.insert(LogFilter{filter.scheme(), filter.group(), filter.type()});
+
+    if (index_filters.size() != LogEntry::filter_hook.size())
+        return false;
+
+    auto it = index_filters.begin();
+    for (const auto& filter_p : LogEntry::filter_hook)
+    {
+        const auto& a = *it++;
+        const auto& b = filter_p.first;
+        if (a < b || b < a)
+            return false;
+    }
+    return true;
+}
+
+bool goby::middleware::log::LogIndex::load(const std::string& path, const MappedLogFile& log)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    protobuf::LogIndex index;
+    if (!index.ParseFromIstream(&in))
+    {
+        glog.is_warn() && glog << "Failed to parse log index: " << path << std::endl;
+        return false;
+    }
+
+    index_.Swap(&index);
+    return log.matches(index_.log_size(), index_.log_mtime(), index_.log_fingerprint()) &&
+           index_.checkpoint_bytes() == checkpoint_bytes_ && filters_match();
+}
+
+void goby::middleware::log::LogIndex::save(const std::string& path) const
+{
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open() || !index_.SerializeToOstream(&out))
+        throw(LogException("Failed to write log index: " + path));
+}
+
+void goby::middleware::log::LogIndex::load_or_build(const MappedLogFile& log, bool write_sidecar)
+{
+    auto path = sidecar_path(log.path());
+    if (load(path, log))
+    {
+        glog.is_debug1() && glog << "Using log index: " << path << std::endl;
+        return;
+    }
+
+    build(log);
+
+    if (write_sidecar)
+    {
+        try
+        {
+            save(path);
+        }
+        catch (LogException& e)
+        {
+            glog.is_warn() && glog << e.what() << std::endl;
+        }
+    }
+}
+
+void goby::middleware::log::LogIndex::seek(std::istream& s,
+                                           goby::time::SystemClock::time_point t) const
+{
+    s.clear();
+    if (LogEntry::version_ == LogEntry::invalid_version)
+    {
+        s.seekg(0);
+        LogEntry().parse_version(&s);
+    }
+
+    std::uint64_t t_us = std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch())
+                             .count();
+
+    const auto& checkpoints = index_.checkpoint();
+    // first checkpoint that may have an entry at or after t before it
+    auto it = std::partition_point(
+        checkpoints.begin(), checkpoints.end(),
+        [&](const protobuf::LogIndex::Checkpoint& c) { return c.max_timestamp_before() < t_us; });
+
+    if (it == checkpoints.begin())
+    {
+        // start from the beginning of the file (after the version, if any)
+        s.seekg(index_.version() >= 2 ? LogEntry::version_bytes_ : 0);
+        return;
+    }
+
+    const auto& checkpoint = *(--it);
+    for (std::uint32_t i = 0, n = checkpoint.replay_count(); i < n; ++i)
+    {
+        s.seekg(index_.replay_offset(i));
+        LogEntry().parse_one(&s);
+    }
+
+    s.seekg(checkpoint.offset());
+}
@@ -0,0 +1,174 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MIDDLEWARE_LOG_LOG_INDEX_H
+#define GOBY_MIDDLEWARE_LOG_LOG_INDEX_H
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+#include <fstream> // for ifstream
+#include <istream> // for istream
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+
+#include "goby/middleware/protobuf/log_index.pb.h"
+#include "goby/time/system_clock.h"
+
+namespace goby
+{
+namespace middleware
+{
+namespace log
+{
+/// \brief Read-only memory mapped .goby file, exposed as a seekable std::istream for LogEntry::parse()
+///
+/// The file size is fixed when the file is opened, so entries appended afterwards (e.g. by a running goby_logger) are not visible.
+class MappedLogFile
+{
+  public:
+    /// \brief Map the given file
+    /// \throw LogException if the file cannot be opened or mapped
+    explicit MappedLogFile(std::string path);
+    ~MappedLogFile();
+
+    MappedLogFile(const MappedLogFile&) = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+    std::istream& stream() { return stream_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+    /// \return modification time of the file when it was mapped (nanoseconds since UNIX)
+    std::int64_t mtime() const { return mtime_; }
+    /// \return CRC-32 of the first and last few kilobytes of the file
+    std::uint32_t fingerprint() const;
+
+    /// \brief Check a sidecar index against this file
+    /// \return true if the file has the given size, modification time and fingerprint (as recorded when the sidecar was written), so that a log rewritten to the same size is not read through a stale index
+    bool matches(std::uint64_t size, std::int64_t mtime, std::uint32_t fingerprint) const
+    {
+        return size == size_ && mtime == mtime_ && fingerprint == this->fingerprint();
+    }
+
+  private:
+    class Buffer : public std::streambuf
+    {
+      public:
+        void set(const char* data, std::size_t size)
+        {
+            char* b = const_cast<char*>(data);
+            setg(b, b, b + size);
+        }
+
+      protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                         std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+        std::streamsize showmanyc() override { return egptr() - gptr(); }
+    };
+
+    std::string path_;
+    const char* data_{nullptr};
+    std::size_t size_{0};
+    std::int64_t mtime_{0};
+    Buffer buf_;
+    std::istream stream_;
+};
+
+/// \brief Input log that is read through a MappedLogFile when possible, falling back to std::ifstream when the file cannot be mapped (e.g. not a regular file, or too large for the address space)
+class LogInputFile
+{
+  public:
+    explicit LogInputFile(const std::string& path);
+
+    std::istream& stream();
+
+    /// \return the mapped file, or nullptr if reading through std::ifstream
+    const MappedLogFile* mapped() const { return mapped_.get(); }
+
+    /// \return the fallback stream (only open if mapped() is nullptr)
+    const std::ifstream& ifstream() const { return ifstream_; }
+
+  private:
+    std::unique_ptr<MappedLogFile> mapped_;
+    std::ifstream ifstream_;
+};
+
+/// \brief Sparse seek index for a .goby file
+///
+/// The index holds a checkpoint roughly every checkpoint_bytes of the log, each storing the largest timestamp of any entry before it, along with the offsets of the entries (group/type indices and entries consumed by LogEntry::filter_hook, such as Protobuf file descriptors) that must be parsed before any later data entry can be decoded. Seeking replays these entries and then jumps directly to the checkpoint, rather than parsing every entry from the start of the file.
+///
+/// The index is stored next to the log as a sidecar file (log_path + ".idx") and rebuilt if the log has changed (see MappedLogFile::matches()) or the registered filter hooks differ. Time based seeking requires version 3 (timestamped) files; for earlier versions seek() returns to the first entry.
+class LogIndex
+{
+  public:
+    static constexpr std::uint64_t default_checkpoint_bytes{1 << 20};
+
+    explicit LogIndex(std::uint64_t checkpoint_bytes = default_checkpoint_bytes)
+        : checkpoint_bytes_(checkpoint_bytes)
+    {
+    }
+
+    static std::string sidecar_path(const std::string& log_path) { return log_path + ".idx"; }
+
+    /// \brief Build the index by scanning the entry headers of a complete .goby file held in memory
+    ///
+    /// The plugins' read hooks (LogEntry::filter_hook) must be registered before calling this.
+    void build(const char* data, std::size_t size);
+    /// \brief Build the index of a mapped file, recording its modification time and fingerprint for load()
+    void build(const MappedLogFile& log);
+
+    /// \brief Load the sidecar index if it is valid for this file, otherwise build it (and write the sidecar if write_sidecar is true)
+    void load_or_build(const MappedLogFile& log, bool write_sidecar = true);
+
+    /// \brief Read the index from a file
+    /// \return true if the index was read and is valid for this log and the currently registered filter hooks
+    bool load(const std::string& path, const MappedLogFile& log);
+
+    /// \brief Write the index to a file
+    /// \throw LogException if the file cannot be written
+    void save(const std::string& path) const;
+
+    /// \brief Position the stream so that the next LogEntry::parse() returns a data entry no later than the first data entry with a timestamp at or after \c t
+    ///
+    /// Group and type indices (and filter hooks) needed to decode subsequent entries are replayed into LogEntry. The caller should discard entries with timestamps earlier than \c t.
+    void seek(std::istream& s, goby::time::SystemClock::time_point t) const;
+
+    const protobuf::LogIndex& index() const { return index_; }
+
+  private:
+    bool filters_match() const;
+
+  private:
+    std::uint64_t checkpoint_bytes_;
+    protobuf::LogIndex index_;
+};
+
+} // namespace log
+} // namespace middleware
+} // namespace goby
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef GOBY_MIDDLEWARE_LOG_LOG_PLUGIN_H
 #define GOBY_MIDDLEWARE_LOG_LOG_PLUGIN_H
 
+#include <fstream> // for ifstream, ofstream
+
 #include "goby/middleware/log/log_entry.h"
 #include "goby/middleware/marshalling/interface.h"
 #include "goby/middleware/marshalling/json.h"
@@ -46,6 +48,15 @@ class LogPlugin
     virtual void register_write_hooks(std::ofstream& out_log_file) = 0;
     virtual void register_read_hooks(const std::ifstream& in_log_file) = 0;
 
+    /// \brief Register read hooks for a log that is not read through a std::ifstream (e.g. MappedLogFile)
+    ///
+    /// The default implementation calls register_read_hooks(const std::ifstream&) with an unopened stream, which is sufficient for plugins that only register LogEntry hooks.
+    virtual void register_read_hooks(const std::istream& /*in_log_file*/)
+    {
+        std::ifstream unopened;
+        register_read_hooks(unopened);
+    }
+
     virtual std::string debug_text_message(LogEntry& log_entry)
     {
         throw(log::LogException("DEBUG_TEXT is not supported by the scheme's plugin"));
@@ -0,0 +1,312 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "log_reader.h"
+
+#include <algorithm> // for lower_bound, sort, is_sorted
+#include <chrono>    // for microseconds
+#include <fstream>   // for ifstream, ofstream
+#include <tuple>     // for tuple
+
+#include "goby/middleware/log/detail/log_scan.h"
+#include "goby/util/debug_logger/flex_ostream.h" // for glog
+
+using goby::glog;
+
+namespace
+{
+// microseconds since UNIX, with times before the epoch as zero
+std::uint64_t to_microseconds(goby::time::SystemClock::time_point t)
+{
+    auto us = t.time_since_epoch().count();
+    return us < 0 ? 0 : static_cast<std::uint64_t>(us);
+}
+} // namespace
+
+goby::middleware::log::LogReader::LogReader(std::string path, bool write_sidecar)
+    : log_(std::move(path)), scanner_(new detail::LogScanner(log_.data(), log_.size()))
+{
+    version_ = scanner_->version();
+
+    auto sidecar = sidecar_path(log_.path());
+    if (load(sidecar))
+    {
+        glog.is_debug1() && glog << "Using log entry index: " << sidecar << std::endl;
+        return;
+    }
+
+    build();
+
+    if (write_sidecar)
+    {
+        try
+        {
+            save(sidecar);
+        }
+        catch (LogException& e)
+        {
+            glog.is_warn() && glog << e.what() << std::endl;
+        }
+    }
+}
+
+goby::middleware::log::LogReader::~LogReader() = default;
+
+std::uint32_t goby::middleware::log::LogReader::add_channel(LogFilter filter)
+{
+    auto it = channel_index_.find(filter);
+    if (it != channel_index_.end())
+        return it->second;
+
+    std::uint32_t index = channels_.size();
+    channel_index_.insert(std::make_pair(filter, index));
+    channels_.emplace_back();
+    channels_.back().filter = std::move(filter);
+    return index;
+}
+
+void goby::middleware::log::LogReader::build()
+{
+    channels_.clear();
+    channel_index_.clear();
+
+    detail::LogScanner scanner(log_.data(), log_.size());
+    detail::LogTables tables(scanner.per_scheme_mapping());
+
+    // avoids looking up the names for every entry
+    std::map<std::tuple<std::uint16_t, std::uint16_t, std::uint16_t>, std::uint32_t>
+        raw_index_to_channel;
+
+    detail::RawLogEntry entry;
+    while (scanner.next(&entry))
+    {
+        if (tables.add(entry))
+        {
+            // the group or type mapping has changed
+            raw_index_to_channel.clear();
+            continue;
+        }
+
+        auto raw_index = std::make_tuple(entry.scheme, entry.group_index, entry.type_index);
+        auto raw_it = raw_index_to_channel.find(raw_index);
+        if (raw_it == raw_index_to_channel.end())
+        {
+            // same naming as LogEntry::parse() for entries without an index entry
+            const auto* group = tables.group(entry);
+            const auto* type = tables.type(entry);
+            LogFilter filter{entry.scheme,
+                             group ? *group : "_unknown" + std::to_string(entry.group_index) + "_",
+                             type ? *type : "_unknown" + std::to_string(entry.type_index) + "_"};
+            raw_it =
+                raw_index_to_channel.insert(std::make_pair(raw_index, add_channel(filter))).first;
+        }
+
+        auto& channel = channels_[raw_it->second];
+        if (!channel.timestamp.empty() && entry.timestamp < channel.timestamp.back())
+            channel.time_sorted = false;
+        channel.offset.push_back(entry.offset);
+        channel.timestamp.push_back(entry.timestamp);
+    }
+
+    glog.is_debug1() && glog << "Built log entry index of " << log_.path() << " with "
+                             << channels_.size() << " channels" << std::endl;
+}
+
+bool goby::middleware::log::LogReader::load(const std::string& path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    protobuf::LogEntryIndex index;
+    if (!index.ParseFromIstream(&in))
+    {
+        glog.is_warn() && glog << "Failed to parse log entry index: " << path << std::endl;
+        return false;
+    }
+
+    if (!log_.matches(index.log_size(), index.log_mtime(), index.log_fingerprint()) ||
+        index.version() != version_)
+        return false;
+
+    channels_.clear();
+    channel_index_.clear();
+    for (const auto& pb_channel : index.channel())
+    {
+        auto& channel = channels_[add_channel(
+            LogFilter{pb_channel.scheme(), pb_channel.group(), pb_channel.type()})];
+
+        bool has_timestamp = pb_channel.timestamp_delta_size() > 0;
+        if (has_timestamp && pb_channel.timestamp_delta_size() != pb_channel.offset_delta_size())
+            return false;
+
+        channel.offset.resize(pb_channel.offset_delta_size());
+        channel.timestamp.resize(pb_channel.offset_delta_size(), 0);
+        std::uint64_t offset = 0, timestamp = 0;
+        for (int i = 0, n = pb_channel.offset_delta_size(); i < n; ++i)
+        {
+            offset += pb_channel.offset_delta(i);
+            if (offset >= log_.size())
+                return false;
+            channel.offset[i] = offset;
+            if (has_timestamp)
+            {
+                timestamp += pb_channel.timestamp_delta(i);
+                channel.timestamp[i] = timestamp;
+            }
+        }
+        channel.time_sorted = std::is_sorted(channel.timestamp.begin(), channel.timestamp.end());
+    }
+    return true;
+}
+
+void goby::middleware::log::LogReader::save(const std::string& path) const
+{
+    protobuf::LogEntryIndex index;
+    index.set_log_size(log_.size());
+    index.set_version(version_);
+    index.set_log_mtime(log_.mtime());
+    index.set_log_fingerprint(log_.fingerprint());
+    for (const auto& channel : channels_)
+    {
+        auto& pb_channel = *index.add_channel();
+        pb_channel.set_scheme(channel.filter.scheme);
+        pb_channel.set_group(channel.filter.group);
+        pb_channel.set_type(channel.filter.type);
+
+        std::uint64_t offset = 0, timestamp = 0;
+        for (std::size_t i = 0, n = channel.offset.size(); i < n; ++i)
+        {
+            pb_channel.add_offset_delta(channel.offset[i] - offset);
+            offset = channel.offset[i];
+            if (scanner_->has_timestamp())
+            {
+                pb_channel.add_timestamp_delta(static_cast<std::int64_t>(channel.timestamp[i]) -
+                                               static_cast<std::int64_t>(timestamp));
+                timestamp = channel.timestamp[i];
+            }
+        }
+    }
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open() || !index.SerializeToOstream(&out))
+        throw(LogException("Failed to write log entry index: " + path));
+}
+
+std::vector<goby::middleware::log::LogFilter>
+goby::middleware::log::LogReader::channels() const
+{
+    std::vector<LogFilter> filters;
+    for (const auto& channel : channels_) filters.push_back(channel.filter);
+    return filters;
+}
+
+std::vector<goby::middleware::log::LogFilter>
+goby::middleware::log::LogReader::channels(const std::string& type) const
+{
+    std::vector<LogFilter> filters;
+    for (const auto& channel : channels_)
+    {
+        if (channel.filter.type == type)
+            filters.push_back(channel.filter);
+    }
+    return filters;
+}
+
+std::size_t goby::middleware::log::LogReader::count(const LogFilter& channel) const
+{
+    auto it = channel_index_.find(channel);
+    return it == channel_index_.end() ? 0 : channels_[it->second].offset.size();
+}
+
+goby::middleware::log::LogReader::Range
+goby::middleware::log::LogReader::entries(const std::vector<LogFilter>& channels,
+                                          time_point begin, time_point end) const
+{
+    auto positions = std::make_shared<std::vector<Position>>();
+    auto begin_us = to_microseconds(begin), end_us = to_microseconds(end);
+
+    int channels_found = 0;
+    for (const auto& filter : channels)
+    {
+        auto it = channel_index_.find(filter);
+        if (it == channel_index_.end())
+            continue;
+        ++channels_found;
+
+        const auto& channel = channels_[it->second];
+        const auto& timestamp = channel.timestamp;
+        if (channel.time_sorted)
+        {
+            auto first = std::lower_bound(timestamp.begin(), timestamp.end(), begin_us);
+            auto last = std::lower_bound(first, timestamp.end(), end_us);
+            for (auto i = first - timestamp.begin(), n = last - timestamp.begin(); i < n; ++i)
+                positions->push_back({channel.offset[i], it->second});
+        }
+        else
+        {
+            for (std::size_t i = 0, n = timestamp.size(); i < n; ++i)
+            {
+                if (timestamp[i] >= begin_us && timestamp[i] < end_us)
+                    positions->push_back({channel.offset[i], it->second});
+            }
+        }
+    }
+
+    // each channel is already in file order
+    if (channels_found > 1)
+        std::sort(positions->begin(), positions->end(),
+                  [](const Position& a, const Position& b) { return a.offset < b.offset; });
+
+    return Range(this, positions);
+}
+
+void goby::middleware::log::LogReader::apply_filter_hooks() const
+{
+    std::vector<LogFilter> filtered;
+    for (const auto& channel : channels_)
+    {
+        if (LogEntry::filter_hook.count(channel.filter))
+            filtered.push_back(channel.filter);
+    }
+
+    for (const auto& entry : entries(filtered))
+        LogEntry::filter_hook.at(LogFilter{entry.scheme(), entry.group().c_str(), entry.type()})(
+            entry.data());
+}
+
+goby::middleware::log::LogEntry
+goby::middleware::log::LogReader::read(const Position& position) const
+{
+    detail::RawLogEntry raw;
+    // checked again in case the log changed in a way the sidecar validation did not detect
+    if (!scanner_->read(position.offset, &raw))
+        throw(LogException("No valid entry at offset " + std::to_string(position.offset) +
+                           " of " + log_.path()));
+
+    const auto& filter = channels_[position.channel].filter;
+    const auto* data = reinterpret_cast<const unsigned char*>(raw.data);
+    return LogEntry(std::vector<unsigned char>(data, data + raw.data_size), filter.scheme,
+                    filter.type, DynamicGroup(filter.group),
+                    time_point(std::chrono::microseconds(raw.timestamp)));
+}
@@ -0,0 +1,222 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MIDDLEWARE_LOG_LOG_READER_H
+#define GOBY_MIDDLEWARE_LOG_LOG_READER_H
+
+#include <cstddef>  // for size_t, ptrdiff_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <iterator> // for input_iterator_tag
+#include <map>      // for map
+#include <memory>   // for shared_ptr, unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "goby/middleware/log/log_entry.h"
+#include "goby/middleware/log/log_index.h"
+#include "goby/middleware/protobuf/log_index.pb.h"
+#include "goby/time/system_clock.h"
+
+namespace goby
+{
+namespace middleware
+{
+namespace log
+{
+namespace detail
+{
+class LogScanner;
+} // namespace detail
+
+/// \brief Reentrant random access reader for .goby files, queried by (scheme, group, type) and time
+///
+/// LogEntry::parse() keeps the group and type tables in static members, so only one file can be read at a time in a process. Each LogReader has its own tables, so any number of files can be read concurrently. The const member functions may be called from multiple threads.
+///
+/// Entries are located using an index of the offset and timestamp of every entry for each (scheme, group, type) "channel". The index is stored next to the log as a sidecar file (log_path + ".entries.idx") and rebuilt if the log has changed (size, modification time, or the contents of its start or end). Range queries only use the index, so the data of entries that do not match are never read; the data of a matching entry are read when its iterator is dereferenced.
+///
+/// Time ranges are [begin, end). Files before version 3 have no timestamps, so all their entries have a timestamp of the UNIX epoch.
+class LogReader
+{
+  private:
+    struct Position
+    {
+        std::uint64_t offset;
+        std::uint32_t channel;
+    };
+
+  public:
+    using time_point = goby::time::SystemClock::time_point;
+
+    /// \brief Input iterator over the entries of a Range
+    class Iterator
+    {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = LogEntry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const LogEntry*;
+        using reference = const LogEntry&;
+
+        Iterator() = default;
+
+        /// \brief Read the current entry (its data are read from the file on first access)
+        reference operator*() const
+        {
+            if (!entry_)
+                entry_ = std::make_shared<LogEntry>(reader_->read((*positions_)[i_]));
+            return *entry_;
+        }
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++()
+        {
+            ++i_;
+            entry_.reset();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return positions_ == other.positions_ && i_ == other.i_;
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+        /// \brief Offset of the current entry within the file
+        std::uint64_t offset() const { return (*positions_)[i_].offset; }
+
+      private:
+        friend class LogReader;
+        Iterator(const LogReader* reader, std::shared_ptr<const std::vector<Position>> positions,
+                 std::size_t i)
+            : reader_(reader), positions_(std::move(positions)), i_(i)
+        {
+        }
+
+      private:
+        const LogReader* reader_{nullptr};
+        std::shared_ptr<const std::vector<Position>> positions_;
+        std::size_t i_{0};
+        mutable std::shared_ptr<LogEntry> entry_;
+    };
+
+    /// \brief Entries matching a query, in file order. Only valid while the LogReader that created it exists.
+    class Range
+    {
+      public:
+        Iterator begin() const { return Iterator(reader_, positions_, 0); }
+        Iterator end() const { return Iterator(reader_, positions_, positions_->size()); }
+        std::size_t size() const { return positions_->size(); }
+        bool empty() const { return positions_->empty(); }
+
+      private:
+        friend class LogReader;
+        Range(const LogReader* reader, std::shared_ptr<const std::vector<Position>> positions)
+            : reader_(reader), positions_(std::move(positions))
+        {
+        }
+
+      private:
+        const LogReader* reader_;
+        std::shared_ptr<const std::vector<Position>> positions_;
+    };
+
+    /// \brief Open a .goby file, loading its sidecar index if valid, otherwise building it (and writing the sidecar if write_sidecar is true)
+    /// \throw LogException if the file cannot be opened
+    explicit LogReader(std::string path, bool write_sidecar = true);
+    ~LogReader();
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    static std::string sidecar_path(const std::string& log_path)
+    {
+        return log_path + ".entries.idx";
+    }
+
+    /// \brief .goby file version
+    std::uint32_t version() const { return version_; }
+
+    /// \brief All the (scheme, group, type) channels that have at least one entry in the file
+    std::vector<LogFilter> channels() const;
+
+    /// \brief All the channels of a given type (for any scheme and group)
+    std::vector<LogFilter> channels(const std::string& type) const;
+
+    /// \brief Number of entries in a channel (0 if the channel is not in the file)
+    std::size_t count(const LogFilter& channel) const;
+
+    /// \brief Entries of one channel with timestamps in [begin, end)
+    Range entries(const LogFilter& channel, time_point begin = time_point::min(),
+                  time_point end = time_point::max()) const
+    {
+        return entries(std::vector<LogFilter>(1, channel), begin, end);
+    }
+
+    /// \brief Entries of any of the given channels with timestamps in [begin, end), in file order
+    Range entries(const std::vector<LogFilter>& channels, time_point begin = time_point::min(),
+                  time_point end = time_point::max()) const;
+
+    /// \brief Pass every entry consumed by a LogEntry::filter_hook (e.g. Protobuf file descriptors) to its hook, in file order
+    ///
+    /// This is required before the log plugins can decode the data of some schemes (e.g. Protobuf). As the hooks are static, this is not reentrant.
+    void apply_filter_hooks() const;
+
+    const MappedLogFile& log() const { return log_; }
+
+  private:
+    struct Channel
+    {
+        LogFilter filter;
+        std::vector<std::uint64_t> offset;
+        // microseconds since UNIX
+        std::vector<std::uint64_t> timestamp;
+        bool time_sorted{true};
+    };
+
+    void build();
+    bool load(const std::string& path);
+    void save(const std::string& path) const;
+    // returns the index of the (new or existing) channel in channels_
+    std::uint32_t add_channel(LogFilter filter);
+
+    LogEntry read(const Position& position) const;
+
+  private:
+    MappedLogFile log_;
+    std::unique_ptr<detail::LogScanner> scanner_;
+    std::uint32_t version_{0};
+    std::vector<Channel> channels_;
+    std::map<LogFilter, std::uint32_t> channel_index_;
+};
+
+} // namespace log
+} // namespace middleware
+} // namespace goby
+
+#endif
@@ -103,23 +103,13 @@ template <int scheme> class ProtobufPluginBase : public LogPlugin
         return j;
     }
 
-    void register_read_hooks(const std::ifstream& in_log_file) override
+    void register_read_hooks(const std::ifstream& /*in_log_file*/) override
     {
-        LogEntry::filter_hook[{static_cast<int>(scheme), static_cast<std::string>(file_desc_group),
-                               google::protobuf::FileDescriptorProto::descriptor()->full_name()}] =
-            [&](const std::vector<unsigned char>& data) {
-                google::protobuf::FileDescriptorProto file_desc_proto;
-                file_desc_proto.ParseFromArray(&data[0], data.size());
-
-                if (!read_file_desc_names_.count(file_desc_proto.name()))
-                {
-                    goby::glog.is_debug1() && goby::glog << "Adding: " << file_desc_proto.name()
-                                                         << std::endl;
-
-                    dccl::DynamicProtobufManager::add_protobuf_file(file_desc_proto);
-                    read_file_desc_names_.insert(file_desc_proto.name());
-                }
-            };
+        register_file_descriptor_hook();
+    }
+    void register_read_hooks(const std::istream& /*in_log_file*/) override
+    {
+        register_file_descriptor_hook();
     }
 
     void register_write_hooks(std::ofstream& out_log_file) override
@@ -156,6 +146,25 @@ template <int scheme> class ProtobufPluginBase : public LogPlugin
     }
 
   private:
+    void register_file_descriptor_hook()
+    {
+        LogEntry::filter_hook[{static_cast<int>(scheme), static_cast<std::string>(file_desc_group),
+                               google::protobuf::FileDescriptorProto::descriptor()->full_name()}] =
+            [&](const std::vector<unsigned char>& data) {
+                google::protobuf::FileDescriptorProto file_desc_proto;
+                file_desc_proto.ParseFromArray(&data[0], data.size());
+
+                if (!read_file_desc_names_.count(file_desc_proto.name()))
+                {
+                    goby::glog.is_debug1() && goby::glog << "Adding: " << file_desc_proto.name()
+                                                         << std::endl;
+
+                    dccl::DynamicProtobufManager::add_protobuf_file(file_desc_proto);
+                    read_file_desc_names_.insert(file_desc_proto.name());
+                }
+            };
+    }
+
     void insert_protobuf_file_desc(const google::protobuf::FileDescriptor* file_desc,
                                    std::ofstream& out_log_file)
     {
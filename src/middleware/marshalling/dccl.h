@@ -48,10 +48,10 @@ struct SerializerParserHelper<DataType, MarshallingScheme::DCCL>
     /// \brief Serialize message using DCCL encoding
     static std::vector<char> serialize(const DataType& msg)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        check_load<DataType>();
-        std::vector<char> bytes(codec().size(msg), 0);
-        codec().encode(bytes.data(), bytes.size(), msg);
+        CodecAccess codec;
+        codec.load(DataType::descriptor());
+        std::vector<char> bytes(codec->size(msg), 0);
+        codec->encode(bytes.data(), bytes.size(), msg);
         return bytes;
     }
 
@@ -75,10 +75,10 @@ struct SerializerParserHelper<DataType, MarshallingScheme::DCCL>
                                            CharIterator& actual_end,
                                            const std::string& type = type_name())
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        check_load<DataType>();
+        CodecAccess codec;
+        codec.load(DataType::descriptor());
         auto msg = std::make_shared<DataType>();
-        actual_end = codec().decode(bytes_begin, bytes_end, msg.get());
+        actual_end = codec->decode(bytes_begin, bytes_end, msg.get());
         return msg;
     }
 
@@ -93,9 +93,9 @@ struct SerializerParserHelper<DataType, MarshallingScheme::DCCL>
     /// \endcode
     static unsigned id()
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        check_load<DataType>();
-        return codec().template id<DataType>();
+        CodecAccess codec;
+        codec.load(DataType::descriptor());
+        return codec->template id<DataType>();
     }
 
     static unsigned id(const google::protobuf::Message& d) { return id(); }
@@ -112,10 +112,10 @@ struct SerializerParserHelper<google::protobuf::Message, MarshallingScheme::DCCL
     /// Serialize DCCL/Protobuf message (using DCCL encoding)
     static std::vector<char> serialize(const google::protobuf::Message& msg)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        check_load(msg.GetDescriptor());
-        std::vector<char> bytes(codec().size(msg), 0);
-        codec().encode(bytes.data(), bytes.size(), msg);
+        CodecAccess codec;
+        codec.load(msg.GetDescriptor());
+        std::vector<char> bytes(codec->size(msg), 0);
+        codec->encode(bytes.data(), bytes.size(), msg);
         return bytes;
     }
 
@@ -147,22 +147,26 @@ struct SerializerParserHelper<google::protobuf::Message, MarshallingScheme::DCCL
     parse(CharIterator bytes_begin, CharIterator bytes_end, CharIterator& actual_end,
           const std::string& type, bool user_pool_first = false)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
+        CodecAccess codec;
 
-        auto msg = dccl::DynamicProtobufManager::new_protobuf_message<
-            std::shared_ptr<google::protobuf::Message>>(type, user_pool_first);
+        std::shared_ptr<google::protobuf::Message> msg;
+        {
+            auto lock = codec.lock_manager();
+            msg = dccl::DynamicProtobufManager::new_protobuf_message<
+                std::shared_ptr<google::protobuf::Message>>(type, user_pool_first);
+        }
 
-        check_load(msg->GetDescriptor());
-        actual_end = codec().decode(bytes_begin, bytes_end, msg.get());
+        codec.load(msg->GetDescriptor());
+        actual_end = codec->decode(bytes_begin, bytes_end, msg.get());
         return msg;
     }
 
     /// \brief Returns the DCCL ID given a Protobuf Descriptor
     static unsigned id(const google::protobuf::Descriptor* desc)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        check_load(desc);
-        return codec().id(desc);
+        CodecAccess codec;
+        codec.load(desc);
+        return codec->id(desc);
     }
 
     /// \brief Returns the DCCL ID given an instantiated message
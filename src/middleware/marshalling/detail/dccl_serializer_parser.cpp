@@ -21,8 +21,9 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <list> // for oper...
-#include <map>  // for map
+#include <algorithm> // for find
+#include <list>      // for oper...
+#include <map>       // for map
 
 #include <dccl/logger.h>                   // for Logger
 #include <google/protobuf/descriptor.pb.h> // for File...
@@ -53,15 +54,103 @@ std::unordered_map<
 std::mutex goby::middleware::detail::DCCLSerializerParserHelperBase::dccl_mutex_;
 std::set<std::string> goby::middleware::detail::DCCLSerializerParserHelperBase::loaded_proto_files_;
 
+goby::middleware::detail::DCCLSerializerParserHelperBase::CodecMode
+    goby::middleware::detail::DCCLSerializerParserHelperBase::codec_mode_(CodecMode::SHARED);
+thread_local std::unique_ptr<
+    goby::middleware::detail::DCCLSerializerParserHelperBase::ThreadCodec>
+    goby::middleware::detail::DCCLSerializerParserHelperBase::thread_codec_;
+std::vector<std::string>
+    goby::middleware::detail::DCCLSerializerParserHelperBase::registry_libraries_;
+std::vector<const google::protobuf::Descriptor*>
+    goby::middleware::detail::DCCLSerializerParserHelperBase::registry_descriptors_;
+std::atomic<std::uint64_t>
+    goby::middleware::detail::DCCLSerializerParserHelperBase::registry_generation_(0);
+
+goby::middleware::detail::DCCLSerializerParserHelperBase::ThreadCodec&
+goby::middleware::detail::DCCLSerializerParserHelperBase::thread_codec(bool have_lock)
+{
+    if (!thread_codec_)
+        thread_codec_.reset(new ThreadCodec);
+
+    ThreadCodec& tc = *thread_codec_;
+
+    // catch up with libraries and types loaded by other threads
+    if (tc.generation != registry_generation_.load())
+    {
+        std::unique_lock<std::mutex> lock(dccl_mutex_, std::defer_lock);
+        if (!have_lock)
+            lock.lock();
+
+        for (; tc.libraries_loaded < registry_libraries_.size(); ++tc.libraries_loaded)
+            tc.codec.load_library(registry_libraries_[tc.libraries_loaded]);
+
+        for (; tc.registry_loaded < registry_descriptors_.size(); ++tc.registry_loaded)
+        {
+            const auto* desc = registry_descriptors_[tc.registry_loaded];
+            if (!tc.loaded.count(desc))
+            {
+                tc.codec.load(desc);
+                tc.loaded.insert(desc);
+            }
+        }
+        tc.generation = registry_generation_.load();
+    }
+    return tc;
+}
+
+void goby::middleware::detail::DCCLSerializerParserHelperBase::thread_check_load(
+    ThreadCodec& tc, const google::protobuf::Descriptor* desc, bool have_lock)
+{
+    if (tc.loaded.count(desc))
+        return;
+
+    // load here first so that invalid types throw to the caller rather than in another thread
+    tc.codec.load(desc);
+    tc.loaded.insert(desc);
+
+    std::unique_lock<std::mutex> lock(dccl_mutex_, std::defer_lock);
+    if (!have_lock)
+        lock.lock();
+
+    if (std::find(registry_descriptors_.begin(), registry_descriptors_.end(), desc) ==
+        registry_descriptors_.end())
+    {
+        registry_descriptors_.push_back(desc);
+        ++registry_generation_;
+    }
+}
+
+void goby::middleware::detail::DCCLSerializerParserHelperBase::load_library(
+    const std::string& library)
+{
+    std::lock_guard<std::mutex> lock(dccl_mutex_);
+    if (codec_mode_ == CodecMode::SHARED)
+    {
+        codec().load_library(library);
+    }
+    else
+    {
+        registry_libraries_.push_back(library);
+        ++registry_generation_;
+    }
+}
+
 void goby::middleware::detail::DCCLSerializerParserHelperBase::load_metadata(
     const goby::middleware::protobuf::SerializerProtobufMetadata& meta)
 {
     std::lock_guard<std::mutex> lock(dccl_mutex_);
 
+    auto load = [](const google::protobuf::Descriptor* desc) {
+        if (codec_mode_ == CodecMode::SHARED)
+            check_load(desc);
+        else
+            thread_check_load(thread_codec(true), desc, true);
+    };
+
     // check that we don't already have this type available
     if (auto* desc = dccl::DynamicProtobufManager::find_descriptor(meta.protobuf_name()))
     {
-        check_load(desc);
+        load(desc);
     }
     else
     {
@@ -75,7 +164,7 @@ void goby::middleware::detail::DCCLSerializerParserHelperBase::load_metadata(
         }
 
         if (auto* desc = dccl::DynamicProtobufManager::find_descriptor(meta.protobuf_name()))
-            check_load(desc);
+            load(desc);
         else
             goby::glog.is(goby::util::logger::DEBUG3) &&
                 goby::glog << "Failed to load DCCL message via metadata: " << meta.protobuf_name()
@@ -86,21 +175,21 @@ void goby::middleware::detail::DCCLSerializerParserHelperBase::load_metadata(
 goby::middleware::intervehicle::protobuf::DCCLForwardedData
 goby::middleware::detail::DCCLSerializerParserHelperBase::unpack(const std::string& frame)
 {
-    std::lock_guard<std::mutex> lock(dccl_mutex_);
+    CodecAccess codec;
 
     goby::middleware::intervehicle::protobuf::DCCLForwardedData packets;
 
     std::string::const_iterator frame_it = frame.begin(), frame_end = frame.end();
     while (frame_it < frame_end)
     {
-        auto dccl_id = codec().id(frame_it, frame_end);
+        auto dccl_id = codec->id(frame_it, frame_end);
 
         goby::middleware::intervehicle::protobuf::DCCLPacket& packet = *packets.add_frame();
         packet.set_dccl_id(dccl_id);
 
         std::string::const_iterator next_frame_it;
 
-        if (codec().loaded().count(dccl_id) == INVALID_DCCL_ID)
+        if (codec->loaded().count(dccl_id) == INVALID_DCCL_ID)
         {
             goby::glog.is_debug1() &&
                 goby::glog << "DCCL ID " << dccl_id
@@ -109,11 +198,15 @@ goby::middleware::detail::DCCLSerializerParserHelperBase::unpack(const std::stri
             return packets;
         }
 
-        const auto* desc = codec().loaded().at(dccl_id);
-        auto msg = dccl::DynamicProtobufManager::new_protobuf_message<
-            std::unique_ptr<google::protobuf::Message>>(desc);
+        const auto* desc = codec->loaded().at(dccl_id);
+        std::unique_ptr<google::protobuf::Message> msg;
+        {
+            auto lock = codec.lock_manager();
+            msg = dccl::DynamicProtobufManager::new_protobuf_message<
+                std::unique_ptr<google::protobuf::Message>>(desc);
+        }
 
-        next_frame_it = codec().decode(frame_it, frame_end, msg.get());
+        next_frame_it = codec->decode(frame_it, frame_end, msg.get());
         packet.set_data(std::string(frame_it, next_frame_it));
 
         frame_it = next_frame_it;
@@ -24,6 +24,8 @@
 #ifndef GOBY_MIDDLEWARE_MARSHALLING_DETAIL_DCCL_SERIALIZER_PARSER_H
 #define GOBY_MIDDLEWARE_MARSHALLING_DETAIL_DCCL_SERIALIZER_PARSER_H
 
+#include <atomic>        // for atomic
+#include <cstdint>       // for uint64_t
 #include <memory>        // for unique_ptr
 #include <mutex>         // for mutex, lock_guard
 #include <ostream>       // for basic_ostream
@@ -31,6 +33,7 @@
 #include <string>        // for string, operat...
 #include <unordered_map> // for unordered_map
 #include <utility>       // for pair, make_pair
+#include <vector>        // for vector
 
 #include <dccl/codec.h>                    // for Codec
 #include <dccl/dynamic_protobuf_manager.h> // for DynamicProtobu...
@@ -58,14 +61,94 @@ class SerializerProtobufMetadata;
 namespace detail
 {
 /// \brief Wraps a dccl::Codec in a thread-safe way to make it usable by SerializerParserHelper
+///
+/// By default (CodecMode::SHARED) all threads share one dccl::Codec guarded by a mutex. With CodecMode::THREAD_LOCAL each thread encodes and decodes with its own dccl::Codec, so threads don't contend with each other. Message types and codec libraries loaded from any thread are recorded and loaded into every other thread's codec before its next use.
 struct DCCLSerializerParserHelperBase
 {
+  public:
+    enum class CodecMode
+    {
+        SHARED,
+        THREAD_LOCAL
+    };
+
+    /// \brief Select how codecs are shared between threads. Must be called before any DCCL encoding or decoding (goby::run() sets this from AppConfig::dccl).
+    static void set_codec_mode(CodecMode mode) { codec_mode_ = mode; }
+    static CodecMode codec_mode() { return codec_mode_; }
+
   private:
     static std::unique_ptr<dccl::Codec> codec_;
+    static CodecMode codec_mode_;
+
+    // codec and loaded types for one thread (THREAD_LOCAL mode)
+    struct ThreadCodec
+    {
+        dccl::Codec codec;
+        std::set<const google::protobuf::Descriptor*> loaded;
+        std::size_t libraries_loaded{0};
+        std::size_t registry_loaded{0};
+        std::uint64_t generation{0};
+    };
+    static thread_local std::unique_ptr<ThreadCodec> thread_codec_;
+
+    // libraries and types loaded into the thread codecs (protected by dccl_mutex_), replayed
+    // into each thread's codec when registry_generation_ changes
+    static std::vector<std::string> registry_libraries_;
+    static std::vector<const google::protobuf::Descriptor*> registry_descriptors_;
+    static std::atomic<std::uint64_t> registry_generation_;
+
+    static ThreadCodec& thread_codec(bool have_lock = false);
+    static void thread_check_load(ThreadCodec& tc, const google::protobuf::Descriptor* desc,
+                                  bool have_lock);
 
   protected:
     static std::mutex dccl_mutex_;
 
+    /// \brief Access to the codec for the calling thread: holds dccl_mutex_ for the lifetime of this object in SHARED mode, and no lock in THREAD_LOCAL mode
+    class CodecAccess
+    {
+      public:
+        CodecAccess()
+        {
+            if (codec_mode_ == CodecMode::SHARED)
+            {
+                lock_ = std::unique_lock<std::mutex>(dccl_mutex_);
+                codec_ = &DCCLSerializerParserHelperBase::codec();
+            }
+            else
+            {
+                thread_codec_ptr_ = &thread_codec();
+                codec_ = &thread_codec_ptr_->codec;
+            }
+        }
+
+        dccl::Codec& operator*() { return *codec_; }
+        dccl::Codec* operator->() { return codec_; }
+
+        /// \brief Load the type into this codec if it isn't already
+        void load(const google::protobuf::Descriptor* desc)
+        {
+            if (thread_codec_ptr_)
+                thread_check_load(*thread_codec_ptr_, desc, false);
+            else
+                check_load(desc);
+        }
+
+        /// \brief Lock required to use dccl::DynamicProtobufManager (already held in SHARED mode)
+        std::unique_lock<std::mutex> lock_manager()
+        {
+            if (lock_)
+                return std::unique_lock<std::mutex>();
+            else
+                return std::unique_lock<std::mutex>(dccl_mutex_);
+        }
+
+      private:
+        std::unique_lock<std::mutex> lock_;
+        dccl::Codec* codec_{nullptr};
+        ThreadCodec* thread_codec_ptr_{nullptr};
+    };
+
     struct LoaderBase
     {
         LoaderBase() = default;
@@ -111,6 +194,7 @@ struct DCCLSerializerParserHelperBase
     }
 
 
+    /// \brief The shared codec (used in SHARED mode)
     static dccl::Codec& codec()
     {
         if (!codec_)
@@ -118,6 +202,7 @@ struct DCCLSerializerParserHelperBase
         return *codec_;
     }
 
+    /// \brief Replace the shared codec (THREAD_LOCAL mode codecs are always default constructed)
     static dccl::Codec& set_codec(dccl::Codec* new_codec)
     {
         codec_.reset(new_codec);
@@ -133,17 +218,22 @@ struct DCCLSerializerParserHelperBase
 
     template <typename CharIterator> static unsigned id(CharIterator begin, CharIterator end)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        return codec().id(begin, end);
+        CodecAccess codec;
+        return codec->id(begin, end);
     }
 
     static unsigned id(const std::string& full_name)
     {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        auto* desc = dccl::DynamicProtobufManager::find_descriptor(full_name);
+        CodecAccess codec;
+        const google::protobuf::Descriptor* desc = nullptr;
+        {
+            auto lock = codec.lock_manager();
+            desc = dccl::DynamicProtobufManager::find_descriptor(full_name);
+        }
+
         if (desc)
         {
-            return codec().id(desc);
+            return codec->id(desc);
         }
         else
         {
@@ -157,11 +247,7 @@ struct DCCLSerializerParserHelperBase
     static goby::middleware::intervehicle::protobuf::DCCLForwardedData
     unpack(const std::string& bytes);
 
-    static void load_library(const std::string& library)
-    {
-        std::lock_guard<std::mutex> lock(dccl_mutex_);
-        codec().load_library(library);
-    }
+    static void load_library(const std::string& library);
 
     /// \brief Enable dlog output to glog using same verbosity settings as glog.
     static void setup_dlog();
@@ -22,7 +22,8 @@ protobuf_generate_cpp(MIDDLEWARE_PROTO_SRCS MIDDLEWARE_PROTO_HDRS
   middleware/protobuf/intermodule.proto
   middleware/protobuf/pty_config.proto
   middleware/protobuf/navigation.proto
-  middleware/protobuf/logger.proto 
+  middleware/protobuf/logger.proto
+  middleware/protobuf/log_index.proto
   )
 
 set(MIDDLEWARE_SRC
@@ -32,6 +33,8 @@ set(MIDDLEWARE_SRC
   middleware/transport/intervehicle/driver_thread.cpp
   middleware/application/configuration_reader.cpp
   middleware/log/log_entry.cpp
+  middleware/log/log_index.cpp
+  middleware/log/log_reader.cpp
   middleware/frontseat/interface.cpp
   middleware/coroner/coroner.cpp
   ${MIDDLEWARE_PROTO_SRCS} ${MIDDLEWARE_PROTO_HDRS} 
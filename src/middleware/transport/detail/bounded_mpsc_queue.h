@@ -0,0 +1,148 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MIDDLEWARE_TRANSPORT_DETAIL_BOUNDED_MPSC_QUEUE_H
+#define GOBY_MIDDLEWARE_TRANSPORT_DETAIL_BOUNDED_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace goby
+{
+namespace middleware
+{
+namespace detail
+{
+/// \brief Bounded lock-free multiple producer, single consumer queue (ring buffer).
+///
+/// Based on Dmitry Vyukov's bounded MPMC queue, simplified for a single consumer. Each cell carries a sequence number that tells producers and the consumer whether the cell is free or full for the current lap around the ring, so no locks are required for push() or pop().
+///
+/// The cell sequence publication (push) and observation (pop) are sequentially consistent, so callers may pair them with another sequentially consistent flag to build a lost-wakeup free sleep/notify handshake (see InterThreadTransporter).
+///
+/// \tparam T value type (must be default constructible and move assignable)
+template <typename T> class BoundedMPSCQueue
+{
+  public:
+    /// \brief Construct the queue
+    ///
+    /// \param capacity Maximum number of elements held at once. Rounded up to the next power of two (minimum 2)
+    explicit BoundedMPSCQueue(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1), cells_(new Cell[capacity_])
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMPSCQueue(const BoundedMPSCQueue&) = delete;
+    BoundedMPSCQueue& operator=(const BoundedMPSCQueue&) = delete;
+
+    /// \brief Add a value to the queue (safe to call from any number of threads)
+    ///
+    /// \return true if the value was enqueued, false if the queue was full (value is not modified)
+    bool push(T&& value)
+    {
+        Cell* cell;
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // consumer hasn't freed this cell yet
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    /// \brief Remove the oldest value from the queue (only call from the single consumer thread)
+    ///
+    /// \return true if a value was written to \c value, false if the queue was empty
+    bool pop(T& value)
+    {
+        Cell* cell = &cells_[dequeue_pos_ & mask_];
+        std::size_t seq = cell->sequence.load(std::memory_order_seq_cst);
+        if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(dequeue_pos_ + 1) < 0)
+            return false;
+
+        value = std::move(cell->value);
+        // release any resources held by the moved-from value before handing the cell back
+        cell->value = T();
+        cell->sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+    /// \brief Number of elements this queue can hold
+    std::size_t capacity() const { return capacity_; }
+
+    /// \brief Number of push() calls that failed since the queue was created
+    std::size_t overflow_count() const { return overflow_count_.load(std::memory_order_relaxed); }
+
+    /// \brief Record a failed push (called by the producer that was rejected)
+    void increment_overflow() { overflow_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  private:
+    static std::size_t round_up_pow2(std::size_t n)
+    {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    std::atomic<std::size_t> enqueue_pos_{0};
+    std::size_t dequeue_pos_{0};
+    std::atomic<std::size_t> overflow_count_{0};
+};
+
+} // namespace detail
+} // namespace middleware
+} // namespace goby
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef GOBY_MIDDLEWARE_TRANSPORT_DETAIL_SUBSCRIPTION_STORE_H
 #define GOBY_MIDDLEWARE_TRANSPORT_DETAIL_SUBSCRIPTION_STORE_H
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <memory>
@@ -35,7 +37,11 @@
 #include <unordered_map>
 #include <vector>
 
+#include "goby/middleware/transport/detail/bounded_mpsc_queue.h"
+#include "goby/middleware/transport/poller_wakeup.h"
 #include "goby/middleware/transport/publisher.h"
+#include "goby/middleware/transport/subscriber.h"
+#include "goby/util/debug_logger.h"
 
 namespace goby
 {
@@ -113,31 +119,47 @@ class SubscriptionStoreBase
 struct DataProtection
 {
     DataProtection(std::shared_ptr<std::mutex> dm, std::shared_ptr<std::condition_variable_any> pcv,
-                   std::shared_ptr<std::timed_mutex> pm)
-        : data_mutex(dm), poller_cv(pcv), poller_mutex(pm)
+                   std::shared_ptr<std::timed_mutex> pm,
+                   std::shared_ptr<std::atomic<bool>> pa = nullptr,
+                   std::shared_ptr<PollerWakeupSlot> pw = nullptr)
+        : data_mutex(dm), poller_cv(pcv), poller_mutex(pm), poller_armed(pa), poller_wakeup(pw)
     {
     }
 
     std::shared_ptr<std::mutex> data_mutex;
     std::shared_ptr<std::condition_variable_any> poller_cv;
     std::shared_ptr<std::timed_mutex> poller_mutex;
+    // only set for threads using lock-free mailboxes: true when the poller may be about to wait on poller_cv (so a publisher must notify it)
+    std::shared_ptr<std::atomic<bool>> poller_armed;
+    // for threads that wait on something other than poller_cv (see PollerInterface::set_wakeup)
+    std::shared_ptr<PollerWakeupSlot> poller_wakeup;
 };
 
 /// \brief Storage class for a specific interthread subscription (and related data). Used by InterThreadTransporter
 template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
 {
   public:
+    /// \brief Add a subscription for a given thread
+    ///
+    /// \param ring_capacity If non-zero, this thread's data are queued in lock-free ring buffers of this capacity (one per Group) rather than in mutex protected vectors. Only used for the first subscription of this Data type from a given thread.
+    /// \param poller_armed Wakeup flag for threads using lock-free mailboxes (see DataProtection)
+    /// \param poller_wakeup Additional wakeup for this thread (see PollerInterface::set_wakeup)
+    /// \param subscriber Subscriber for this subscription: if subscriber.cfg().queue_depth() is set, only the newest queue_depth data are passed to func on each poll, and the rest are counted in subscriber.dropped()
     static void subscribe(std::function<void(std::shared_ptr<const Data>)> func, const Group& group,
                           std::thread::id thread_id, std::shared_ptr<std::mutex> data_mutex,
                           std::shared_ptr<std::condition_variable_any> cv,
-                          std::shared_ptr<std::timed_mutex> poller_mutex)
+                          std::shared_ptr<std::timed_mutex> poller_mutex,
+                          std::size_t ring_capacity = 0,
+                          std::shared_ptr<std::atomic<bool>> poller_armed = nullptr,
+                          std::shared_ptr<PollerWakeupSlot> poller_wakeup = nullptr,
+                          const Subscriber<Data>& subscriber = Subscriber<Data>::default_instance())
     {
         {
             std::lock_guard<std::shared_timed_mutex> lock(subscription_mutex_);
 
             // insert callback
-            auto it =
-                subscription_callbacks_.insert(std::make_pair(thread_id, Callback(group, func)));
+            auto it = subscription_callbacks_.insert(
+                std::make_pair(thread_id, Callback(group, func, subscriber)));
             // insert group with iterator to callback
             subscription_groups_.insert(std::make_pair(group, it));
 
@@ -145,15 +167,18 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
             auto queue_it = data_.find(thread_id);
             if (queue_it == data_.end())
             {
-                auto bool_it_pair = data_.insert(std::make_pair(thread_id, DataQueue()));
+                auto bool_it_pair =
+                    data_.insert(std::make_pair(thread_id, DataQueue(ring_capacity)));
                 queue_it = bool_it_pair.first;
             }
-            queue_it->second.create(group);
+            queue_it->second.create(group, subscriber.cfg().queue_depth());
 
             // if we don't have a condition variable already for this thread, store it
             if (!data_protection_.count(thread_id))
                 data_protection_.insert(std::make_pair(
-                    thread_id, detail::DataProtection(data_mutex, cv, poller_mutex)));
+                    thread_id,
+                    detail::DataProtection(data_mutex, cv, poller_mutex, poller_armed,
+                                           poller_wakeup)));
         }
 
         // try inserting a copy of this templated class via the base class for SubscriptionStoreBase::poll_all to use
@@ -197,19 +222,36 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
         {
             std::shared_lock<std::shared_timed_mutex> lock(subscription_mutex_);
 
+            // a thread's mailbox is shared by all its subscriptions to this group, so only store
+            // one copy per thread (poll() passes it to each subscription)
+            std::vector<std::thread::id> threads_stored;
             auto range = subscription_groups_.equal_range(group);
             for (auto it = range.first; it != range.second; ++it)
             {
                 std::thread::id thread_id = it->second->first;
+                if (std::find(threads_stored.begin(), threads_stored.end(), thread_id) !=
+                    threads_stored.end())
+                    continue;
+                threads_stored.push_back(thread_id);
 
                 // don't store a copy if publisher == subscriber, and echo is false
                 if (thread_id != std::this_thread::get_id() || publisher.cfg().echo())
                 {
-                    // protect the DataQueue we are writing to
-                    std::unique_lock<std::mutex> lock(*(data_protection_.at(thread_id).data_mutex));
+                    const auto& data_protection = data_protection_.at(thread_id);
                     auto queue_it = data_.find(thread_id);
-                    queue_it->second.insert(group, data);
-                    cv_to_notify.push_back(data_protection_.at(thread_id));
+                    if (queue_it->second.lock_free())
+                    {
+                        // ring buffers are safe for concurrent publishers without the data mutex
+                        if (!queue_it->second.insert(group, data))
+                            report_overflow(group, queue_it->second.overflow_count(group));
+                    }
+                    else
+                    {
+                        // protect the DataQueue we are writing to
+                        std::unique_lock<std::mutex> lock(*data_protection.data_mutex);
+                        queue_it->second.insert(group, data);
+                    }
+                    cv_to_notify.push_back(data_protection);
                 }
             }
         }
@@ -217,6 +259,19 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
         // unlock and notify condition variables from local vector
         for (const auto& data_protection : cv_to_notify)
         {
+            // the thread may be waiting on its wakeup rather than in poll(), so poller_armed
+            // doesn't apply
+            if (data_protection.poller_wakeup)
+                data_protection.poller_wakeup->notify();
+
+            if (data_protection.poller_armed)
+            {
+                // the ring buffer push and this exchange are both sequentially consistent (as are the poller's arming and ring buffer reads), so either the poller sees our data or we see it armed
+                // if not armed, the poller is busy and will check its mailboxes again before waiting, or another publisher is already notifying it
+                if (!data_protection.poller_armed->exchange(false, std::memory_order_seq_cst))
+                    continue;
+            }
+
             {
                 // lock to ensure the other thread isn't in the limbo region
                 // between _poll_all() and wait(), where the condition variable
@@ -244,14 +299,19 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
             if (queue_it == data_.end())
                 return 0; // no subscriptions
 
+            // lock-free mailboxes are drained without the data mutex (we are the only consumer)
             std::unique_lock<std::mutex> data_lock(
-                *(data_protection_.find(thread_id)->second.data_mutex));
+                *(data_protection_.find(thread_id)->second.data_mutex), std::defer_lock);
+            if (!queue_it->second.lock_free())
+                data_lock.lock();
 
             // loop over all Groups stored in this DataQueue
-            for (auto data_it = queue_it->second.cbegin(), end = queue_it->second.cend();
+            for (auto data_it = queue_it->second.begin(), end = queue_it->second.end();
                  data_it != end; ++data_it)
             {
                 const Group& group = data_it->first;
+                const auto& pending = queue_it->second.pending(data_it);
+                auto received = queue_it->second.received(data_it);
                 auto group_range = subscription_groups_.equal_range(group);
                 // For a given Group, loop over all subscriptions to this Group
                 for (auto group_it = group_range.first; group_it != group_range.second; ++group_it)
@@ -259,18 +319,26 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
                     if (group_it->second->first != thread_id)
                         continue;
 
+                    // only the newest queue_depth elements (if set)
+                    const Callback& callback = group_it->second->second;
+                    auto first = pending.begin();
+                    if (callback.queue_depth > 0 && pending.size() > callback.queue_depth)
+                        first = pending.end() - callback.queue_depth;
+                    std::size_t delivered = pending.end() - first;
+                    if (received > delivered)
+                        callback.subscriber.add_dropped(received - delivered);
+
                     // store the callback function and datum for all the elements queued
-                    for (auto& datum : data_it->second)
+                    for (auto datum_it = first; datum_it != pending.end(); ++datum_it)
                     {
                         ++poll_items_count;
                         // we have data, no need to keep this lock any longer
                         if (lock)
                             lock.reset();
-                        data_callbacks.push_back(
-                            std::make_pair(group_it->second->second.callback, datum));
+                        data_callbacks.push_back(std::make_pair(callback.callback, *datum_it));
                     }
                 }
-                queue_it->second.clear(group);
+                queue_it->second.clear(data_it);
             }
         }
 
@@ -310,38 +378,134 @@ template <typename Data> class SubscriptionStore : public SubscriptionStoreBase
     struct Callback
     {
         using CallbackType = std::function<void(std::shared_ptr<const Data>)>;
-        Callback(const Group& g, const std::function<void(std::shared_ptr<const Data>)>& c)
-            : group(g), callback(new CallbackType(c))
+        Callback(const Group& g, const std::function<void(std::shared_ptr<const Data>)>& c,
+                 const Subscriber<Data>& s)
+            : group(g),
+              callback(new CallbackType(c)),
+              subscriber(s),
+              queue_depth(s.cfg().queue_depth())
         {
         }
         Group group;
         std::shared_ptr<CallbackType> callback;
+        Subscriber<Data> subscriber;
+        std::size_t queue_depth;
     };
 
     class DataQueue
     {
       private:
-        std::unordered_map<Group, std::vector<std::shared_ptr<const Data>>> data_;
+        using Ring = BoundedMPSCQueue<std::shared_ptr<const Data>>;
+        struct Mailbox
+        {
+            // for mutex queues, all pending data (protected by the DataProtection::data_mutex)
+            // for lock-free queues, data drained from the ring (only touched by the subscribing thread)
+            std::vector<std::shared_ptr<const Data>> queue;
+            std::unique_ptr<Ring> ring;
+            // largest queue_depth of the subscriptions (0 if any are unlimited)
+            std::size_t depth{0};
+            // number of data added since the last clear(), including those trimmed from queue
+            std::size_t received{0};
+        };
+        std::unordered_map<Group, Mailbox> data_;
+        std::size_t ring_capacity_;
 
       public:
-        void create(const Group& g)
+        explicit DataQueue(std::size_t ring_capacity = 0) : ring_capacity_(ring_capacity) {}
+
+        bool lock_free() const { return ring_capacity_ > 0; }
+
+        void create(const Group& g, std::size_t depth)
         {
             auto it = data_.find(g);
             if (it == data_.end())
-                data_.insert(std::make_pair(g, std::vector<std::shared_ptr<const Data>>()));
+            {
+                Mailbox mailbox;
+                if (lock_free())
+                    mailbox.ring.reset(new Ring(ring_capacity_));
+                mailbox.depth = depth;
+                data_.insert(std::make_pair(g, std::move(mailbox)));
+            }
+            else
+            {
+                auto& mailbox = it->second;
+                mailbox.depth =
+                    (mailbox.depth == 0 || depth == 0) ? 0 : std::max(mailbox.depth, depth);
+            }
         }
         void remove(const Group& g) { data_.erase(g); }
 
-        void insert(const Group& g, std::shared_ptr<const Data> datum)
+        // returns false if the datum was dropped because the ring is full
+        bool insert(const Group& g, std::shared_ptr<const Data> datum)
+        {
+            auto& mailbox = data_.find(g)->second;
+            if (mailbox.ring)
+            {
+                if (mailbox.ring->push(std::move(datum)))
+                    return true;
+                mailbox.ring->increment_overflow();
+                return false;
+            }
+            else
+            {
+                mailbox.queue.push_back(datum);
+                ++mailbox.received;
+                // trim in bulk so insertion is amortized constant time
+                // (poll() only passes on the newest anyway)
+                if (mailbox.depth > 0 && mailbox.queue.size() >= 2 * mailbox.depth)
+                    mailbox.queue.erase(mailbox.queue.begin(),
+                                        mailbox.queue.end() - mailbox.depth);
+                return true;
+            }
+        }
+
+        std::size_t overflow_count(const Group& g)
+        {
+            auto& mailbox = data_.find(g)->second;
+            return mailbox.ring ? mailbox.ring->overflow_count() : 0;
+        }
+
+        using iterator = typename decltype(data_)::iterator;
+
+        // data waiting for the subscriber (only call from the subscribing thread)
+        const std::vector<std::shared_ptr<const Data>>& pending(iterator it)
         {
-            data_.find(g)->second.push_back(datum);
+            auto& mailbox = it->second;
+            if (mailbox.ring)
+            {
+                std::shared_ptr<const Data> datum;
+                while (mailbox.ring->pop(datum))
+                {
+                    mailbox.queue.push_back(std::move(datum));
+                    ++mailbox.received;
+                }
+            }
+            return mailbox.queue;
+        }
+        std::size_t received(iterator it) { return it->second.received; }
+        void clear(iterator it)
+        {
+            it->second.queue.clear();
+            it->second.received = 0;
         }
-        void clear(const Group& g) { data_.find(g)->second.clear(); }
         bool empty() { return data_.empty(); }
-        typename decltype(data_)::const_iterator cbegin() { return data_.begin(); }
-        typename decltype(data_)::const_iterator cend() { return data_.end(); }
+        iterator begin() { return data_.begin(); }
+        iterator end() { return data_.end(); }
     };
 
+    static void report_overflow(const Group& group, std::size_t overflow_count)
+    {
+        // report on powers of two to avoid flooding the log from a runaway publisher
+        if (overflow_count & (overflow_count - 1))
+            return;
+
+        goby::glog.is_warn() &&
+            goby::glog << "InterThreadTransporter: lock-free mailbox full for group \"" << group
+                       << "\" (type: " << typeid(Data).name()
+                       << "), dropping data. Total dropped: " << overflow_count
+                       << ". Consider increasing interthread.ring_capacity" << std::endl;
+    }
+
     // subscriptions for a given thread
     static std::unordered_multimap<std::thread::id, Callback> subscription_callbacks_;
     // threads that are subscribed to a given group
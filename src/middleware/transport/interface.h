@@ -37,8 +37,10 @@
 #include "goby/middleware/protobuf/intervehicle.pb.h"
 #include "goby/middleware/protobuf/transporter_config.pb.h"
 #include "goby/middleware/transport/detail/type_helpers.h"
+#include "goby/middleware/transport/poller_wakeup.h"
 #include "goby/middleware/transport/publisher.h"
 #include "goby/middleware/transport/subscriber.h"
+#include "goby/time/virtual_clock.h"
 #include "goby/util/debug_logger.h"
 
 namespace goby
@@ -165,10 +167,19 @@ class PollerInterface
     /// \return pointer to the condition variable used for polling
     std::shared_ptr<std::condition_variable_any> cv() { return cv_; }
 
+    /// \brief Set an additional wakeup, notified along with cv() when InterThreadTransporter data are published to this thread
+    ///
+    /// For threads that block on something other than poll() (e.g. a boost::asio::io_context) but still need to return to poll() to receive data. Pass nullptr to remove it.
+    void set_wakeup(std::shared_ptr<PollerWakeup> wakeup) { wakeup_slot_->set(std::move(wakeup)); }
+
+    /// \brief access the slot holding the wakeup set by set_wakeup() (shared by all the Pollers of this thread)
+    std::shared_ptr<detail::PollerWakeupSlot> wakeup_slot() { return wakeup_slot_; }
+
   protected:
     PollerInterface(std::shared_ptr<std::timed_mutex> poll_mutex,
-                    std::shared_ptr<std::condition_variable_any> cv)
-        : poll_mutex_(poll_mutex), cv_(cv)
+                    std::shared_ptr<std::condition_variable_any> cv,
+                    std::shared_ptr<detail::PollerWakeupSlot> wakeup_slot)
+        : poll_mutex_(poll_mutex), cv_(cv), wakeup_slot_(wakeup_slot)
     {
     }
 
@@ -185,6 +196,7 @@ class PollerInterface
     std::shared_ptr<std::timed_mutex> poll_mutex_;
     // signaled when there's no data for this thread to read during _poll()
     std::shared_ptr<std::condition_variable_any> cv_;
+    std::shared_ptr<detail::PollerWakeupSlot> wakeup_slot_;
 };
 
 /// \brief Used to tag subscriptions based on their necessity (e.g. required for correct functioning, or optional)
@@ -212,7 +224,8 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <const Group& group, typename Data,
               int scheme = transporter_scheme<Data, Transporter>()>
-    void publish(const Data& data, const Publisher<Data>& publisher = Publisher<Data>())
+    void publish(const Data& data,
+                 const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         static_cast<Transporter*>(this)->template check_validity<group>();
         static_cast<Transporter*>(this)->template publish_dynamic<Data, scheme>(data, group,
@@ -232,7 +245,7 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
     template <const Group& group, typename Data,
               int scheme = transporter_scheme<Data, Transporter>()>
     void publish(std::shared_ptr<const Data> data,
-                 const Publisher<Data>& publisher = Publisher<Data>())
+                 const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         static_cast<Transporter*>(this)->template check_validity<group>();
         static_cast<Transporter*>(this)->template publish_dynamic<Data, scheme>(data, group,
@@ -251,7 +264,8 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
     /// Note: need both const and non-const shared_ptr overload to ensure that the const& overload isn't preferred to these.
     template <const Group& group, typename Data,
               int scheme = transporter_scheme<Data, Transporter>()>
-    void publish(std::shared_ptr<Data> data, const Publisher<Data>& publisher = Publisher<Data>())
+    void publish(std::shared_ptr<Data> data,
+                 const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         publish<group, Data, scheme>(std::shared_ptr<const Data>(data), publisher);
     }
@@ -268,7 +282,7 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
               int scheme = transporter_scheme<Data, Transporter>(),
               Necessity necessity = Necessity::OPTIONAL>
     void subscribe(std::function<void(const Data&)> f,
-                   const Subscriber<Data>& subscriber = Subscriber<Data>())
+                   const Subscriber<Data>& subscriber = Subscriber<Data>::default_instance())
     {
         static_cast<Transporter*>(this)->template check_validity<group>();
         static_cast<Transporter*>(this)->template subscribe_dynamic<Data, scheme>(f, group,
@@ -287,7 +301,7 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
               int scheme = transporter_scheme<Data, Transporter>(),
               Necessity necessity = Necessity::OPTIONAL>
     void subscribe(std::function<void(std::shared_ptr<const Data>)> f,
-                   const Subscriber<Data>& subscriber = Subscriber<Data>())
+                   const Subscriber<Data>& subscriber = Subscriber<Data>::default_instance())
     {
         static_cast<Transporter*>(this)->template check_validity<group>();
         static_cast<Transporter*>(this)->template subscribe_dynamic<Data, scheme>(f, group,
@@ -320,7 +334,7 @@ class StaticTransporterInterface : public InnerTransporterInterface<Transporter,
     /// \tparam scheme Marshalling scheme id (typically MarshallingScheme::MarshallingSchemeEnum). Can usually be inferred from the Data type.
     template <const Group& group, typename Data,
               int scheme = transporter_scheme<Data, Transporter>()>
-    void unsubscribe(const Subscriber<Data>& subscriber = Subscriber<Data>())
+    void unsubscribe(const Subscriber<Data>& subscriber = Subscriber<Data>::default_instance())
     {
         static_cast<Transporter*>(this)->template check_validity<group>();
         static_cast<Transporter*>(this)->template unsubscribe_dynamic<Data, scheme>(group,
@@ -365,14 +379,30 @@ int goby::middleware::PollerInterface::_poll_all(
         new std::unique_lock<std::timed_mutex>(*poll_mutex_));
     //    std::cout << std::this_thread::get_id() <<  " _poll_all locking: " << poll_mutex_.get() << std::endl;
 
+    // in virtual time, the work done since the last poll may have created events for other threads
+    const bool virtual_time = goby::time::VirtualClock::enabled();
+    if (virtual_time)
+        goby::time::VirtualClock::active();
+
     int poll_items = _transporter_poll(lock);
+    const auto virtual_deadline =
+        virtual_time ? goby::time::VirtualClock::deadline(timeout)
+                     : goby::time::VirtualClock::duration::max();
     while (poll_items == 0)
     {
         if (!lock)
             throw(goby::Exception(
                 "Poller lock was released by poll() but no poll items were returned"));
 
-        if (timeout == Clock::time_point::max())
+        if (virtual_time)
+        {
+            if (goby::time::VirtualClock::wait_until(*lock, *cv_, virtual_deadline) ==
+                std::cv_status::no_timeout)
+                poll_items = _transporter_poll(lock);
+            else
+                return poll_items;
+        }
+        else if (timeout == Clock::time_point::max())
         {
             cv_->wait(*lock); // wait_until doesn't work well with time_point::max()
             poll_items = _transporter_poll(lock);
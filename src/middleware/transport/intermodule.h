@@ -94,7 +94,9 @@ class InterModuleForwarder
         key->set_group(std::string(group));
         msg.set_allocated_data(sbytes);
 
-        *key->mutable_cfg() = publisher.cfg();
+        // the default (empty) configuration is the common case, so avoid copying it
+        if (!publisher.cfg_is_default())
+            *key->mutable_cfg() = publisher.cfg();
         this->inner().template publish<Base::to_portal_group_>(msg);
     }
 
@@ -107,9 +109,14 @@ class InterModuleForwarder
                 .template subscribe<Base::from_portal_group_,
                                     protobuf::SerializerTransporterMessage>(
                     [this](const protobuf::SerializerTransporterMessage& msg) {
+                        const auto& data = msg.data();
+                        SerializationPostCache post_cache;
                         auto range = subscriptions_.equal_range(msg.key());
                         for (auto it = range.first; it != range.second; ++it)
-                        { it->second->post(msg.data().begin(), msg.data().end()); }
+                        {
+                            it->second->post_cached(data.data(), data.data() + data.size(),
+                                                    post_cache);
+                        }
                     });
 
         auto local_subscription = std::make_shared<SerializationSubscription<Data, scheme>>(
@@ -77,7 +77,7 @@ class InterProcessTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(const Data& data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         check_validity_runtime(group);
         static_cast<Derived*>(this)->template _publish<Data, scheme>(data, group, publisher);
@@ -93,7 +93,7 @@ class InterProcessTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<const Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         if (data)
         {
@@ -112,7 +112,7 @@ class InterProcessTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         publish_dynamic<Data, scheme>(std::shared_ptr<const Data>(data), group, publisher);
     }
@@ -134,7 +134,8 @@ class InterProcessTransporterBase
     /// \param subscriber Optional metadata that controls the subscription or sets callbacks to monitor the subscription result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(const Data&)> f, const Group& group,
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
         static_cast<Derived*>(this)->template _subscribe<Data, scheme>(
@@ -150,7 +151,8 @@ class InterProcessTransporterBase
     /// \param subscriber Optional metadata that controls the subscription or sets callbacks to monitor the subscription result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(std::shared_ptr<const Data>)> f, const Group& group,
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
         static_cast<Derived*>(this)->template _subscribe<Data, scheme>(f, group, subscriber);
@@ -163,7 +165,8 @@ class InterProcessTransporterBase
     /// \param group group to unsubscribe from (typically a DynamicGroup)
     template <typename Data, int scheme = scheme<Data>()>
     void unsubscribe_dynamic(const Group& group,
-                             const Subscriber<Data>& subscriber = Subscriber<Data>())
+                             const Subscriber<Data>& subscriber =
+                                 Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
         static_cast<Derived*>(this)->template _unsubscribe<Data, scheme>(group, subscriber);
@@ -337,7 +340,9 @@ class InterProcessForwarder
         key->set_group(std::string(group));
         msg->set_allocated_data(sbytes);
 
-        *key->mutable_cfg() = publisher.cfg();
+        // the default (empty) configuration is the common case, so avoid copying it
+        if (!publisher.cfg_is_default())
+            *key->mutable_cfg() = publisher.cfg();
 
         this->inner().template publish<Base::to_portal_group_>(msg);
     }
@@ -29,3 +29,8 @@
 std::unordered_map<std::thread::id, goby::middleware::detail::SubscriptionStoreBase::StoresMap>
     goby::middleware::detail::SubscriptionStoreBase::stores_;
 std::shared_timed_mutex goby::middleware::detail::SubscriptionStoreBase::stores_mutex_;
+
+goby::middleware::InterThreadSettings::MailboxBackend
+    goby::middleware::InterThreadSettings::mailbox_backend =
+        goby::middleware::InterThreadSettings::MailboxBackend::MUTEX_QUEUE;
+std::size_t goby::middleware::InterThreadSettings::ring_capacity = 1024;
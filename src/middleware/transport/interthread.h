@@ -24,6 +24,8 @@
 #ifndef GOBY_MIDDLEWARE_TRANSPORT_INTERTHREAD_H
 #define GOBY_MIDDLEWARE_TRANSPORT_INTERTHREAD_H
 
+#include <atomic>     // for ato...
+#include <cstddef>    // for size_t
 #include <functional> // for fun...
 #include <memory>     // for sha...
 #include <mutex>      // for mutex
@@ -43,6 +45,23 @@ namespace goby
 {
 namespace middleware
 {
+/// \brief Parameters for selecting the data queue ("mailbox") implementation used by InterThreadTransporter
+struct InterThreadSettings
+{
+    enum class MailboxBackend
+    {
+        /// Unbounded std::vector per group, protected by a per-thread mutex, with a condition variable handshake on every publish
+        MUTEX_QUEUE,
+        /// Bounded lock-free ring buffer per (subscribing thread, group). Publishers only take the poller lock when the subscribing thread may be waiting
+        LOCK_FREE_RING
+    };
+
+    /// \brief Mailbox implementation for InterThreadTransporters constructed after this is set (typically set once per application from AppConfig::interthread)
+    static MailboxBackend mailbox_backend;
+    /// \brief Capacity of each LOCK_FREE_RING mailbox. Data published to a full mailbox are dropped (and a warning is written to glog)
+    static std::size_t ring_capacity;
+};
+
 /// \brief A transporter for the interthread layer
 ///
 /// As no layer exists inside the interthread layer, no distinction is made between interthread "portals" and "forwarders". This class serves both purposes, providing a no-copy publish/subscribe interface for interthread communications using std::shared_ptr (for maximum efficiency, use the shared pointer overloads for publish). As no copy is made, the publisher must not modify the underlying data after calling publish, as this would lead to potentially unsafe data races when subscribed nodes read the data.
@@ -63,7 +82,14 @@ class InterThreadTransporter
     };
 
   public:
-    InterThreadTransporter() : data_mutex_(std::make_shared<std::mutex>()) {}
+    InterThreadTransporter()
+        : data_mutex_(std::make_shared<std::mutex>()),
+          ring_capacity_(InterThreadSettings::mailbox_backend ==
+                                 InterThreadSettings::MailboxBackend::LOCK_FREE_RING
+                             ? InterThreadSettings::ring_capacity
+                             : 0)
+    {
+    }
 
     virtual ~InterThreadTransporter()
     {
@@ -98,7 +124,7 @@ class InterThreadTransporter
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(const Data& data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         check_validity_runtime(group);
         std::shared_ptr<Data> data_ptr(new Data(data));
@@ -114,7 +140,7 @@ class InterThreadTransporter
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<const Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         check_validity_runtime(group);
         detail::SubscriptionStore<Data>::publish(data, group, publisher);
@@ -129,7 +155,7 @@ class InterThreadTransporter
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         publish_dynamic<Data, scheme>(std::shared_ptr<const Data>(data), group, publisher);
     }
@@ -149,13 +175,15 @@ class InterThreadTransporter
     /// \param group group to subscribe to (typically a DynamicGroup)
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(const Data&)> f, const Group& group,
-                           const Subscriber<Data>& /*subscriber*/ = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
-        detail::SubscriptionStore<Data>::subscribe([=](std::shared_ptr<const Data> pd) { f(*pd); },
-                                                   group, std::this_thread::get_id(), data_mutex_,
-                                                   Poller<InterThreadTransporter>::cv(),
-                                                   Poller<InterThreadTransporter>::poll_mutex());
+        detail::SubscriptionStore<Data>::subscribe(
+            [=](std::shared_ptr<const Data> pd) { f(*pd); }, group, std::this_thread::get_id(),
+            data_mutex_, Poller<InterThreadTransporter>::cv(),
+            Poller<InterThreadTransporter>::poll_mutex(), ring_capacity_, lock_free_poller_armed(),
+            Poller<InterThreadTransporter>::wakeup_slot(), subscriber);
     }
 
     /// \brief Subscribe to a specific run-time defined group and data type (shared pointer variant). Where possible, prefer the static variant in StaticTransporterInterface::subscribe()
@@ -166,12 +194,14 @@ class InterThreadTransporter
     /// \param group group to subscribe to (typically a DynamicGroup)
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(std::shared_ptr<const Data>)> f, const Group& group,
-                           const Subscriber<Data>& /*subscriber*/ = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
         detail::SubscriptionStore<Data>::subscribe(
             f, group, std::this_thread::get_id(), data_mutex_, Poller<InterThreadTransporter>::cv(),
-            Poller<InterThreadTransporter>::poll_mutex());
+            Poller<InterThreadTransporter>::poll_mutex(), ring_capacity_, lock_free_poller_armed(),
+            Poller<InterThreadTransporter>::wakeup_slot(), subscriber);
     }
 
     /// \brief Subscribe with no data (used to receive a signal from another thread)
@@ -188,7 +218,8 @@ class InterThreadTransporter
     /// \param group group to unsubscribe from (typically a DynamicGroup)
     template <typename Data, int scheme = scheme<Data>()>
     void unsubscribe_dynamic(const Group& group,
-                             const Subscriber<Data>& /*subscriber*/ = Subscriber<Data>())
+                             const Subscriber<Data>& /*subscriber*/ =
+                                 Subscriber<Data>::default_instance())
     {
         check_validity_runtime(group);
         detail::SubscriptionStore<Data>::unsubscribe(group, std::this_thread::get_id());
@@ -204,12 +235,38 @@ class InterThreadTransporter
     friend Poller<InterThreadTransporter>;
     int _poll(std::unique_ptr<std::unique_lock<std::timed_mutex>>& lock)
     {
-        return detail::SubscriptionStoreBase::poll_all(std::this_thread::get_id(), lock);
+        const auto& armed = lock_free_poller_armed();
+        if (armed)
+        {
+            // tell publishers we might wait on the condition variable if we don't find anything
+            // (sequentially consistent with the ring buffer reads in poll_all(), see SubscriptionStore::publish())
+            armed->store(true, std::memory_order_seq_cst);
+        }
+
+        int poll_items = detail::SubscriptionStoreBase::poll_all(std::this_thread::get_id(), lock);
+
+        // we're not going to wait, so publishers can skip the notification until we re-arm
+        if (armed && poll_items > 0)
+            armed->store(false, std::memory_order_relaxed);
+
+        return poll_items;
+    }
+
+    // true when the calling thread may be about to wait for data (nullptr unless using LOCK_FREE_RING)
+    // stored per thread as a single transporter may be polled from several threads
+    const std::shared_ptr<std::atomic<bool>>& lock_free_poller_armed()
+    {
+        static const std::shared_ptr<std::atomic<bool>> not_lock_free;
+        static thread_local std::shared_ptr<std::atomic<bool>> armed(
+            std::make_shared<std::atomic<bool>>(false));
+        return ring_capacity_ > 0 ? armed : not_lock_free;
     }
 
   private:
-    // protects this thread's DataQueue
+    // protects this thread's DataQueue (unused for InterThreadSettings::MailboxBackend::LOCK_FREE_RING)
     std::shared_ptr<std::mutex> data_mutex_;
+    // zero for InterThreadSettings::MailboxBackend::MUTEX_QUEUE
+    const std::size_t ring_capacity_;
 };
 
 } // namespace middleware
@@ -139,7 +139,7 @@ class InterVehicleTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result.
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void publish_dynamic(const Data& data, const Group& group = Group(),
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         static_assert(scheme == MarshallingScheme::DCCL,
                       "Can only use DCCL messages with InterVehicleTransporters");
@@ -164,7 +164,7 @@ class InterVehicleTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result.
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void publish_dynamic(std::shared_ptr<const Data> data, const Group& group = Group(),
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         static_assert(scheme == MarshallingScheme::DCCL,
                       "Can only use DCCL messages with InterVehicleTransporters");
@@ -196,7 +196,7 @@ class InterVehicleTransporterBase
     /// \param publisher Optional metadata that controls the publication or sets callbacks to monitor the result.
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void publish_dynamic(std::shared_ptr<Data> data, const Group& group = Group(),
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
         publish_dynamic<Data, scheme>(std::shared_ptr<const Data>(data), group, publisher);
     }
@@ -210,7 +210,8 @@ class InterVehicleTransporterBase
     /// \param subscriber Optional metadata that controls the subscription or sets callbacks to monitor the subscription result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void subscribe_dynamic(std::function<void(const Data&)> f, const Group& group = Group(),
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         static_assert(scheme == MarshallingScheme::DCCL,
                       "Can only use DCCL messages with InterVehicleTransporters");
@@ -229,7 +230,8 @@ class InterVehicleTransporterBase
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void subscribe_dynamic(std::function<void(std::shared_ptr<const Data>)> f,
                            const Group& group = Group(),
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
         static_assert(scheme == MarshallingScheme::DCCL,
                       "Can only use DCCL messages with InterVehicleTransporters");
@@ -245,7 +247,8 @@ class InterVehicleTransporterBase
     /// \param subscriber Optional metadata that controls the subscription or sets callbacks to monitor the subscription result. Typically unnecessary for interprocess and inner layers.
     template <typename Data, int scheme = goby::middleware::scheme<Data>()>
     void unsubscribe_dynamic(const Group& group = Group(),
-                             const Subscriber<Data>& subscriber = Subscriber<Data>())
+                             const Subscriber<Data>& subscriber =
+                                 Subscriber<Data>::default_instance())
     {
         static_assert(scheme == MarshallingScheme::DCCL,
                       "Can only use DCCL messages with InterVehicleTransporters");
@@ -357,7 +360,7 @@ class InterVehicleTransporterBase
         // insert pending subscription
         auto subscription_publication = intervehicle::serialize_publication(
             *dccl_subscription, intervehicle::groups::subscription_forward,
-            Publisher<Subscription>());
+            Publisher<Subscription>::default_instance());
 
         // overwrite timestamps to ensure mapping with driver threads
         auto subscribe_time = dccl_subscription->time_with_units();
@@ -49,31 +49,33 @@ class NullTransporter : public StaticTransporterInterface<NullTransporter, NullT
 
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(const Data& data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
     }
 
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
     }
 
     template <typename Data, int scheme = scheme<Data>()>
     void publish_dynamic(std::shared_ptr<const Data> data, const Group& group,
-                         const Publisher<Data>& publisher = Publisher<Data>())
+                         const Publisher<Data>& publisher = Publisher<Data>::default_instance())
     {
     }
 
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(const Data&)> f, const Group& group,
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
     }
 
     template <typename Data, int scheme = scheme<Data>()>
     void subscribe_dynamic(std::function<void(std::shared_ptr<const Data>)> f, const Group& group,
-                           const Subscriber<Data>& subscriber = Subscriber<Data>())
+                           const Subscriber<Data>& subscriber =
+                               Subscriber<Data>::default_instance())
     {
     }
 
@@ -42,7 +42,9 @@ template <typename Transporter> class Poller : public PollerInterface
         : // we want the same mutex and cv all the way up
           PollerInterface(
               inner_poller ? inner_poller->poll_mutex() : std::make_shared<std::timed_mutex>(),
-              inner_poller ? inner_poller->cv() : std::make_shared<std::condition_variable_any>()),
+              inner_poller ? inner_poller->cv() : std::make_shared<std::condition_variable_any>(),
+              inner_poller ? inner_poller->wakeup_slot()
+                           : std::make_shared<detail::PollerWakeupSlot>()),
           inner_poller_(inner_poller)
     {
     }
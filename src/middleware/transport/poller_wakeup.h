@@ -0,0 +1,76 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MIDDLEWARE_TRANSPORT_POLLER_WAKEUP_H
+#define GOBY_MIDDLEWARE_TRANSPORT_POLLER_WAKEUP_H
+
+#include <atomic>  // for atomic
+#include <memory>  // for shared_ptr, atomic_load
+#include <utility> // for move
+
+namespace goby
+{
+namespace middleware
+{
+/// \brief Wakes a thread that waits for its data on something other than PollerInterface::cv() (for example, an eventfd read by a boost::asio::io_context, see io::detail::IOThread)
+class PollerWakeup
+{
+  public:
+    virtual ~PollerWakeup() = default;
+
+    /// \brief Called by the publishing thread after queuing data for the polling thread
+    virtual void notify() = 0;
+};
+
+namespace detail
+{
+/// \brief Holds the (optional) PollerWakeup shared by all the Pollers of a given thread
+class PollerWakeupSlot
+{
+  public:
+    void set(std::shared_ptr<PollerWakeup> wakeup)
+    {
+        is_set_ = (wakeup != nullptr);
+        std::atomic_store(&wakeup_, std::move(wakeup));
+    }
+
+    void notify()
+    {
+        // avoid the atomic shared_ptr load for the (usual) threads without a wakeup
+        if (!is_set_.load(std::memory_order_acquire))
+            return;
+
+        // the copy keeps the wakeup alive while notifying, even if the thread removes it
+        if (auto wakeup = std::atomic_load(&wakeup_))
+            wakeup->notify();
+    }
+
+  private:
+    std::shared_ptr<PollerWakeup> wakeup_;
+    std::atomic<bool> is_set_{false};
+};
+} // namespace detail
+} // namespace middleware
+} // namespace goby
+
+#endif
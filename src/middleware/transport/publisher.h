@@ -31,6 +31,10 @@
 #include "goby/middleware/protobuf/intervehicle.pb.h"
 #include "goby/middleware/protobuf/transporter_config.pb.h"
 
+#if GOOGLE_PROTOBUF_VERSION < 3001000
+#define ByteSizeLong ByteSize
+#endif
+
 namespace goby
 {
 namespace middleware
@@ -66,6 +70,7 @@ template <typename Data> class Publisher
         {
             cfg_.mutable_intervehicle()->mutable_buffer()->set_ack_required(true);
         }
+        cfg_is_default_ = (cfg_.ByteSizeLong() == 0);
     }
 
     /// \brief Construct a Publisher but without the set_group_func callback
@@ -77,9 +82,19 @@ template <typename Data> class Publisher
 
     ~Publisher() {}
 
+    /// \brief Returns a shared Publisher with no metadata or callbacks, used as the default for publish calls so that a Publisher (and its TransporterConfig) is not constructed for every publication
+    static const Publisher<Data>& default_instance()
+    {
+        static const Publisher<Data> default_publisher;
+        return default_publisher;
+    }
+
     /// \brief Returns the metadata configuration
     const goby::middleware::protobuf::TransporterConfig& cfg() const { return cfg_; }
 
+    /// \brief Returns true if no metadata configuration fields are set, in which case transporters may omit the configuration from the publication
+    bool cfg_is_default() const { return cfg_is_default_; }
+
     /// \brief Sets the group using the set_group_func. Only intended to be called by the various transporters.
     void set_group(Data& data, const Group& group) const
     {
@@ -96,6 +111,7 @@ template <typename Data> class Publisher
 
   private:
     goby::middleware::protobuf::TransporterConfig cfg_;
+    bool cfg_is_default_{true};
     set_group_func_type set_group_func_;
     acked_func_type acked_func_;
     expired_func_type expired_func_;
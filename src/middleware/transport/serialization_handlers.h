@@ -28,7 +28,9 @@
 #include <memory>
 #include <regex>
 #include <thread>
+#include <typeindex>
 #include <unordered_map>
+#include <vector>
 
 #include "goby/exception.h"
 #include "goby/util/binary.h"
@@ -45,6 +47,51 @@ namespace goby
 {
 namespace middleware
 {
+/// \brief Holds the parsed message(s) for a single received publication, so that all the subscriptions to the same identifier (interprocess and outer layers) share one parse and one std::shared_ptr<const Data>
+///
+/// Create one instance per received message and pass it to each call to SerializationHandlerBase::post_cached() for that message.
+class SerializationPostCache
+{
+  public:
+    /// \brief Return the previously parsed message for this Data type, scheme and byte range, or parse it (using SerializerParserHelper) and store the result
+    template <typename Data, int scheme_id>
+    std::shared_ptr<const Data> parse(const char* bytes_begin, const char* bytes_end,
+                                      const char*& actual_end, const std::string& type)
+    {
+        std::type_index data_type(typeid(Data));
+        for (const auto& entry : entries_)
+        {
+            if (entry.data_type == data_type && entry.scheme == scheme_id &&
+                entry.bytes_begin == bytes_begin && entry.bytes_end == bytes_end)
+            {
+                actual_end = entry.actual_end;
+                return std::static_pointer_cast<const Data>(entry.msg);
+            }
+        }
+
+        std::shared_ptr<const Data> msg = SerializerParserHelper<Data, scheme_id>::parse(
+            bytes_begin, bytes_end, actual_end, type);
+        entries_.push_back({data_type, scheme_id, bytes_begin, bytes_end, actual_end, msg});
+        return msg;
+    }
+
+    /// \brief Remove all cached messages (retaining the allocated storage for reuse with the next received message)
+    void clear() { entries_.clear(); }
+
+  private:
+    struct Entry
+    {
+        std::type_index data_type;
+        int scheme;
+        const char* bytes_begin;
+        const char* bytes_end;
+        const char* actual_end;
+        std::shared_ptr<const void> msg;
+    };
+    // almost always zero or one entries as the identifier contains the type name and scheme
+    std::vector<Entry> entries_;
+};
+
 /// \brief Selector class for enabling SerializationHandlerBase::post() override signature based on whether the Metadata exists (e.g. Publisher or Subscriber) or not (that is, Metadata = void).
 template <typename Metadata, typename Enable = void> class SerializationHandlerPostSelector
 {
@@ -64,6 +111,13 @@ class SerializationHandlerPostSelector<Metadata,
     virtual std::vector<char>::const_iterator post(std::vector<char>::const_iterator b,
                                                    std::vector<char>::const_iterator e) const = 0;
     virtual const char* post(const char* b, const char* e) const = 0;
+
+    /// \brief Post using a cache shared by all the handlers called for a given received message, so that the bytes are parsed only once. Handlers that cannot share the parsed data simply call post()
+    virtual const char* post_cached(const char* b, const char* e,
+                                    SerializationPostCache& /*cache*/) const
+    {
+        return post(b, e);
+    }
 };
 
 /// \brief Selects the SerializationHandlerBase::post() signatures with metadata (e.g. Publisher or Subscriber)
@@ -135,7 +189,8 @@ class SerializationSubscription : public SerializationHandlerBase<>
 
     SerializationSubscription(HandlerType handler,
                               const Group& group = Group(Group::broadcast_group),
-                              const Subscriber<Data>& subscriber = Subscriber<Data>())
+                              const Subscriber<Data>& subscriber =
+                                  Subscriber<Data>::default_instance())
         : handler_(handler),
           type_name_(SerializerParserHelper<Data, scheme_id>::type_name()),
           group_(group),
@@ -158,6 +213,14 @@ class SerializationSubscription : public SerializationHandlerBase<>
 
     const char* post(const char* b, const char* e) const override { return _post(b, e); }
 
+    const char* post_cached(const char* b, const char* e,
+                            SerializationPostCache& cache) const override
+    {
+        const char* actual_end;
+        _handle(cache.parse<Data, scheme_id>(b, e, actual_end, type_name_));
+        return actual_end;
+    }
+
     SerializationHandlerBase<>::SubscriptionAction action() const override
     {
         return SerializationHandlerBase<>::SubscriptionAction::SUBSCRIBE;
@@ -173,13 +236,15 @@ class SerializationSubscription : public SerializationHandlerBase<>
     CharIterator _post(CharIterator bytes_begin, CharIterator bytes_end) const
     {
         CharIterator actual_end;
-        auto msg = SerializerParserHelper<Data, scheme_id>::parse(bytes_begin, bytes_end,
-                                                                  actual_end, type_name_);
+        _handle(SerializerParserHelper<Data, scheme_id>::parse(bytes_begin, bytes_end, actual_end,
+                                                               type_name_));
+        return actual_end;
+    }
 
+    void _handle(std::shared_ptr<const Data> msg) const
+    {
         if (subscribed_group() == subscriber_.group(*msg) && handler_)
             handler_(msg);
-
-        return actual_end;
     }
 
   private:
@@ -202,7 +267,8 @@ class IntervehicleSerializationSubscription
 
     IntervehicleSerializationSubscription(HandlerType handler,
                                           const Group& group = Group(Group::broadcast_group),
-                                          const Subscriber<Data>& subscriber = Subscriber<Data>())
+                                          const Subscriber<Data>& subscriber =
+                                              Subscriber<Data>::default_instance())
         : handler_(handler),
           type_name_(SerializerParserHelper<Data, scheme_id>::type_name()),
           group_(group),
@@ -24,6 +24,10 @@
 #ifndef GOBY_MIDDLEWARE_TRANSPORT_SUBSCRIBER_H
 #define GOBY_MIDDLEWARE_TRANSPORT_SUBSCRIBER_H
 
+#include <atomic>  // for atomic
+#include <cstdint> // for uint64_t
+#include <memory>  // for shared_ptr
+
 #include "goby/middleware/group.h"
 #include "goby/middleware/protobuf/transporter_config.pb.h"
 #include "goby/middleware/transport/publisher.h"
@@ -60,7 +64,10 @@ template <typename Data> class Subscriber
           group_func_(group_func),
           subscribed_func_(subscribed_func),
           subscribe_expired_func_(subscribe_expired_func),
-          set_link_data_func_(set_link_data_func)
+          set_link_data_func_(set_link_data_func),
+          cfg_is_default_(cfg_.ByteSizeLong() == 0),
+          dropped_(cfg_.queue_depth() > 0 ? std::make_shared<std::atomic<std::uint64_t>>(0)
+                                           : nullptr)
     {
     }
 
@@ -76,9 +83,19 @@ template <typename Data> class Subscriber
 
     ~Subscriber() {}
 
+    /// \brief Returns a shared Subscriber with no metadata or callbacks, used as the default for subscribe calls so that a Subscriber (and its TransporterConfig) is not constructed for every call
+    static const Subscriber<Data>& default_instance()
+    {
+        static const Subscriber<Data> default_subscriber;
+        return default_subscriber;
+    }
+
     /// \return the metadata configuration
     const goby::middleware::protobuf::TransporterConfig& cfg() const { return cfg_; }
 
+    /// \return true if no metadata configuration fields are set
+    bool cfg_is_default() const { return cfg_is_default_; }
+
     /// \return the group for this subscribe call using the group_func. Only intended to be called by the various transporters.
     Group group(const Data& data) const
     {
@@ -102,12 +119,27 @@ template <typename Data> class Subscriber
             set_link_data_func_(data, header);
     };
 
+    /// \return the number of data dropped because more than cfg().queue_depth() were waiting for the subscribing thread (shared with copies of this Subscriber)
+    std::uint64_t dropped() const
+    {
+        return dropped_ ? dropped_->load(std::memory_order_relaxed) : 0;
+    }
+
+    /// \brief Count data dropped due to cfg().queue_depth(). Only intended to be called by the various transporters.
+    void add_dropped(std::uint64_t n) const
+    {
+        if (dropped_)
+            dropped_->fetch_add(n, std::memory_order_relaxed);
+    }
+
   private:
     goby::middleware::protobuf::TransporterConfig cfg_;
     group_func_type group_func_;
     subscribed_func_type subscribed_func_;
     subscribe_expired_func_type subscribe_expired_func_;
     set_link_data_func_type set_link_data_func_;
+    bool cfg_is_default_;
+    std::shared_ptr<std::atomic<std::uint64_t>> dropped_;
 };
 } // namespace middleware
 } // namespace goby
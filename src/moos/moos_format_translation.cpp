@@ -0,0 +1,645 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm> // for all_of
+#include <cctype>    // for isdigit
+#include <iomanip>   // for setprecision
+#include <limits>    // for numeric_limits
+#include <regex>     // for regex, sregex_iterator
+#include <set>       // for set
+#include <sstream>   // for ostringstream
+#include <stdexcept> // for runtime_error
+#include <utility>   // for pair, move
+#include <vector>    // for vector
+
+#include <boost/algorithm/string/case_conv.hpp>      // for to_lower
+#include <boost/algorithm/string/classification.hpp> // for is_any_of
+#include <boost/algorithm/string/replace.hpp>        // for replace_all
+#include <boost/algorithm/string/split.hpp>          // for split
+#include <boost/algorithm/string/trim.hpp>           // for trim_if
+#include <boost/lexical_cast.hpp>                    // for lexical_cast
+
+#include "goby/moos/moos_protobuf_helpers.h" // for MOOSTranslation
+#include "goby/util/as.h"                    // for as
+#include "goby/util/binary.h"                // for hex_encode
+
+#include "moos_format_translation.h"
+
+using goby::moos::protobuf::TranslatorEntry;
+using FormatTranslation = goby::moos::MOOSTranslation<TranslatorEntry::TECHNIQUE_FORMAT>;
+
+// (embedded message field, index if the field is repeated) for each step from the top-level
+// message to the message given by a "%a:b:c%" specifier
+using MessagePath = std::vector<std::pair<const google::protobuf::FieldDescriptor*, int>>;
+
+struct goby::moos::FormatSerializer::Plan
+{
+    enum class SegmentType
+    {
+        LITERAL,
+        FIELD,
+        MODIFIED_VALUE,
+        SUBMESSAGE
+    };
+
+    struct Segment
+    {
+        SegmentType type{SegmentType::LITERAL};
+        std::string literal;
+
+        // FIELD
+        const google::protobuf::FieldDescriptor* field_desc{nullptr};
+        bool is_indexed_repeated_field{false};
+        int index{0};
+
+        // MODIFIED_VALUE
+        int virtual_field{0};
+
+        // SUBMESSAGE
+        MessagePath path;
+        std::shared_ptr<const Plan> sub_plan;
+    };
+
+    std::vector<Segment> segments;
+    bool uses_modified_values{false};
+};
+
+struct goby::moos::FormatParser::Plan
+{
+    enum class StepType
+    {
+        LITERAL,
+        FIELD,
+        SUBMESSAGE
+    };
+
+    struct Step
+    {
+        StepType type{StepType::LITERAL};
+        // LITERAL: character to skip past, otherwise the character that ends the extracted value
+        // ('\0' at the end of the format)
+        char separator{'\0'};
+
+        // FIELD
+        std::string specifier;
+        const google::protobuf::FieldDescriptor* field_desc{nullptr};
+        int field_index{0};
+        bool is_indexed_repeated_field{false};
+        int value_index{0};
+
+        // SUBMESSAGE
+        MessagePath path;
+        std::shared_ptr<const Plan> sub_plan;
+    };
+
+    std::vector<Step> steps;
+};
+
+namespace
+{
+using SerializerAlgorithms =
+    google::protobuf::RepeatedPtrField<TranslatorEntry::PublishSerializer::Algorithm>;
+using ParserAlgorithms =
+    google::protobuf::RepeatedPtrField<TranslatorEntry::CreateParser::Algorithm>;
+
+using SerializerPlan = goby::moos::FormatSerializer::Plan;
+using ParserPlan = goby::moos::FormatParser::Plan;
+
+// mirrors the rewriting of "%a:b%" and "%a.b%" specifiers into "%N%" done by
+// MOOSTranslation<TECHNIQUE_FORMAT>::serialize, then splits the result into segments. Returns
+// nullptr if the result contains boost::format directives other than "%N%" and "%%".
+std::shared_ptr<const SerializerPlan> compile_serializer(const google::protobuf::Descriptor* desc,
+                                                         std::string format,
+                                                         const SerializerAlgorithms& algorithms)
+{
+    auto plan = std::make_shared<SerializerPlan>();
+
+    // starting from field(1) matches MOOSTranslation<TECHNIQUE_FORMAT>::serialize
+    int max_field_number = 1;
+    for (int i = 1, n = desc->field_count(); i < n; ++i)
+        max_field_number = std::max(max_field_number, desc->field(i)->number());
+
+    // keys of the map returned by run_serialize_algorithms
+    std::set<int> modified_value_fields;
+    for (const auto& algorithm : algorithms)
+    {
+        const google::protobuf::FieldDescriptor* primary_field_desc =
+            desc->FindFieldByNumber(algorithm.primary_field());
+        if (!primary_field_desc || primary_field_desc->is_repeated())
+            continue;
+        modified_value_fields.insert(algorithm.output_virtual_field());
+        max_field_number = std::max(max_field_number, algorithm.output_virtual_field());
+    }
+
+    std::map<int, std::pair<MessagePath, std::shared_ptr<const SerializerPlan>>> submessages;
+
+    std::string format_temp = format;
+    std::regex moos_index_regex("%([0-9\\.]+:)+[0-9\\.]+%");
+    for (std::sregex_iterator it(format.begin(), format.end(), moos_index_regex), end; it != end;
+         ++it)
+    {
+        std::string match = (*it)[0];
+        boost::trim_if(match, boost::is_any_of("%"));
+        std::vector<std::string> subfields;
+        boost::split(subfields, match, boost::is_any_of(":"));
+
+        ++max_field_number;
+
+        MessagePath path;
+        const google::protobuf::Descriptor* sub_desc = desc;
+        for (int i = 0, n = subfields.size() - 1; i < n; ++i)
+        {
+            std::vector<std::string> field_and_index;
+            boost::split(field_and_index, subfields[i], boost::is_any_of("."));
+
+            const google::protobuf::FieldDescriptor* field_desc =
+                sub_desc->FindFieldByNumber(goby::util::as<int>(field_and_index[0]));
+            if (!field_desc ||
+                field_desc->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                throw(std::runtime_error("Invalid ':' syntax given for format: " + match));
+            if (field_desc->is_repeated() && field_and_index.size() != 2)
+                throw(std::runtime_error("Invalid '.' syntax given for format: " + match));
+
+            path.emplace_back(field_desc, field_desc->is_repeated()
+                                              ? goby::util::as<int>(field_and_index[1])
+                                              : -1);
+            sub_desc = field_desc->message_type();
+        }
+
+        auto sub_plan =
+            compile_serializer(sub_desc, "%" + subfields[subfields.size() - 1] + "%", algorithms);
+        if (!sub_plan)
+            return nullptr;
+
+        submessages[max_field_number] = std::make_pair(path, sub_plan);
+        modified_value_fields.insert(max_field_number);
+
+        boost::replace_all(format_temp, std::string("%" + match + "%"),
+                           std::string("%" + goby::util::as<std::string>(max_field_number) + "%"));
+    }
+    format = format_temp;
+
+    std::map<int, FormatTranslation::RepeatedFieldKey> indexed_repeated_fields;
+    std::regex repeated_field_regex("%[0-9]+\\.[0-9]+%");
+    for (std::sregex_iterator it(format.begin(), format.end(), repeated_field_regex), end;
+         it != end; ++it)
+    {
+        std::string match = (*it)[0];
+        boost::trim_if(match, boost::is_any_of("%"));
+
+        ++max_field_number;
+
+        boost::replace_all(format_temp, std::string("%" + match + "%"),
+                           std::string("%" + goby::util::as<std::string>(max_field_number) + "%"));
+
+        std::vector<std::string> field_and_index;
+        boost::split(field_and_index, match, boost::is_any_of("."));
+        indexed_repeated_fields[max_field_number] = {goby::util::as<int>(field_and_index[0]),
+                                                     goby::util::as<int>(field_and_index[1])};
+    }
+    format = format_temp;
+
+    auto add_literal = [&plan](const std::string& literal) {
+        if (plan->segments.empty() ||
+            plan->segments.back().type != SerializerPlan::SegmentType::LITERAL)
+            plan->segments.emplace_back();
+        plan->segments.back().literal += literal;
+    };
+
+    for (std::string::size_type i = 0, n = format.size(); i < n;)
+    {
+        if (format[i] != '%')
+        {
+            add_literal(std::string(1, format[i++]));
+            continue;
+        }
+        else if (i + 1 < n && format[i + 1] == '%')
+        {
+            add_literal("%");
+            i += 2;
+            continue;
+        }
+
+        // only the positional "%N%" directive is handled here
+        std::string::size_type close = format.find('%', i + 1);
+        if (close == std::string::npos)
+            return nullptr;
+        std::string number = format.substr(i + 1, close - i - 1);
+        if (number.empty() || number.size() > 9 || number[0] == '0' ||
+            !std::all_of(number.begin(), number.end(),
+                         [](unsigned char c) { return std::isdigit(c); }))
+            return nullptr;
+        i = close + 1;
+
+        int field_number = std::stoi(number);
+        // no value is given to boost::format for these
+        if (field_number > max_field_number)
+            continue;
+
+        auto indexed_it = indexed_repeated_fields.find(field_number);
+        bool is_indexed_repeated_field = indexed_it != indexed_repeated_fields.end();
+
+        const google::protobuf::FieldDescriptor* field_desc = desc->FindFieldByNumber(
+            is_indexed_repeated_field ? indexed_it->second.field : field_number);
+
+        SerializerPlan::Segment segment;
+        if (field_desc)
+        {
+            segment.type = SerializerPlan::SegmentType::FIELD;
+            segment.field_desc = field_desc;
+            segment.is_indexed_repeated_field = is_indexed_repeated_field;
+            segment.index = is_indexed_repeated_field ? indexed_it->second.index : 0;
+        }
+        else if (submessages.count(field_number))
+        {
+            segment.type = SerializerPlan::SegmentType::SUBMESSAGE;
+            segment.path = submessages[field_number].first;
+            segment.sub_plan = submessages[field_number].second;
+        }
+        else if (modified_value_fields.count(field_number))
+        {
+            segment.type = SerializerPlan::SegmentType::MODIFIED_VALUE;
+            segment.virtual_field = field_number;
+            plan->uses_modified_values = true;
+        }
+        else
+        {
+            add_literal("unknown");
+            continue;
+        }
+        plan->segments.push_back(segment);
+    }
+
+    return plan;
+}
+
+void run_serializer(const SerializerPlan& plan, std::ostream& out,
+                    const google::protobuf::Message& in, const SerializerAlgorithms& algorithms,
+                    const std::string& repeated_delimiter, bool use_short_enum)
+{
+    std::map<int, std::string> modified_values;
+    if (plan.uses_modified_values)
+        modified_values = goby::moos::run_serialize_algorithms(in, algorithms);
+
+    const google::protobuf::Reflection* refl = in.GetReflection();
+
+    for (const auto& segment : plan.segments)
+    {
+        switch (segment.type)
+        {
+            case SerializerPlan::SegmentType::LITERAL: out << segment.literal; break;
+
+            case SerializerPlan::SegmentType::MODIFIED_VALUE:
+                out << modified_values[segment.virtual_field];
+                break;
+
+            case SerializerPlan::SegmentType::SUBMESSAGE:
+            {
+                const google::protobuf::Message* sub_message = &in;
+                for (const auto& field_and_index : segment.path)
+                {
+                    const google::protobuf::Reflection* sub_refl = sub_message->GetReflection();
+                    sub_message = field_and_index.first->is_repeated()
+                                      ? &sub_refl->GetRepeatedMessage(
+                                            *sub_message, field_and_index.first,
+                                            field_and_index.second)
+                                      : &sub_refl->GetMessage(*sub_message, field_and_index.first);
+                }
+                run_serializer(*segment.sub_plan, out, *sub_message, algorithms,
+                               repeated_delimiter, use_short_enum);
+            }
+            break;
+
+            case SerializerPlan::SegmentType::FIELD:
+            {
+                const google::protobuf::FieldDescriptor* field_desc = segment.field_desc;
+                if (field_desc->is_repeated())
+                {
+                    int start = segment.is_indexed_repeated_field ? segment.index : 0;
+                    int end = segment.is_indexed_repeated_field ? segment.index + 1
+                                                                : refl->FieldSize(in, field_desc);
+                    FormatTranslation::serialize_repeated(out, in, field_desc, start, end,
+                                                          segment.is_indexed_repeated_field,
+                                                          repeated_delimiter, use_short_enum);
+                    break;
+                }
+
+                switch (field_desc->cpp_type())
+                {
+                    case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+                        out << goby::util::hex_encode(
+                            refl->GetMessage(in, field_desc).SerializeAsString());
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+                        out << refl->GetInt32(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+                        out << refl->GetInt64(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+                        out << refl->GetUInt32(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                        out << refl->GetUInt64(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                        out << goby::util::as<std::string>(refl->GetBool(in, field_desc));
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                        if (field_desc->type() == google::protobuf::FieldDescriptor::TYPE_STRING)
+                            out << refl->GetString(in, field_desc);
+                        else if (field_desc->type() ==
+                                 google::protobuf::FieldDescriptor::TYPE_BYTES)
+                            out << goby::util::hex_encode(refl->GetString(in, field_desc));
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                        out << std::setprecision(std::numeric_limits<float>::digits10)
+                            << refl->GetFloat(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                        out << std::setprecision(std::numeric_limits<double>::digits10)
+                            << refl->GetDouble(in, field_desc);
+                        break;
+
+                    case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+                        out << (use_short_enum ? goby::moos::strip_name_from_enum(
+                                                     refl->GetEnum(in, field_desc)->name(),
+                                                     field_desc->name())
+                                               : refl->GetEnum(in, field_desc)->name());
+                        break;
+                }
+            }
+            break;
+        }
+    }
+}
+
+// mirrors the walk over the format string done by MOOSTranslation<TECHNIQUE_FORMAT>::parse
+std::shared_ptr<const ParserPlan> compile_parser(const google::protobuf::Descriptor* desc,
+                                                 std::string format)
+{
+    auto plan = std::make_shared<ParserPlan>();
+    boost::to_lower(format);
+
+    for (std::string::const_iterator i = format.begin(); i != format.end();)
+    {
+        ParserPlan::Step step;
+        if (*i != '%')
+        {
+            step.type = ParserPlan::StepType::LITERAL;
+            step.separator = *i++;
+            plan->steps.push_back(step);
+            continue;
+        }
+
+        ++i;
+        std::string specifier;
+        while (i != format.end() && *i != '%') specifier += *i++;
+        if (i == format.end())
+            return nullptr;
+        ++i;
+        step.separator = (i == format.end()) ? '\0' : *i;
+        step.specifier = specifier;
+
+        if (specifier.find(':') != std::string::npos)
+        {
+            std::vector<std::string> subfields;
+            boost::split(subfields, specifier, boost::is_any_of(":"));
+
+            const google::protobuf::Descriptor* sub_desc = desc;
+            for (int j = 0, n = subfields.size() - 1; j < n; ++j)
+            {
+                std::vector<std::string> field_and_index;
+                boost::split(field_and_index, subfields[j], boost::is_any_of("."));
+
+                const google::protobuf::FieldDescriptor* field_desc =
+                    sub_desc->FindFieldByNumber(goby::util::as<int>(field_and_index[0]));
+                if (!field_desc ||
+                    field_desc->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                    return nullptr;
+
+                int index = -1;
+                if (field_desc->is_repeated())
+                {
+                    if (field_and_index.size() != 2)
+                        return nullptr;
+                    index = goby::util::as<int>(field_and_index.at(1));
+                }
+                step.path.emplace_back(field_desc, index);
+                sub_desc = field_desc->message_type();
+            }
+
+            step.type = ParserPlan::StepType::SUBMESSAGE;
+            step.sub_plan = compile_parser(sub_desc, "%" + subfields[subfields.size() - 1] + "%");
+            if (!step.sub_plan)
+                return nullptr;
+        }
+        else
+        {
+            std::vector<std::string> field_and_index;
+            boost::split(field_and_index, specifier, boost::is_any_of("."));
+
+            step.type = ParserPlan::StepType::FIELD;
+            step.field_index = boost::lexical_cast<int>(field_and_index[0]);
+            step.is_indexed_repeated_field = field_and_index.size() == 2;
+            if (step.is_indexed_repeated_field)
+                step.value_index = boost::lexical_cast<int>(field_and_index[1]);
+
+            step.field_desc = desc->FindFieldByNumber(step.field_index);
+            if (!step.field_desc)
+                return nullptr;
+        }
+        plan->steps.push_back(step);
+    }
+
+    return plan;
+}
+
+void run_parser(const ParserPlan& plan, const std::string& in, google::protobuf::Message* out,
+                const ParserAlgorithms& algorithms, const std::string& repeated_delimiter,
+                bool use_short_enum)
+{
+    const std::string lower_in = boost::to_lower_copy(in);
+    // MOOSTranslation<TECHNIQUE_FORMAT>::parse erases the consumed part of the input instead
+    std::string::size_type pos = 0;
+
+    for (const auto& step : plan.steps)
+    {
+        if (step.type == ParserPlan::StepType::LITERAL)
+        {
+            std::string::size_type found = lower_in.find(step.separator, pos);
+            if (found != std::string::npos)
+                pos = found + 1;
+            continue;
+        }
+
+        std::string extract = in.substr(pos, lower_in.find(step.separator, pos) - pos);
+
+        if (step.type == ParserPlan::StepType::SUBMESSAGE)
+        {
+            google::protobuf::Message* sub_message = out;
+            for (const auto& field_and_index : step.path)
+            {
+                const google::protobuf::Reflection* sub_refl = sub_message->GetReflection();
+                if (field_and_index.first->is_repeated())
+                {
+                    while (sub_refl->FieldSize(*sub_message, field_and_index.first) <=
+                           field_and_index.second)
+                        sub_refl->AddMessage(sub_message, field_and_index.first);
+                    sub_message = sub_refl->MutableRepeatedMessage(
+                        sub_message, field_and_index.first, field_and_index.second);
+                }
+                else
+                {
+                    sub_message = sub_refl->MutableMessage(sub_message, field_and_index.first);
+                }
+            }
+            run_parser(*step.sub_plan, extract, sub_message, algorithms, repeated_delimiter,
+                       use_short_enum);
+        }
+        else
+        {
+            try
+            {
+                FormatTranslation::parse_field(extract, out, step.field_desc, step.field_index,
+                                               step.is_indexed_repeated_field, step.value_index,
+                                               repeated_delimiter, algorithms, use_short_enum);
+            }
+            catch (boost::bad_lexical_cast&)
+            {
+                throw(std::runtime_error("Bad specifier: " + step.specifier +
+                                         ", must be an integer. For message: " +
+                                         out->GetDescriptor()->full_name()));
+            }
+        }
+    }
+}
+
+} // namespace
+
+goby::moos::FormatSerializer::FormatSerializer(std::string format, std::string repeated_delimiter,
+                                               SerializerAlgorithms algorithms,
+                                               bool use_short_enum)
+    : format_(std::move(format)),
+      repeated_delimiter_(std::move(repeated_delimiter)),
+      algorithms_(std::move(algorithms)),
+      use_short_enum_(use_short_enum)
+{
+}
+
+goby::moos::FormatSerializer::~FormatSerializer() = default;
+
+std::shared_ptr<const goby::moos::FormatSerializer::Plan>
+goby::moos::FormatSerializer::plan(const google::protobuf::Descriptor* desc) const
+{
+    std::lock_guard<std::mutex> lock(plan_mutex_);
+    auto it = plans_.find(desc);
+    if (it == plans_.end())
+    {
+        std::shared_ptr<const Plan> compiled;
+        try
+        {
+            compiled = compile_serializer(desc, format_, algorithms_);
+        }
+        catch (std::exception&)
+        {
+            // leave it to MOOSTranslation to report the error on each call
+        }
+        it = plans_.insert(std::make_pair(desc, compiled)).first;
+    }
+    return it->second;
+}
+
+bool goby::moos::FormatSerializer::precompile(const google::protobuf::Descriptor* desc) const
+{
+    return plan(desc) != nullptr;
+}
+
+void goby::moos::FormatSerializer::serialize(std::string* out,
+                                             const google::protobuf::Message& in) const
+{
+    if (auto compiled = plan(in.GetDescriptor()))
+    {
+        std::ostringstream os;
+        run_serializer(*compiled, os, in, algorithms_, repeated_delimiter_, use_short_enum_);
+        *out = os.str();
+    }
+    else
+    {
+        FormatTranslation::serialize(out, in, algorithms_, format_, repeated_delimiter_,
+                                     use_short_enum_);
+    }
+}
+
+goby::moos::FormatParser::FormatParser(std::string format, std::string repeated_delimiter,
+                                       ParserAlgorithms algorithms, bool use_short_enum)
+    : format_(std::move(format)),
+      repeated_delimiter_(std::move(repeated_delimiter)),
+      algorithms_(std::move(algorithms)),
+      use_short_enum_(use_short_enum)
+{
+}
+
+goby::moos::FormatParser::~FormatParser() = default;
+
+std::shared_ptr<const goby::moos::FormatParser::Plan>
+goby::moos::FormatParser::plan(const google::protobuf::Descriptor* desc) const
+{
+    std::lock_guard<std::mutex> lock(plan_mutex_);
+    auto it = plans_.find(desc);
+    if (it == plans_.end())
+    {
+        std::shared_ptr<const Plan> compiled;
+        try
+        {
+            compiled = compile_parser(desc, format_);
+        }
+        catch (std::exception&)
+        {
+        }
+        it = plans_.insert(std::make_pair(desc, compiled)).first;
+    }
+    return it->second;
+}
+
+bool goby::moos::FormatParser::precompile(const google::protobuf::Descriptor* desc) const
+{
+    return plan(desc) != nullptr;
+}
+
+void goby::moos::FormatParser::parse(const std::string& in, google::protobuf::Message* out) const
+{
+    if (auto compiled = plan(out->GetDescriptor()))
+        run_parser(*compiled, in, out, algorithms_, repeated_delimiter_, use_short_enum_);
+    else
+        FormatTranslation::parse(in, out, format_, repeated_delimiter_, algorithms_,
+                                 use_short_enum_);
+}
@@ -0,0 +1,118 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_MOOS_MOOS_FORMAT_TRANSLATION_H
+#define GOBY_MOOS_MOOS_FORMAT_TRANSLATION_H
+
+#include <map>    // for map
+#include <memory> // for shared_ptr
+#include <mutex>  // for mutex
+#include <string> // for string
+
+#include <google/protobuf/descriptor.h> // for Descriptor
+#include <google/protobuf/message.h>    // for Message
+
+#include "goby/moos/protobuf/translator.pb.h" // for TranslatorEntry
+
+namespace goby
+{
+namespace moos
+{
+/// \brief Serializer for TECHNIQUE_FORMAT that compiles the format string once per Protobuf type into a plan of literal segments and field paths
+///
+/// Produces the same output as MOOSTranslation<TECHNIQUE_FORMAT>::serialize. Format strings using directives other than "%N%", "%N.M%", "%N:M%" and "%%" (e.g. printf-style directives) are passed to MOOSTranslation<TECHNIQUE_FORMAT>::serialize unchanged.
+class FormatSerializer
+{
+  public:
+    FormatSerializer(std::string format, std::string repeated_delimiter,
+                     google::protobuf::RepeatedPtrField<
+                         protobuf::TranslatorEntry::PublishSerializer::Algorithm>
+                         algorithms,
+                     bool use_short_enum);
+    ~FormatSerializer();
+
+    void serialize(std::string* out, const google::protobuf::Message& in) const;
+
+    /// \brief Compiles the plan for a given type ahead of the first call to serialize() for it
+    ///
+    /// \return true if the format is compiled, false if serialize() will use MOOSTranslation<TECHNIQUE_FORMAT>
+    bool precompile(const google::protobuf::Descriptor* desc) const;
+
+    struct Plan;
+
+  private:
+    std::shared_ptr<const Plan> plan(const google::protobuf::Descriptor* desc) const;
+
+  private:
+    const std::string format_;
+    const std::string repeated_delimiter_;
+    const google::protobuf::RepeatedPtrField<
+        protobuf::TranslatorEntry::PublishSerializer::Algorithm>
+        algorithms_;
+    const bool use_short_enum_;
+
+    mutable std::mutex plan_mutex_;
+    // nullptr plan means this format is not supported by the compiled serializer
+    mutable std::map<const google::protobuf::Descriptor*, std::shared_ptr<const Plan>> plans_;
+};
+
+/// \brief Parser for TECHNIQUE_FORMAT that compiles the format string once per Protobuf type into a plan of literal separators and field paths
+///
+/// Produces the same result as MOOSTranslation<TECHNIQUE_FORMAT>::parse. Format strings that do not compile (e.g. invalid field numbers) are passed to MOOSTranslation<TECHNIQUE_FORMAT>::parse unchanged, which reports the error.
+class FormatParser
+{
+  public:
+    FormatParser(
+        std::string format, std::string repeated_delimiter,
+        google::protobuf::RepeatedPtrField<protobuf::TranslatorEntry::CreateParser::Algorithm>
+            algorithms,
+        bool use_short_enum);
+    ~FormatParser();
+
+    void parse(const std::string& in, google::protobuf::Message* out) const;
+
+    /// \brief Compiles the plan for a given type ahead of the first call to parse() for it
+    ///
+    /// \return true if the format is compiled, false if parse() will use MOOSTranslation<TECHNIQUE_FORMAT>
+    bool precompile(const google::protobuf::Descriptor* desc) const;
+
+    struct Plan;
+
+  private:
+    std::shared_ptr<const Plan> plan(const google::protobuf::Descriptor* desc) const;
+
+  private:
+    const std::string format_;
+    const std::string repeated_delimiter_;
+    const google::protobuf::RepeatedPtrField<protobuf::TranslatorEntry::CreateParser::Algorithm>
+        algorithms_;
+    const bool use_short_enum_;
+
+    mutable std::mutex plan_mutex_;
+    mutable std::map<const google::protobuf::Descriptor*, std::shared_ptr<const Plan>> plans_;
+};
+
+} // namespace moos
+} // namespace goby
+
+#endif
@@ -837,6 +837,97 @@ template <> class MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>
         int index;
     };
 
+    /// \brief Writes the values [start, end) of a repeated field as used for a "%field%" or "%field.index%" specifier (values past the end of the field are written as the default)
+    static void serialize_repeated(std::ostream& out_repeated, const google::protobuf::Message& in,
+                                   const google::protobuf::FieldDescriptor* field_desc, int start,
+                                   int end, bool is_indexed_repeated_field,
+                                   const std::string& repeated_delimiter, bool use_short_enum)
+    {
+        const google::protobuf::Reflection* refl = in.GetReflection();
+        for (int j = start; j < end; ++j)
+        {
+            if (j && !is_indexed_repeated_field)
+                out_repeated << repeated_delimiter;
+            switch (field_desc->cpp_type())
+            {
+                case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+                    out_repeated << goby::util::hex_encode(
+                        refl->GetRepeatedMessage(in, field_desc, j).SerializeAsString());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+                    out_repeated << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedInt32(in, field_desc, j)
+                                         : std::numeric_limits<std::int32_t>::max());
+
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+                    out_repeated << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedInt64(in, field_desc, j)
+                                         : std::numeric_limits<std::int64_t>::max());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+                    out_repeated << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedUInt32(in, field_desc, j)
+                                         : std::numeric_limits<std::uint32_t>::max());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                    out_repeated << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedUInt64(in, field_desc, j)
+                                         : std::numeric_limits<std::uint64_t>::max());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                    out_repeated << std::boolalpha
+                                 << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedBool(in, field_desc, j)
+                                         : field_desc->default_value_bool());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                    if (field_desc->type() == google::protobuf::FieldDescriptor::TYPE_STRING)
+                        out_repeated << ((j < refl->FieldSize(in, field_desc))
+                                             ? refl->GetRepeatedString(in, field_desc, j)
+                                             : field_desc->default_value_string());
+                    else if (field_desc->type() == google::protobuf::FieldDescriptor::TYPE_BYTES)
+                        out_repeated << goby::util::hex_encode(
+                            ((j < refl->FieldSize(in, field_desc))
+                                 ? refl->GetRepeatedString(in, field_desc, j)
+                                 : field_desc->default_value_string()));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                    out_repeated << std::setprecision(std::numeric_limits<float>::digits10)
+                                 << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedFloat(in, field_desc, j)
+                                         : std::numeric_limits<float>::quiet_NaN());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                    out_repeated << std::setprecision(std::numeric_limits<double>::digits10)
+                                 << ((j < refl->FieldSize(in, field_desc))
+                                         ? refl->GetRepeatedDouble(in, field_desc, j)
+                                         : std::numeric_limits<double>::quiet_NaN());
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+                {
+                    const google::protobuf::EnumValueDescriptor* enum_val =
+                        ((j < refl->FieldSize(in, field_desc))
+                             ? refl->GetRepeatedEnum(in, field_desc, j)
+                             : field_desc->default_value_enum());
+                    out_repeated << ((use_short_enum)
+                                         ? strip_name_from_enum(enum_val->name(), field_desc->name())
+                                         : enum_val->name());
+                }
+                break;
+            }
+        }
+    }
+
     static void serialize(std::string* out, const google::protobuf::Message& in,
                           const google::protobuf::RepeatedPtrField<
                               protobuf::TranslatorEntry::PublishSerializer::Algorithm>& algorithms,
@@ -975,95 +1066,9 @@ template <> class MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>
                                                           : refl->FieldSize(in, field_desc);
 
                     std::stringstream out_repeated;
-                    for (int j = start; j < end; ++j)
-                    {
-                        if (j && !is_indexed_repeated_field)
-                            out_repeated << repeated_delimiter;
-                        switch (field_desc->cpp_type())
-                        {
-                            case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
-                                out_repeated << goby::util::hex_encode(
-                                    refl->GetRepeatedMessage(in, field_desc, j)
-                                        .SerializeAsString());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
-                                out_repeated << ((j < refl->FieldSize(in, field_desc))
-                                                     ? refl->GetRepeatedInt32(in, field_desc, j)
-                                                     : std::numeric_limits<std::int32_t>::max());
-
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
-                                out_repeated << ((j < refl->FieldSize(in, field_desc))
-                                                     ? refl->GetRepeatedInt64(in, field_desc, j)
-                                                     : std::numeric_limits<std::int64_t>::max());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
-                                out_repeated << ((j < refl->FieldSize(in, field_desc))
-                                                     ? refl->GetRepeatedUInt32(in, field_desc, j)
-                                                     : std::numeric_limits<std::uint32_t>::max());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
-                                out_repeated << ((j < refl->FieldSize(in, field_desc))
-                                                     ? refl->GetRepeatedUInt64(in, field_desc, j)
-                                                     : std::numeric_limits<std::uint64_t>::max());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
-                                out_repeated << std::boolalpha
-                                             << ((j < refl->FieldSize(in, field_desc))
-                                                     ? refl->GetRepeatedBool(in, field_desc, j)
-                                                     : field_desc->default_value_bool());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
-                                if (field_desc->type() ==
-                                    google::protobuf::FieldDescriptor::TYPE_STRING)
-                                    out_repeated
-                                        << ((j < refl->FieldSize(in, field_desc))
-                                                ? refl->GetRepeatedString(in, field_desc, j)
-                                                : field_desc->default_value_string());
-                                else if (field_desc->type() ==
-                                         google::protobuf::FieldDescriptor::TYPE_BYTES)
-                                    out_repeated << goby::util::hex_encode(
-                                        ((j < refl->FieldSize(in, field_desc))
-                                             ? refl->GetRepeatedString(in, field_desc, j)
-                                             : field_desc->default_value_string()));
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
-                                out_repeated
-                                    << std::setprecision(std::numeric_limits<float>::digits10)
-                                    << ((j < refl->FieldSize(in, field_desc))
-                                            ? refl->GetRepeatedFloat(in, field_desc, j)
-                                            : std::numeric_limits<float>::quiet_NaN());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
-                                out_repeated
-                                    << std::setprecision(std::numeric_limits<double>::digits10)
-                                    << ((j < refl->FieldSize(in, field_desc))
-                                            ? refl->GetRepeatedDouble(in, field_desc, j)
-                                            : std::numeric_limits<double>::quiet_NaN());
-                                break;
-
-                            case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
-                            {
-                                const google::protobuf::EnumValueDescriptor* enum_val =
-                                    ((j < refl->FieldSize(in, field_desc))
-                                         ? refl->GetRepeatedEnum(in, field_desc, j)
-                                         : field_desc->default_value_enum());
-                                out_repeated
-                                    << ((use_short_enum) ? strip_name_from_enum(enum_val->name(),
-                                                                                field_desc->name())
-                                                         : enum_val->name());
-                            }
-                            break;
-                        }
-                    }
+                    serialize_repeated(out_repeated, in, field_desc, start, end,
+                                       is_indexed_repeated_field, repeated_delimiter,
+                                       use_short_enum);
                     out_format % out_repeated.str();
                 }
                 else
@@ -1142,6 +1147,215 @@ template <> class MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>
         *out = out_format.str();
     }
 
+    /// \brief Sets the value(s) of a field from the string extracted for a "%field%" or "%field.index%" specifier, after running any algorithms whose primary field is field_index
+    static void parse_field(std::string extract, google::protobuf::Message* out,
+                            const google::protobuf::FieldDescriptor* field_desc, int field_index,
+                            bool is_indexed_repeated_field, int value_index,
+                            const std::string& repeated_delimiter,
+                            const google::protobuf::RepeatedPtrField<
+                                protobuf::TranslatorEntry::CreateParser::Algorithm>& algorithms,
+                            bool use_short_enum)
+    {
+        const google::protobuf::Reflection* refl = out->GetReflection();
+        // run algorithms
+        for (const auto& algorithm : algorithms)
+        {
+            goby::moos::transitional::DCCLMessageVal extract_val(extract);
+
+            if (algorithm.primary_field() == field_index)
+                moos::transitional::DCCLAlgorithmPerformer::getInstance()->run_algorithm(
+                    algorithm.name(), extract_val,
+                    std::vector<goby::moos::transitional::DCCLMessageVal>());
+
+            extract = std::string(extract_val);
+        }
+
+        std::vector<std::string> parts;
+        if (is_indexed_repeated_field || !field_desc->is_repeated())
+            parts.push_back(extract);
+        else
+            boost::split(parts, extract, boost::is_any_of(repeated_delimiter));
+
+        for (auto& part : parts)
+        {
+            switch (field_desc->cpp_type())
+            {
+                case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddMessage(out, field_desc);
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->MutableRepeatedMessage(out, field_desc, value_index)
+                                     ->ParseFromString(goby::util::hex_decode(part))
+                               : refl->AddMessage(out, field_desc)
+                                     ->ParseFromString(goby::util::hex_decode(part)))
+                        : refl->MutableMessage(out, field_desc)
+                              ->ParseFromString(goby::util::hex_decode(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddInt32(out, field_desc, field_desc->default_value_int32());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedInt32(
+                                     out, field_desc, value_index,
+                                     goby::util::as<google::protobuf::int32>(part))
+                               : refl->AddInt32(out, field_desc,
+                                                goby::util::as<google::protobuf::int32>(part)))
+                        : refl->SetInt32(out, field_desc,
+                                         goby::util::as<google::protobuf::int32>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddInt64(out, field_desc, field_desc->default_value_int64());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedInt64(
+                                     out, field_desc, value_index,
+                                     goby::util::as<google::protobuf::int64>(part))
+                               : refl->AddInt64(out, field_desc,
+                                                goby::util::as<google::protobuf::int64>(part)))
+                        : refl->SetInt64(out, field_desc,
+                                         goby::util::as<google::protobuf::int64>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddUInt32(out, field_desc, field_desc->default_value_uint32());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedUInt32(
+                                     out, field_desc, value_index,
+                                     goby::util::as<google::protobuf::uint32>(part))
+                               : refl->AddUInt32(out, field_desc,
+                                                 goby::util::as<google::protobuf::uint32>(part)))
+                        : refl->SetUInt32(out, field_desc,
+                                          goby::util::as<google::protobuf::uint32>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddUInt64(out, field_desc, field_desc->default_value_uint64());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedUInt64(
+                                     out, field_desc, value_index,
+                                     goby::util::as<google::protobuf::uint64>(part))
+                               : refl->AddUInt64(out, field_desc,
+                                                 goby::util::as<google::protobuf::uint64>(part)))
+                        : refl->SetUInt64(out, field_desc,
+                                          goby::util::as<google::protobuf::uint64>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddBool(out, field_desc, field_desc->default_value_bool());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedBool(out, field_desc, value_index,
+                                                       goby::util::as<bool>(part))
+                               : refl->AddBool(out, field_desc, goby::util::as<bool>(part)))
+                        : refl->SetBool(out, field_desc, goby::util::as<bool>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddString(out, field_desc, field_desc->default_value_string());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedString(out, field_desc, value_index, part)
+                               : refl->AddString(out, field_desc, part))
+                        : refl->SetString(out, field_desc, part);
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddFloat(out, field_desc, field_desc->default_value_float());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedFloat(out, field_desc, value_index,
+                                                        goby::util::as<float>(part))
+                               : refl->AddFloat(out, field_desc, goby::util::as<float>(part)))
+                        : refl->SetFloat(out, field_desc, goby::util::as<float>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddDouble(out, field_desc, field_desc->default_value_double());
+                    }
+                    field_desc->is_repeated()
+                        ? (is_indexed_repeated_field
+                               ? refl->SetRepeatedDouble(out, field_desc, value_index,
+                                                         goby::util::as<double>(part))
+                               : refl->AddDouble(out, field_desc, goby::util::as<double>(part)))
+                        : refl->SetDouble(out, field_desc, goby::util::as<double>(part));
+                    break;
+
+                case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+                {
+                    if (is_indexed_repeated_field)
+                    {
+                        while (refl->FieldSize(*out, field_desc) <= value_index)
+                            refl->AddEnum(out, field_desc, field_desc->default_value_enum());
+                    }
+                    std::string enum_value =
+                        ((use_short_enum) ? add_name_to_enum(part, field_desc->name()) : part);
+
+                    const google::protobuf::EnumValueDescriptor* enum_desc =
+                        refl->GetEnum(*out, field_desc)->type()->FindValueByName(enum_value);
+
+                    // try upper case
+                    if (!enum_desc)
+                        enum_desc = refl->GetEnum(*out, field_desc)
+                                        ->type()
+                                        ->FindValueByName(boost::to_upper_copy(enum_value));
+                    // try lower case
+                    if (!enum_desc)
+                        enum_desc = refl->GetEnum(*out, field_desc)
+                                        ->type()
+                                        ->FindValueByName(boost::to_lower_copy(enum_value));
+                    if (enum_desc)
+                    {
+                        field_desc->is_repeated()
+                            ? (is_indexed_repeated_field
+                                   ? refl->SetRepeatedEnum(out, field_desc, value_index, enum_desc)
+                                   : refl->AddEnum(out, field_desc, enum_desc))
+                            : refl->SetEnum(out, field_desc, enum_desc);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
     static void parse(const std::string& in, google::protobuf::Message* out, std::string format,
                       const std::string& repeated_delimiter,
                       const google::protobuf::RepeatedPtrField<
@@ -1241,241 +1455,9 @@ template <> class MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>
                             throw(std::runtime_error("Bad field: " + specifier +
                                                      " not in message " + desc->full_name()));
 
-                        // run algorithms
-                        for (const auto& algorithm : algorithms)
-                        {
-                            goby::moos::transitional::DCCLMessageVal extract_val(extract);
-
-                            if (algorithm.primary_field() == field_index)
-                                moos::transitional::DCCLAlgorithmPerformer::getInstance()
-                                    ->run_algorithm(
-                                        algorithm.name(), extract_val,
-                                        std::vector<goby::moos::transitional::DCCLMessageVal>());
-
-                            extract = std::string(extract_val);
-                        }
-
-                        std::vector<std::string> parts;
-                        if (is_indexed_repeated_field || !field_desc->is_repeated())
-                            parts.push_back(extract);
-                        else
-                            boost::split(parts, extract, boost::is_any_of(repeated_delimiter));
-
-                        for (auto& part : parts)
-                        {
-                            switch (field_desc->cpp_type())
-                            {
-                                case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddMessage(out, field_desc);
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->MutableRepeatedMessage(out, field_desc,
-                                                                              value_index)
-                                                     ->ParseFromString(goby::util::hex_decode(part))
-                                               : refl->AddMessage(out, field_desc)
-                                                     ->ParseFromString(
-                                                         goby::util::hex_decode(part)))
-                                        : refl->MutableMessage(out, field_desc)
-                                              ->ParseFromString(goby::util::hex_decode(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddInt32(out, field_desc,
-                                                           field_desc->default_value_int32());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedInt32(
-                                                     out, field_desc, value_index,
-                                                     goby::util::as<google::protobuf::int32>(part))
-                                               : refl->AddInt32(
-                                                     out, field_desc,
-                                                     goby::util::as<google::protobuf::int32>(part)))
-                                        : refl->SetInt32(
-                                              out, field_desc,
-                                              goby::util::as<google::protobuf::int32>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddInt64(out, field_desc,
-                                                           field_desc->default_value_int64());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedInt64(
-                                                     out, field_desc, value_index,
-                                                     goby::util::as<google::protobuf::int64>(part))
-                                               : refl->AddInt64(
-                                                     out, field_desc,
-                                                     goby::util::as<google::protobuf::int64>(part)))
-                                        : refl->SetInt64(
-                                              out, field_desc,
-                                              goby::util::as<google::protobuf::int64>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddUInt32(out, field_desc,
-                                                            field_desc->default_value_uint32());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedUInt32(
-                                                     out, field_desc, value_index,
-                                                     goby::util::as<google::protobuf::uint32>(part))
-                                               : refl->AddUInt32(
-                                                     out, field_desc,
-                                                     goby::util::as<google::protobuf::uint32>(
-                                                         part)))
-                                        : refl->SetUInt32(
-                                              out, field_desc,
-                                              goby::util::as<google::protobuf::uint32>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddUInt64(out, field_desc,
-                                                            field_desc->default_value_uint64());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedUInt64(
-                                                     out, field_desc, value_index,
-                                                     goby::util::as<google::protobuf::uint64>(part))
-                                               : refl->AddUInt64(
-                                                     out, field_desc,
-                                                     goby::util::as<google::protobuf::uint64>(
-                                                         part)))
-                                        : refl->SetUInt64(
-                                              out, field_desc,
-                                              goby::util::as<google::protobuf::uint64>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddBool(out, field_desc,
-                                                          field_desc->default_value_bool());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedBool(out, field_desc, value_index,
-                                                                       goby::util::as<bool>(part))
-                                               : refl->AddBool(out, field_desc,
-                                                               goby::util::as<bool>(part)))
-                                        : refl->SetBool(out, field_desc,
-                                                        goby::util::as<bool>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddString(out, field_desc,
-                                                            field_desc->default_value_string());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedString(out, field_desc,
-                                                                         value_index, part)
-                                               : refl->AddString(out, field_desc, part))
-                                        : refl->SetString(out, field_desc, part);
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddFloat(out, field_desc,
-                                                           field_desc->default_value_float());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedFloat(out, field_desc,
-                                                                        value_index,
-                                                                        goby::util::as<float>(part))
-                                               : refl->AddFloat(out, field_desc,
-                                                                goby::util::as<float>(part)))
-                                        : refl->SetFloat(out, field_desc,
-                                                         goby::util::as<float>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddDouble(out, field_desc,
-                                                            field_desc->default_value_double());
-                                    }
-                                    field_desc->is_repeated()
-                                        ? (is_indexed_repeated_field
-                                               ? refl->SetRepeatedDouble(
-                                                     out, field_desc, value_index,
-                                                     goby::util::as<double>(part))
-                                               : refl->AddDouble(out, field_desc,
-                                                                 goby::util::as<double>(part)))
-                                        : refl->SetDouble(out, field_desc,
-                                                          goby::util::as<double>(part));
-                                    break;
-
-                                case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
-                                {
-                                    if (is_indexed_repeated_field)
-                                    {
-                                        while (refl->FieldSize(*out, field_desc) <= value_index)
-                                            refl->AddEnum(out, field_desc,
-                                                          field_desc->default_value_enum());
-                                    }
-                                    std::string enum_value =
-                                        ((use_short_enum)
-                                             ? add_name_to_enum(part, field_desc->name())
-                                             : part);
-
-                                    const google::protobuf::EnumValueDescriptor* enum_desc =
-                                        refl->GetEnum(*out, field_desc)
-                                            ->type()
-                                            ->FindValueByName(enum_value);
-
-                                    // try upper case
-                                    if (!enum_desc)
-                                        enum_desc =
-                                            refl->GetEnum(*out, field_desc)
-                                                ->type()
-                                                ->FindValueByName(boost::to_upper_copy(enum_value));
-                                    // try lower case
-                                    if (!enum_desc)
-                                        enum_desc =
-                                            refl->GetEnum(*out, field_desc)
-                                                ->type()
-                                                ->FindValueByName(boost::to_lower_copy(enum_value));
-                                    if (enum_desc)
-                                    {
-                                        field_desc->is_repeated()
-                                            ? (is_indexed_repeated_field
-                                                   ? refl->SetRepeatedEnum(out, field_desc,
-                                                                           value_index, enum_desc)
-                                                   : refl->AddEnum(out, field_desc, enum_desc))
-                                            : refl->SetEnum(out, field_desc, enum_desc);
-                                    }
-                                }
-                                break;
-                            }
-                        }
+                        parse_field(extract, out, field_desc, field_index,
+                                    is_indexed_repeated_field, value_index, repeated_delimiter,
+                                    algorithms, use_short_enum);
                     }
                     catch (boost::bad_lexical_cast&)
                     {
@@ -121,6 +121,69 @@ void goby::moos::MOOSTranslator::initialize(double lat_origin, double lon_origin
     update_utm_datum(lat_origin, lon_origin);
 }
 
+void goby::moos::MOOSTranslator::compile_format_translators(
+    const goby::moos::protobuf::TranslatorEntry& entry)
+{
+    FormatTranslators& translators = format_translators_[entry.protobuf_name()];
+    translators.publish_moos_var.resize(entry.publish_size());
+    translators.publish_format.resize(entry.publish_size());
+    translators.create_format.resize(entry.create_size());
+    translators.create_parser.resize(entry.create_size());
+
+    for (int i = 0, n = entry.publish_size(); i < n; ++i)
+    {
+        const auto& publish = entry.publish(i);
+        if (publish.technique() != protobuf::TranslatorEntry::TECHNIQUE_FORMAT)
+            continue;
+        translators.publish_moos_var[i] = std::make_shared<FormatSerializer>(
+            publish.moos_var(), publish.repeated_delimiter(), publish.algorithm(),
+            entry.use_short_enum());
+        translators.publish_format[i] =
+            std::make_shared<FormatSerializer>(publish.format(), publish.repeated_delimiter(),
+                                               publish.algorithm(), entry.use_short_enum());
+    }
+
+    for (int i = 0, n = entry.create_size(); i < n; ++i)
+    {
+        const auto& create = entry.create(i);
+        if (create.technique() != protobuf::TranslatorEntry::TECHNIQUE_FORMAT)
+            continue;
+        // protobuf_to_inverse_moos does not run the algorithms
+        translators.create_format[i] = std::make_shared<FormatSerializer>(
+            create.format(), create.repeated_delimiter(),
+            google::protobuf::RepeatedPtrField<
+                protobuf::TranslatorEntry::PublishSerializer::Algorithm>(),
+            entry.use_short_enum());
+        translators.create_parser[i] =
+            std::make_shared<FormatParser>(create.format(), create.repeated_delimiter(),
+                                           create.algorithm(), entry.use_short_enum());
+    }
+
+    // the type may not be loaded yet (e.g. pTranslator loads libraries after reading its
+    // configuration), in which case the plans are compiled on first use
+    const google::protobuf::Descriptor* desc = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(goby::moos::dynamic_parse_mutex);
+        desc = dccl::DynamicProtobufManager::find_descriptor(entry.protobuf_name());
+    }
+
+    if (desc)
+    {
+        for (const auto& serializer : translators.publish_moos_var)
+            if (serializer)
+                serializer->precompile(desc);
+        for (const auto& serializer : translators.publish_format)
+            if (serializer)
+                serializer->precompile(desc);
+        for (const auto& serializer : translators.create_format)
+            if (serializer)
+                serializer->precompile(desc);
+        for (const auto& parser : translators.create_parser)
+            if (parser)
+                parser->precompile(desc);
+    }
+}
+
 void goby::moos::alg_power_to_dB(moos::transitional::DCCLMessageVal& val_to_mod)
 {
     val_to_mod = 10 * log10(double(val_to_mod));
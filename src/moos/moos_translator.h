@@ -27,6 +27,7 @@
 
 #include <limits>    // for numeric_limits
 #include <map>       // for map, multimap
+#include <memory>    // for shared_ptr
 #include <mutex>     // for lock_guard, mutex
 #include <ostream>   // for operator<<, bas...
 #include <set>       // for set
@@ -43,11 +44,12 @@
 #include <google/protobuf/message.h>                 // for Message
 
 #include "dccl/dynamic_protobuf_manager.h"    // for DynamicProtobuf...
-#include "goby/moos/modem_id_convert.h"       // for ModemIdConvert
-#include "goby/moos/moos_protobuf_helpers.h"  // for MOOSTranslation
-#include "goby/moos/protobuf/translator.pb.h" // for TranslatorEntry
-#include "goby/util/as.h"                     // for as
-#include "moos_geodesy.h"                     // for CMOOSGeodesy
+#include "goby/moos/modem_id_convert.h"        // for ModemIdConvert
+#include "goby/moos/moos_format_translation.h" // for FormatSerializer
+#include "goby/moos/moos_protobuf_helpers.h"   // for MOOSTranslation
+#include "goby/moos/protobuf/translator.pb.h"  // for TranslatorEntry
+#include "goby/util/as.h"                      // for as
+#include "moos_geodesy.h"                      // for CMOOSGeodesy
 
 namespace goby
 {
@@ -112,13 +114,18 @@ class MOOSTranslator
         add_entry(entries);
     }
 
-    void clear_entry(const std::string& protobuf_name) { dictionary_.erase(protobuf_name); }
+    void clear_entry(const std::string& protobuf_name)
+    {
+        dictionary_.erase(protobuf_name);
+        format_translators_.erase(protobuf_name);
+    }
 
     void add_entry(const goby::moos::protobuf::TranslatorEntry& entry)
     {
         if (dictionary_.count(entry.protobuf_name()))
             throw(std::runtime_error("Duplicate translator entry for " + entry.protobuf_name()));
         dictionary_[entry.protobuf_name()] = entry;
+        compile_format_translators(entry);
     }
 
     void add_entry(const std::set<goby::moos::protobuf::TranslatorEntry>& entries)
@@ -188,6 +195,9 @@ class MOOSTranslator
                     double lon_origin = std::numeric_limits<double>::quiet_NaN(),
                     const std::string& modem_id_lookup_path = "");
 
+    // creates the FormatSerializer/FormatParser for each TECHNIQUE_FORMAT publish/create in entry
+    void compile_format_translators(const goby::moos::protobuf::TranslatorEntry& entry);
+
     void alg_lat2utm_y(moos::transitional::DCCLMessageVal& mv,
                        const std::vector<moos::transitional::DCCLMessageVal>& ref_vals);
 
@@ -206,6 +216,17 @@ class MOOSTranslator
 
   private:
     std::map<std::string, goby::moos::protobuf::TranslatorEntry> dictionary_;
+
+    // compiled TECHNIQUE_FORMAT translators, indexed the same as TranslatorEntry publish/create
+    // (nullptr for other techniques)
+    struct FormatTranslators
+    {
+        std::vector<std::shared_ptr<const FormatSerializer>> publish_moos_var;
+        std::vector<std::shared_ptr<const FormatSerializer>> publish_format;
+        std::vector<std::shared_ptr<const FormatSerializer>> create_format;
+        std::vector<std::shared_ptr<const FormatParser>> create_parser;
+    };
+    std::map<std::string, FormatTranslators> format_translators_;
     CMOOSGeodesy geodesy_;
     goby::moos::ModemIdConvert modem_lookup_;
 };
@@ -250,6 +271,7 @@ goby::moos::MOOSTranslator::protobuf_to_moos(const google::protobuf::Message& pr
         throw(std::runtime_error("No TranslatorEntry for Protobuf type: " + pb_name));
 
     const goby::moos::protobuf::TranslatorEntry& entry = it->second;
+    const FormatTranslators& format_translators = format_translators_.at(pb_name);
 
     std::multimap<std::string, CMOOSMsg> moos_msgs;
 
@@ -309,15 +331,9 @@ goby::moos::MOOSTranslator::protobuf_to_moos(const google::protobuf::Message& pr
 
             case protobuf::TranslatorEntry::TECHNIQUE_FORMAT:
                 // process moos_variable too (can be a format string itself!)
-                goby::moos::MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>::serialize(
-                    &moos_var, protobuf_msg, entry.publish(i).algorithm(),
-                    entry.publish(i).moos_var(), entry.publish(i).repeated_delimiter(),
-                    entry.use_short_enum());
+                format_translators.publish_moos_var[i]->serialize(&moos_var, protobuf_msg);
                 // now do the format values
-                goby::moos::MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>::serialize(
-                    &return_string, protobuf_msg, entry.publish(i).algorithm(),
-                    entry.publish(i).format(), entry.publish(i).repeated_delimiter(),
-                    entry.use_short_enum());
+                format_translators.publish_format[i]->serialize(&return_string, protobuf_msg);
                 break;
         }
 
@@ -341,6 +357,7 @@ goby::moos::MOOSTranslator::protobuf_to_inverse_moos(const google::protobuf::Mes
         throw(std::runtime_error("No TranslatorEntry for Protobuf type: " + pb_name));
 
     const goby::moos::protobuf::TranslatorEntry& entry = it->second;
+    const FormatTranslators& format_translators = format_translators_.at(pb_name);
 
     std::multimap<std::string, CMOOSMsg> moos_msgs;
 
@@ -408,16 +425,8 @@ goby::moos::MOOSTranslator::protobuf_to_inverse_moos(const google::protobuf::Mes
             break;
 
             case protobuf::TranslatorEntry::TECHNIQUE_FORMAT:
-            {
-                google::protobuf::RepeatedPtrField<
-                    protobuf::TranslatorEntry::PublishSerializer::Algorithm>
-                    empty_algorithms;
-
-                goby::moos::MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>::serialize(
-                    &return_string, protobuf_msg, empty_algorithms, entry.create(i).format(),
-                    entry.create(i).repeated_delimiter(), entry.use_short_enum());
-            }
-            break;
+                format_translators.create_format[i]->serialize(&return_string, protobuf_msg);
+                break;
         }
 
         moos_msgs.insert(
@@ -457,6 +466,7 @@ goby::moos::MOOSTranslator::moos_to_protobuf(const StringCMOOSMsgMap& moos_varia
         throw(std::runtime_error("No TranslatorEntry for Protobuf type: " + protobuf_name));
 
     const goby::moos::protobuf::TranslatorEntry& entry = it->second;
+    const FormatTranslators& format_translators = format_translators_.at(protobuf_name);
 
     GoogleProtobufMessagePointer msg;
 
@@ -527,10 +537,7 @@ goby::moos::MOOSTranslator::moos_to_protobuf(const StringCMOOSMsgMap& moos_varia
                 break;
 
             case protobuf::TranslatorEntry::TECHNIQUE_FORMAT:
-                goby::moos::MOOSTranslation<protobuf::TranslatorEntry::TECHNIQUE_FORMAT>::parse(
-                    source_string, &*msg, entry.create(i).format(),
-                    entry.create(i).repeated_delimiter(), entry.create(i).algorithm(),
-                    entry.use_short_enum());
+                format_translators.create_parser[i]->parse(source_string, &*msg);
                 break;
         }
     }
@@ -0,0 +1,355 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+// Checks that DynamicBuffer::top() selects exactly the same values as a linear priority
+// contest over every subbuffer (the previous implementation, reproduced below as
+// LinearContestBuffer) for a randomized modem workload, and reports the time spent in top()
+// by each.
+//
+// Usage: goby_test_dynamic_buffer2 [num_dest] [subbuffers_per_dest] [num_requests]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+
+#include "goby/acomms/buffer/dynamic_buffer.h"
+
+struct TestClock
+{
+    typedef std::chrono::microseconds duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<TestClock>;
+    static const bool is_steady = true;
+
+    static time_point now() noexcept { return sim_now_; }
+
+    static void increment(duration dur) { sim_now_ += dur; }
+
+  private:
+    static time_point sim_now_;
+};
+
+TestClock::time_point TestClock::sim_now_{std::chrono::seconds(1)};
+
+using Buffer = goby::acomms::DynamicBuffer<std::string, TestClock>;
+
+// DynamicBuffer::top() prior to the indexed scheduler: every subbuffer's value is computed
+// (scanning all its entries for one not waiting for an ack) on each call
+class LinearContestBuffer
+{
+  public:
+    void create(int dest, const std::string& id,
+                const goby::acomms::protobuf::DynamicBufferConfig& cfg)
+    {
+        sub_[dest].insert(std::make_pair(id, Sub(cfg)));
+    }
+
+    void push(const Buffer::Value& v)
+    {
+        auto& sub = sub_.at(v.modem_id).at(v.subbuffer_id);
+        sub.data.push_front(std::make_pair(zero_point_, Entry{v.push_time, v.data}));
+        while (sub.data.size() > sub.cfg.max_queue()) sub.data.pop_back();
+    }
+
+    bool erase(const Buffer::Value& v)
+    {
+        auto& data = sub_.at(v.modem_id).at(v.subbuffer_id).data;
+        for (auto it = data.begin(), end = data.end(); it != end; ++it)
+        {
+            if (it->second.push_time == v.push_time && it->second.data == v.data)
+            {
+                data.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void expire()
+    {
+        auto now = TestClock::now();
+        for (auto& dest_p : sub_)
+        {
+            for (auto& sub_p : dest_p.second)
+            {
+                auto& sub = sub_p.second;
+                auto ttl = goby::time::convert_duration<TestClock::duration>(
+                    sub.cfg.ttl_with_units());
+                while (!sub.data.empty() && now > sub.data.back().second.push_time + ttl)
+                    sub.data.pop_back();
+            }
+        }
+    }
+
+    Buffer::Value top(int dest_id, std::size_t max_bytes, TestClock::duration ack_timeout)
+    {
+        auto now = TestClock::now();
+        if (dest_id != goby::acomms::QUERY_DESTINATION_ID && !sub_.count(dest_id))
+            throw(goby::acomms::DynamicBufferNoDataException());
+
+        std::map<std::string, Sub>::iterator winning_sub;
+        double winning_value = -std::numeric_limits<double>::infinity();
+
+        for (auto dest_it = (dest_id == goby::acomms::QUERY_DESTINATION_ID) ? sub_.begin()
+                                                                            : sub_.find(dest_id),
+                  dest_end = (dest_id == goby::acomms::QUERY_DESTINATION_ID)
+                                 ? sub_.end()
+                                 : ++sub_.find(dest_id);
+             dest_it != dest_end; ++dest_it)
+        {
+            for (auto sub_it = dest_it->second.begin(), sub_end = dest_it->second.end();
+                 sub_it != sub_end; ++sub_it)
+            {
+                double value = top_value(sub_it->second, now, max_bytes, ack_timeout);
+                // as before, the debug string was built whether or not it was logged
+                std::string value_or_reason = std::to_string(value);
+                if (value > winning_value)
+                {
+                    winning_value = value;
+                    winning_sub = sub_it;
+                    dest_id = dest_it->first;
+                }
+            }
+        }
+
+        if (winning_value == -std::numeric_limits<double>::infinity())
+            throw(goby::acomms::DynamicBufferNoDataException());
+
+        for (auto& datum_pair : winning_sub->second.data)
+        {
+            auto& last_send = datum_pair.first;
+            if (last_send == zero_point_ || last_send + ack_timeout < now)
+            {
+                winning_sub->second.last_access = now;
+                last_send = now;
+                return {dest_id, winning_sub->first, datum_pair.second.push_time,
+                        datum_pair.second.data};
+            }
+        }
+        throw(goby::acomms::DynamicBufferNoDataException());
+    }
+
+  private:
+    struct Entry
+    {
+        TestClock::time_point push_time;
+        std::string data;
+    };
+
+    struct Sub
+    {
+        Sub(const goby::acomms::protobuf::DynamicBufferConfig& c) : cfg(c) {}
+        goby::acomms::protobuf::DynamicBufferConfig cfg;
+        std::deque<std::pair<TestClock::time_point, Entry>> data;
+        TestClock::time_point last_access{TestClock::now()};
+    };
+
+    double top_value(const Sub& sub, TestClock::time_point now, std::size_t max_bytes,
+                     TestClock::duration ack_timeout)
+    {
+        const double ninf = -std::numeric_limits<double>::infinity();
+        if (sub.data.empty())
+            return ninf;
+        if (now <= sub.last_access + goby::time::convert_duration<TestClock::duration>(
+                                         sub.cfg.blackout_time_with_units()))
+            return ninf;
+        if (sub.data.front().second.data.size() > max_bytes)
+            return ninf;
+
+        bool all_waiting_for_ack = true;
+        for (const auto& datum_pair : sub.data)
+        {
+            if (datum_pair.first == zero_point_ || datum_pair.first + ack_timeout < now)
+            {
+                all_waiting_for_ack = false;
+                break;
+            }
+        }
+        if (all_waiting_for_ack)
+            return ninf;
+
+        using Duration = std::chrono::microseconds;
+        double dt = std::chrono::duration_cast<Duration>(now - sub.last_access).count();
+        double ttl = goby::time::convert_duration<Duration>(sub.cfg.ttl_with_units()).count();
+        return sub.cfg.value_base() * dt / ttl;
+    }
+
+    std::map<int, std::map<std::string, Sub>> sub_;
+    TestClock::time_point zero_point_{std::chrono::seconds(0)};
+};
+
+int main(int argc, char* argv[])
+{
+    int num_dest = argc > 1 ? std::atoi(argv[1]) : 10;
+    int subs_per_dest = argc > 2 ? std::atoi(argv[2]) : 20;
+    int num_requests = argc > 3 ? std::atoi(argv[3]) : 5000;
+
+    std::mt19937 rng(1);
+    auto uniform = [&](int a, int b) { return std::uniform_int_distribution<int>(a, b)(rng); };
+
+    Buffer indexed;
+    LinearContestBuffer linear;
+
+    std::vector<std::pair<int, std::string>> ids;
+    std::set<std::pair<int, std::string>> ack_required;
+    for (int dest = 1; dest <= num_dest; ++dest)
+    {
+        for (int i = 0; i < subs_per_dest; ++i)
+        {
+            goby::acomms::protobuf::DynamicBufferConfig cfg;
+            cfg.set_value_base(uniform(1, 100));
+            cfg.set_ttl(uniform(30, 600));
+            cfg.set_blackout_time(uniform(0, 2) == 0 ? uniform(1, 20) : 0);
+            cfg.set_max_queue(uniform(5, 50));
+            cfg.set_ack_required(uniform(0, 3) == 0);
+
+            std::string id = "sub" + std::to_string(i);
+            indexed.create(dest, id, cfg);
+            linear.create(dest, id, cfg);
+            ids.push_back(std::make_pair(dest, id));
+            if (cfg.ack_required())
+                ack_required.insert(ids.back());
+        }
+    }
+
+    std::chrono::nanoseconds indexed_time(0), linear_time(0);
+    int num_values = 0;
+    std::vector<std::pair<TestClock::time_point, Buffer::Value>> pending_ack;
+    const auto ack_timeout = std::chrono::seconds(10);
+
+    for (int request = 0; request < num_requests; ++request)
+    {
+        TestClock::increment(std::chrono::milliseconds(uniform(1, 2000)));
+
+        // most subbuffers are empty at any given time
+        for (int i = 0, n = uniform(0, 3); i < n; ++i)
+        {
+            const auto& id = ids[uniform(0, ids.size() - 1)];
+            Buffer::Value v{id.first, id.second, TestClock::now(),
+                            std::string(uniform(5, 60), 'a' + request % 26)};
+            indexed.push(v);
+            linear.push(v);
+        }
+
+        for (auto it = pending_ack.begin(); it != pending_ack.end();)
+        {
+            if (it->first < TestClock::now())
+            {
+                bool indexed_erased = indexed.erase(it->second);
+                bool linear_erased = linear.erase(it->second);
+                if (indexed_erased != linear_erased)
+                {
+                    std::cerr << "Mismatch erasing at request " << request << std::endl;
+                    return 1;
+                }
+                it = pending_ack.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (request % 100 == 0)
+        {
+            indexed.expire();
+            linear.expire();
+        }
+
+        // fill a frame
+        int dest = uniform(0, 1) ? goby::acomms::QUERY_DESTINATION_ID : uniform(1, num_dest);
+        std::size_t bytes_left = uniform(32, 256);
+        for (;;)
+        {
+            bool indexed_no_data = false, linear_no_data = false;
+            Buffer::Value indexed_value, linear_value;
+
+            auto start = std::chrono::steady_clock::now();
+            try
+            {
+                indexed_value = indexed.top(dest, bytes_left, ack_timeout);
+            }
+            catch (goby::acomms::DynamicBufferNoDataException&)
+            {
+                indexed_no_data = true;
+            }
+            auto middle = std::chrono::steady_clock::now();
+            try
+            {
+                linear_value = linear.top(dest, bytes_left, ack_timeout);
+            }
+            catch (goby::acomms::DynamicBufferNoDataException&)
+            {
+                linear_no_data = true;
+            }
+            auto end = std::chrono::steady_clock::now();
+            indexed_time += middle - start;
+            linear_time += end - middle;
+
+            if (indexed_no_data != linear_no_data ||
+                (!indexed_no_data && (indexed_value.modem_id != linear_value.modem_id ||
+                                      indexed_value.subbuffer_id != linear_value.subbuffer_id ||
+                                      indexed_value.push_time != linear_value.push_time ||
+                                      indexed_value.data != linear_value.data)))
+            {
+                std::cerr << "Mismatch at request " << request << ": indexed: "
+                          << (indexed_no_data ? "no data" : indexed_value.subbuffer_id)
+                          << ", linear: "
+                          << (linear_no_data ? "no data" : linear_value.subbuffer_id)
+                          << std::endl;
+                return 1;
+            }
+
+            if (indexed_no_data)
+                break;
+
+            ++num_values;
+            dest = indexed_value.modem_id;
+            bytes_left -= indexed_value.data.size();
+
+            if (ack_required.count(
+                    std::make_pair(indexed_value.modem_id, indexed_value.subbuffer_id)))
+            {
+                pending_ack.push_back(std::make_pair(
+                    TestClock::now() + std::chrono::seconds(uniform(1, 20)), indexed_value));
+            }
+            else
+            {
+                indexed.erase(indexed_value);
+                linear.erase(linear_value);
+            }
+        }
+    }
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::cout << num_dest << " destinations x " << subs_per_dest << " subbuffers, "
+              << num_requests << " requests, " << num_values << " values" << std::endl;
+    std::cout << "indexed top(): " << ms(indexed_time).count() << " ms" << std::endl;
+    std::cout << "linear contest top(): " << ms(linear_time).count() << " ms" << std::endl;
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
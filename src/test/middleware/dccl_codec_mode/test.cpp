@@ -0,0 +1,150 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "goby/middleware/marshalling/dccl.h"
+#include "goby/util/debug_logger.h"
+
+#include "goby/test/middleware/dccl_codec_mode/test.pb.h"
+
+// tests DCCL encoding and decoding from many threads, and benchmarks the throughput (contention)
+// for the selected codec mode
+// usage: goby_test_dccl_codec_mode [shared|thread_local]
+
+using goby::middleware::MarshallingScheme;
+using goby::middleware::detail::DCCLSerializerParserHelperBase;
+using goby::test::middleware::protobuf::CTDSample;
+
+using CTDHelper = goby::middleware::SerializerParserHelper<CTDSample, MarshallingScheme::DCCL>;
+using DynamicHelper =
+    goby::middleware::SerializerParserHelper<google::protobuf::Message, MarshallingScheme::DCCL>;
+
+const int messages_per_thread = 20000;
+
+// encode and decode messages_per_thread messages, alternating between the static and dynamic
+// parsers, checking that each comes back intact
+void encode_decode(int thread_index, std::atomic<int>& failures)
+{
+    for (int i = 0; i < messages_per_thread; ++i)
+    {
+        CTDSample sample;
+        sample.set_salinity((i % 400) / 10.0);
+        sample.set_temperature(3 + (thread_index % 27));
+        sample.set_depth(i % 5000);
+
+        std::vector<char> bytes = CTDHelper::serialize(sample);
+
+        std::vector<char>::const_iterator actual_end;
+        std::shared_ptr<const google::protobuf::Message> parsed;
+        if (i % 2)
+            parsed = CTDHelper::parse(bytes.cbegin(), bytes.cend(), actual_end);
+        else
+            parsed = DynamicHelper::parse(bytes.cbegin(), bytes.cend(), actual_end,
+                                          CTDSample::descriptor()->full_name());
+
+        CTDSample decoded;
+        decoded.CopyFrom(*parsed);
+        bool intact = std::abs(decoded.salinity() - sample.salinity()) < 0.05 &&
+                      decoded.temperature() == sample.temperature() &&
+                      decoded.depth() == sample.depth();
+        if (actual_end != bytes.cend() || !intact)
+            ++failures;
+    }
+}
+
+void benchmark(int num_threads)
+{
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; ++t)
+        threads.emplace_back([t, &failures]() { encode_decode(t, failures); });
+    for (auto& thread : threads) thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    assert(failures == 0);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    int total = num_threads * messages_per_thread;
+    std::cout << num_threads << " thread(s): " << total << " encode/decode in " << seconds
+              << " s (" << std::fixed << std::setprecision(0) << total / seconds << " msgs/s)"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    goby::glog.add_stream(goby::util::logger::WARN, &std::cerr);
+    goby::glog.set_name(argv[0]);
+    goby::glog.set_lock_action(goby::util::logger_lock::lock);
+
+    std::string mode = (argc > 1) ? argv[1] : "shared";
+    if (mode == "shared")
+    {
+        DCCLSerializerParserHelperBase::set_codec_mode(
+            DCCLSerializerParserHelperBase::CodecMode::SHARED);
+    }
+    else if (mode == "thread_local")
+    {
+        DCCLSerializerParserHelperBase::set_codec_mode(
+            DCCLSerializerParserHelperBase::CodecMode::THREAD_LOCAL);
+    }
+    else
+    {
+        std::cerr << "Usage: " << argv[0] << " [shared|thread_local]" << std::endl;
+        return 1;
+    }
+    std::cout << "Codec mode: " << mode << std::endl;
+
+    // a type loaded by one thread must be usable from the others (e.g. by unpack())
+    std::vector<char> bytes;
+    std::thread loader([&bytes]() {
+        CTDSample sample;
+        sample.set_depth(100);
+        bytes = CTDHelper::serialize(sample);
+    });
+    loader.join();
+
+    auto packets = DCCLSerializerParserHelperBase::unpack(std::string(bytes.begin(), bytes.end()));
+    assert(packets.frame_size() == 1);
+    assert(static_cast<unsigned>(packets.frame(0).dccl_id()) == CTDHelper::id());
+    assert(DCCLSerializerParserHelperBase::id(CTDSample::descriptor()->full_name()) == 127);
+
+    std::vector<int> thread_counts{1, 2, 4};
+    int hardware_threads = std::thread::hardware_concurrency();
+    if (hardware_threads > 4)
+        thread_counts.push_back(hardware_threads);
+
+    for (int num_threads : thread_counts) benchmark(num_threads);
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "goby/middleware/group.h"
+#include "goby/middleware/transport/interthread.h"
+
+// tests Group equality and hashing, and benchmarks the Group keyed lookups done by
+// SubscriptionStore::publish/poll against the previous string building implementation
+
+using goby::middleware::DynamicGroup;
+using goby::middleware::Group;
+
+extern constexpr Group nav{"navigation"};
+extern constexpr Group nav_numeric{"navigation", 3};
+extern constexpr Group numeric_only{3};
+extern constexpr Group bench{"bench"};
+
+// compile time identifier
+static_assert(nav.string_id() == Group::string_id("navigation"), "string_id not constexpr");
+
+// Group equality and hashing prior to string identifiers
+struct StringGroupHash
+{
+    size_t operator()(const Group& group) const noexcept
+    {
+        return std::hash<std::string>{}(std::string(group));
+    }
+};
+
+struct StringGroupEqual
+{
+    bool operator()(const Group& a, const Group& b) const
+    {
+        if (a.c_str() != nullptr && b.c_str() != nullptr)
+            return (std::string(a.c_str()) == std::string(b.c_str())) &&
+                   (a.numeric() == b.numeric());
+        else
+            return a.numeric() == b.numeric();
+    }
+};
+
+void test_equality()
+{
+    DynamicGroup dyn_nav("navigation");
+    DynamicGroup dyn_nav_numeric("navigation", 3);
+    DynamicGroup dyn_other("navigatioN");
+
+    assert(nav == dyn_nav);
+    assert(dyn_nav == nav);
+    assert(nav != nav_numeric);
+    assert(nav_numeric == dyn_nav_numeric);
+    assert(nav != dyn_other);
+    assert(Group("") == DynamicGroup(""));
+    assert(Group("") != nav);
+
+    // a group without a string value compares on the numeric value only
+    assert(numeric_only == nav_numeric);
+    assert(numeric_only != nav);
+    assert(numeric_only == DynamicGroup(3));
+
+    std::hash<Group> hash;
+    assert(hash(nav) == hash(dyn_nav));
+    assert(hash(nav_numeric) == hash(dyn_nav_numeric));
+    assert(hash(numeric_only) == hash(DynamicGroup(3)));
+
+    std::vector<Group> groups{nav, nav_numeric, numeric_only, dyn_nav, dyn_nav_numeric, dyn_other,
+                              bench};
+    StringGroupEqual string_equal;
+    for (const auto& a : groups)
+        for (const auto& b : groups) assert((a == b) == string_equal(a, b));
+}
+
+template <typename Map> double benchmark_lookup(const std::vector<Group>& lookups, int repeat)
+{
+    Map subscription_groups;
+    for (const auto& g : lookups) subscription_groups.insert(std::make_pair(g, 0));
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t found = 0;
+    for (int r = 0; r < repeat; ++r)
+    {
+        for (const auto& g : lookups)
+        {
+            auto range = subscription_groups.equal_range(g);
+            for (auto it = range.first; it != range.second; ++it) ++found;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    assert(found == lookups.size() * repeat);
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (lookups.size() * repeat);
+}
+
+void benchmark_interthread(int n)
+{
+    goby::middleware::InterThreadTransporter interthread;
+    int received = 0;
+    interthread.subscribe<bench, int>([&](std::shared_ptr<const int>) { ++received; });
+
+    // deliver to our own subscription
+    goby::middleware::protobuf::TransporterConfig echo_cfg;
+    echo_cfg.set_echo(true);
+    goby::middleware::Publisher<int> echo_publisher(echo_cfg);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        interthread.publish<bench>(std::make_shared<int>(i), echo_publisher);
+        interthread.poll(std::chrono::seconds(0));
+    }
+    auto end = std::chrono::steady_clock::now();
+    assert(received == n);
+
+    std::cout << "InterThreadTransporter publish/poll: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / n
+              << " ns per message" << std::endl;
+}
+
+int main()
+{
+    test_equality();
+
+    // group names and numbers typical of a vehicle's interprocess traffic
+    std::vector<std::unique_ptr<DynamicGroup>> storage;
+    std::vector<Group> lookups;
+    for (int i = 0; i < 64; ++i)
+    {
+        storage.emplace_back(new DynamicGroup("goby::middleware::frontseat::node_status_" +
+                                                  std::to_string(i),
+                                              (i % 2) ? i : Group::invalid_numeric_group));
+        lookups.push_back(*storage.back());
+    }
+
+    const int repeat = 20000;
+    double string_ns =
+        benchmark_lookup<std::unordered_multimap<Group, int, StringGroupHash, StringGroupEqual>>(
+            lookups, repeat);
+    double id_ns = benchmark_lookup<std::unordered_multimap<Group, int>>(lookups, repeat);
+
+    std::cout << "Group keyed lookup (SubscriptionStore::subscription_groups_): string: "
+              << string_ns << " ns, identifier: " << id_ns << " ns" << std::endl;
+
+    benchmark_interthread(200000);
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
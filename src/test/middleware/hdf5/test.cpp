@@ -24,11 +24,63 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <H5Cpp.h>
 
 #include "goby/util/debug_logger.h"
 
 using goby::glog;
 
+// check that every dataset in group a exists in group b with the same shape, type and contents
+void compare_groups(H5::Group& a, H5::Group& b, const std::string& path)
+{
+    for (hsize_t i = 0, n = a.getNumObjs(); i < n; ++i)
+    {
+        std::string name = a.getObjnameByIdx(i);
+        // timestamps differ between runs
+        if (name == "_utime_" || name == "_datenum_")
+            continue;
+
+        switch (a.childObjType(name))
+        {
+            case H5O_TYPE_GROUP:
+            {
+                H5::Group sub_a = a.openGroup(name), sub_b = b.openGroup(name);
+                compare_groups(sub_a, sub_b, path + "/" + name);
+                break;
+            }
+            case H5O_TYPE_DATASET:
+            {
+                H5::DataSet ds_a = a.openDataSet(name), ds_b = b.openDataSet(name);
+                H5::DataSpace space_a = ds_a.getSpace(), space_b = ds_b.getSpace();
+                int rank = space_a.getSimpleExtentNdims();
+                assert(rank == space_b.getSimpleExtentNdims());
+                std::vector<hsize_t> dims_a(rank), dims_b(rank);
+                space_a.getSimpleExtentDims(dims_a.data());
+                space_b.getSimpleExtentDims(dims_b.data());
+                assert(dims_a == dims_b);
+
+                H5::DataType type = ds_a.getDataType();
+                assert(type == ds_b.getDataType());
+
+                std::vector<char> data_a(space_a.getSimpleExtentNpoints() * type.getSize()),
+                    data_b(data_a.size());
+                if (data_a.size())
+                {
+                    ds_a.read(data_a.data(), type);
+                    ds_b.read(data_b.data(), type);
+                }
+                std::cout << "Comparing " << path << "/" << name << std::endl;
+                assert(std::memcmp(data_a.data(), data_b.data(), data_a.size()) == 0);
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
 int main(int /*argc*/, char* argv[])
 {
     goby::glog.add_stream(goby::util::logger::DEBUG3, &std::cerr);
@@ -39,11 +91,29 @@ int main(int /*argc*/, char* argv[])
                         "--output_file /tmp/test.h5");
     std::cout << "Running: [" << sys_cmd << "]" << std::endl;
     int rc = system(sys_cmd.c_str());
+    if (rc != 0)
+        return rc;
+
+    // small chunks so that later messages extend datasets written by earlier chunks
+    std::string streaming_sys_cmd(
+        "LD_LIBRARY_PATH=" GOBY_LIB_DIR
+        ":$LD_LIBRARY_PATH GOBY_HDF5_PLUGIN=libgoby_hdf5test.so goby_hdf5 "
+        "--output_file /tmp/test_streaming.h5 "
+        "--writer 'streaming: true chunk_length: 2 deflate_level: 1 shuffle: true'");
+    std::cout << "Running: [" << streaming_sys_cmd << "]" << std::endl;
+    rc = system(streaming_sys_cmd.c_str());
+    if (rc != 0)
+        return rc;
 
-    if (rc == 0)
     {
-        std::cout << "All tests passed." << std::endl;
+        H5::H5File buffered("/tmp/test.h5", H5F_ACC_RDONLY),
+            streaming("/tmp/test_streaming.h5", H5F_ACC_RDONLY);
+        H5::Group buffered_root = buffered.openGroup("/"),
+                  streaming_root = streaming.openGroup("/");
+        compare_groups(buffered_root, streaming_root, "");
+        compare_groups(streaming_root, buffered_root, "");
     }
 
-    return rc;
+    std::cout << "All tests passed." << std::endl;
+    return 0;
 }
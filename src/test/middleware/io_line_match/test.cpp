@@ -0,0 +1,184 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+
+#include "goby/middleware/io/line_based/common.h"
+
+// checks that match_eol selects the literal matcher for plain delimiters and that it splits lines
+// identically to match_regex, and benchmarks both on NMEA sentences arriving a few bytes at a time
+
+using goby::middleware::io::match_eol;
+using goby::middleware::io::match_literal;
+using goby::middleware::io::match_regex;
+
+// SyncReadStream that returns at most chunk_size bytes per read, like a serial port
+class ChunkedStream
+{
+  public:
+    ChunkedStream(const std::string& data, std::size_t chunk_size)
+        : data_(data), chunk_size_(chunk_size)
+    {
+    }
+
+    template <typename MutableBufferSequence>
+    std::size_t read_some(const MutableBufferSequence& buffers, boost::system::error_code& ec)
+    {
+        if (pos_ == data_.size())
+        {
+            ec = boost::asio::error::eof;
+            return 0;
+        }
+        std::size_t n = std::min(chunk_size_, data_.size() - pos_);
+        n = boost::asio::buffer_copy(buffers, boost::asio::buffer(data_.data() + pos_, n));
+        pos_ += n;
+        return n;
+    }
+
+    template <typename MutableBufferSequence>
+    std::size_t read_some(const MutableBufferSequence& buffers)
+    {
+        boost::system::error_code ec;
+        auto n = read_some(buffers, ec);
+        if (ec)
+            throw boost::system::system_error(ec);
+        return n;
+    }
+
+  private:
+    const std::string& data_;
+    std::size_t chunk_size_;
+    std::size_t pos_{0};
+};
+
+// reads lines as the line-based IO threads do
+template <typename MatchCondition>
+std::vector<std::string> read_lines(const std::string& data, std::size_t chunk_size,
+                                    MatchCondition matcher)
+{
+    ChunkedStream stream(data, chunk_size);
+    boost::asio::streambuf buffer;
+    std::vector<std::string> lines;
+    for (;;)
+    {
+        boost::system::error_code ec;
+        auto bytes_transferred = boost::asio::read_until(stream, buffer, matcher, ec);
+        if (ec || bytes_transferred == 0)
+            break;
+        std::string bytes(bytes_transferred, 0);
+        std::istream is(&buffer);
+        is.read(&bytes[0], bytes_transferred);
+        lines.push_back(bytes);
+    }
+    return lines;
+}
+
+void test_selection()
+{
+    // the literal matcher uses memchr on the streambuf used by the line-based IO threads
+    static_assert(goby::middleware::io::detail::is_contiguous_char_iterator<
+                      boost::asio::buffers_iterator<boost::asio::streambuf::const_buffers_type,
+                                                    char>>::value,
+                  "streambuf data should be contiguous");
+
+    assert(match_eol("\n").is_literal());
+    assert(match_eol("\r\n").is_literal());
+    assert(match_eol("\\r\\n").is_literal());
+    assert(match_eol("\\*").is_literal());
+    assert(match_eol("END").is_literal());
+    assert(!match_eol("\r?\n").is_literal());
+    assert(!match_eol("\\*[0-9A-F]{2}\r\n").is_literal());
+    assert(!match_eol("\\d").is_literal());
+    assert(!match_eol("a|b").is_literal());
+    assert(!match_eol("").is_literal());
+}
+
+void test_lines(const std::string& eol, const std::string& delimiter)
+{
+    std::string data;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        // includes partial delimiters within the lines
+        std::string line(std::string(i % 17, 'a') + delimiter.substr(0, i % delimiter.size()) +
+                         std::to_string(i) + delimiter);
+        data += line;
+        expected.push_back(line);
+    }
+
+    for (std::size_t chunk_size : {1, 2, 3, 7, 64, 4096})
+    {
+        assert(read_lines(data, chunk_size, match_eol(eol)) == expected);
+        assert(read_lines(data, chunk_size, match_regex(eol)) == expected);
+        assert(read_lines(data, chunk_size, match_literal(delimiter)) == expected);
+    }
+}
+
+template <typename MatchCondition>
+void benchmark(const std::string& name, const std::string& data, std::size_t chunk_size,
+               std::size_t expected_lines, MatchCondition matcher)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto lines = read_lines(data, chunk_size, matcher);
+    auto end = std::chrono::steady_clock::now();
+    assert(lines.size() == expected_lines);
+
+    std::cout << name << " (" << chunk_size << " byte reads): "
+              << std::chrono::duration<double, std::nano>(end - start).count() / lines.size()
+              << " ns per line" << std::endl;
+}
+
+int main()
+{
+    test_selection();
+    test_lines("\n", "\n");
+    test_lines("\r\n", "\r\n");
+    test_lines("\\r\\n", "\r\n");
+    test_lines("ENDEND", "ENDEND");
+
+    // 79 bytes is the longest NMEA-0183 sentence
+    const std::string sentence(
+        "$GPGGA,172814.0,3723.46587704,N,12202.26957864,W,2,6,1.2,18.893,M,-25.669,M,2.0,0031*4F"
+        "\r\n");
+    const std::size_t nlines = 20000;
+    std::string data;
+    for (std::size_t i = 0; i < nlines; ++i) data += sentence;
+
+    for (std::size_t chunk_size : {8, 64, 1024})
+    {
+        benchmark("match_regex", data, chunk_size, nlines, match_regex("\r\n"));
+        benchmark("match_eol (literal)", data, chunk_size, nlines, match_eol("\r\n"));
+    }
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures the latency from publishing IOData to a PTYThreadLineBased (via InterThreadTransporter)
+// to reading the data from the other end of the PTY.
+
+#include <algorithm> // for sort
+#include <cassert>   // for assert
+#include <fcntl.h>   // for open
+#include <numeric>   // for accumulate
+#include <poll.h>    // for poll
+#include <termios.h> // for cfmakeraw
+#include <unistd.h>  // for read
+
+#include "goby/middleware/application/multi_thread.h"
+#include "goby/middleware/io/line_based/pty.h"
+
+#include "goby/test/middleware/io_pty_latency/test.pb.h"
+
+using goby::glog;
+using namespace goby::util::logger;
+using goby::test::middleware::protobuf::TestConfig;
+
+constexpr goby::middleware::Group pty_in{"pty_in"};
+constexpr goby::middleware::Group pty_out{"pty_out"};
+
+using PTYThread = goby::middleware::io::PTYThreadLineBased<
+    pty_in, pty_out, goby::middleware::io::PubSubLayer::INTERTHREAD,
+    goby::middleware::io::PubSubLayer::INTERTHREAD>;
+
+class TestConfigurator : public goby::middleware::ProtobufConfigurator<TestConfig>
+{
+  public:
+    TestConfigurator(int argc, char* argv[])
+        : goby::middleware::ProtobufConfigurator<TestConfig>(argc, argv)
+    {
+        TestConfig& cfg = mutable_cfg();
+        cfg.mutable_app()->set_name("TestPTYLatency");
+        if (!cfg.has_pty())
+            cfg.mutable_pty()->set_port("/tmp/goby_test_io_pty_latency");
+    }
+};
+
+class TestApp : public goby::middleware::MultiThreadTest<TestConfig>
+{
+  public:
+    TestApp() : goby::middleware::MultiThreadTest<TestConfig>(10 * boost::units::si::hertz)
+    {
+        interthread().subscribe<pty_in>([this](const goby::middleware::protobuf::IOStatus& status) {
+            if (status.state() == goby::middleware::protobuf::IO__LINK_OPEN)
+                link_open_ = true;
+        });
+
+        launch_thread<PTYThread>(cfg().pty());
+    }
+
+  private:
+    void loop() override
+    {
+        if (!link_open_)
+            return;
+
+        int fd = open(cfg().pty().port().c_str(), O_RDWR | O_NOCTTY);
+        if (fd < 0)
+            glog.is_die() && glog << "Failed to open " << cfg().pty().port() << std::endl;
+        termios ps;
+        tcgetattr(fd, &ps);
+        cfmakeraw(&ps);
+        tcsetattr(fd, TCSANOW, &ps);
+
+        std::vector<double> latency_us;
+        for (int i = 0, n = cfg().num_messages(); i < n; ++i)
+        {
+            auto io_msg = std::make_shared<goby::middleware::protobuf::IOData>();
+            std::string line = "ping " + std::to_string(i) + "\n";
+            io_msg->set_data(line);
+
+            auto start = std::chrono::steady_clock::now();
+            interthread().publish<pty_out>(io_msg);
+
+            std::string received;
+            while (received.size() < line.size())
+            {
+                pollfd pfd{fd, POLLIN, 0};
+                // should be far less than a second
+                if (::poll(&pfd, 1, 1000) != 1)
+                    glog.is_die() && glog << "Timeout waiting for: " << line << std::endl;
+
+                char buffer[64];
+                auto bytes = ::read(fd, buffer, sizeof(buffer));
+                if (bytes <= 0)
+                    glog.is_die() && glog << "Failed to read from PTY" << std::endl;
+                received.append(buffer, bytes);
+            }
+            auto end = std::chrono::steady_clock::now();
+            assert(received == line);
+
+            latency_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        close(fd);
+
+        std::sort(latency_us.begin(), latency_us.end());
+        auto mean = std::accumulate(latency_us.begin(), latency_us.end(), 0.0) / latency_us.size();
+        std::cout << "PTY write latency (" << latency_us.size() << " messages): median "
+                  << latency_us[latency_us.size() / 2] << " us, mean " << mean << " us, p99 "
+                  << latency_us[latency_us.size() * 99 / 100] << " us" << std::endl;
+
+        join_thread<PTYThread>();
+        std::cout << "all tests passed" << std::endl;
+        quit();
+    }
+
+  private:
+    bool link_open_{false};
+};
+
+int main(int argc, char* argv[])
+{
+    return goby::run<TestApp>(TestConfigurator(argc, argv));
+}
@@ -0,0 +1,225 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <cstdio>
+#include <fcntl.h> // for AT_FDCWD
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h> // for stat, utimensat
+#include <vector>
+
+#include "goby/middleware/log/log_entry.h"
+#include "goby/middleware/log/log_index.h"
+#include "goby/middleware/marshalling/interface.h"
+#include "goby/util/debug_logger.h"
+
+using goby::middleware::log::LogEntry;
+using goby::middleware::log::LogIndex;
+using goby::middleware::log::MappedLogFile;
+
+constexpr goby::middleware::Group early_group("groups::early");
+constexpr goby::middleware::Group late_group("groups::late");
+constexpr goby::middleware::Group filter_group("groups::filter");
+const std::string type("Sample");
+const std::string filter_type("FilterSample");
+
+const std::string log_path("/tmp/goby3_test_log_index.goby");
+constexpr int nentries = 20000;
+// groups::late first appears here so seeking after it relies on replaying the group index
+constexpr int late_start = nentries / 2;
+// one entry consumed by a filter hook is written every filter_period entries
+constexpr int filter_period = 1000;
+
+constexpr int scheme = goby::middleware::MarshallingScheme::CSTR;
+
+goby::time::SystemClock::time_point start_time{goby::time::SystemClock::now()};
+int filter_count = 0;
+
+goby::time::SystemClock::time_point entry_time(int i)
+{
+    return start_time + std::chrono::milliseconds(i);
+}
+
+// filter_prefix changes the data (but not the size) of the log
+void write_log(const std::string& filter_prefix = "filter")
+{
+    LogEntry::reset();
+    std::ofstream out(log_path.c_str());
+    for (int i = 0; i < nentries; ++i)
+    {
+        if (i % filter_period == 0)
+        {
+            std::string s(filter_prefix + std::to_string(i));
+            LogEntry entry(std::vector<unsigned char>(s.begin(), s.end()), scheme, filter_type,
+                           filter_group, entry_time(i));
+            entry.serialize(&out);
+        }
+
+        std::string s(std::to_string(i));
+        LogEntry entry(std::vector<unsigned char>(s.begin(), s.end()), scheme, type,
+                       i < late_start ? early_group : late_group, entry_time(i));
+        entry.serialize(&out);
+    }
+}
+
+void reset_read()
+{
+    LogEntry::reset();
+    filter_count = 0;
+    LogEntry::filter_hook[{scheme, std::string(filter_group), filter_type}] =
+        [](const std::vector<unsigned char>& /*data*/) { ++filter_count; };
+}
+
+void check_seek(MappedLogFile& log, const LogIndex& index, int i)
+{
+    reset_read();
+    index.seek(log.stream(), entry_time(i));
+
+    LogEntry entry;
+    do
+    {
+        entry.parse(&log.stream());
+    } while (entry.timestamp() < entry_time(i));
+
+    std::string data(entry.data().begin(), entry.data().end());
+    std::cout << "Seek to " << i << ": read " << data << " from " << entry.group() << std::endl;
+    assert(data == std::to_string(i));
+    assert(entry.group() == (i < late_start ? early_group : late_group));
+    assert(entry.type() == type);
+    // every filtered entry before this one was passed to the hook (replayed or parsed)
+    assert(filter_count == i / filter_period + 1);
+}
+
+int main(int /*argc*/, char* argv[])
+{
+    goby::glog.add_stream(goby::util::logger::DEBUG1, &std::cerr);
+    goby::glog.set_name(argv[0]);
+
+    write_log();
+    std::remove(LogIndex::sidecar_path(log_path).c_str());
+
+    MappedLogFile log(log_path);
+
+    reset_read();
+    LogIndex index(4096);
+    index.load_or_build(log);
+    assert(index.index().version() == LogEntry::compiled_current_version);
+    assert(index.index().log_size() == log.size());
+    assert(index.index().checkpoint_size() > 10);
+    // group and type index entries, plus the filter entries
+    assert(index.index().replay_offset_size() == 3 + 2 + nentries / filter_period);
+
+    // sidecar is reused
+    {
+        LogIndex loaded(4096);
+        assert(loaded.load(LogIndex::sidecar_path(log_path), log));
+        assert(loaded.index().SerializeAsString() == index.index().SerializeAsString());
+
+        // but not if the filter hooks differ
+        LogEntry::filter_hook.clear();
+        assert(!loaded.load(LogIndex::sidecar_path(log_path), log));
+    }
+
+    for (int i : {0, 1, 999, 1000, 1001, 5000, late_start - 1, late_start, 12345, nentries - 1})
+        check_seek(log, index, i);
+
+    // seeking past the end leaves us at or near the end of the file
+    {
+        reset_read();
+        index.seek(log.stream(), entry_time(nentries + 1000));
+        try
+        {
+            LogEntry entry;
+            for (;;)
+            {
+                entry.parse(&log.stream());
+                assert(entry.timestamp() <= entry_time(nentries - 1));
+            }
+        }
+        catch (std::ios_base::failure& e)
+        {
+            assert(log.stream().eof());
+        }
+    }
+
+    // the mapped stream reads the same entries as std::ifstream
+    {
+        reset_read();
+        std::ifstream in(log_path.c_str());
+        struct Expected
+        {
+            std::vector<unsigned char> data;
+            std::string group;
+            goby::time::SystemClock::time_point timestamp;
+            std::streamoff end;
+        };
+        std::vector<Expected> expected;
+        for (int i = 0; i < nentries; ++i)
+        {
+            LogEntry entry;
+            entry.parse(&in);
+            expected.push_back(
+                {entry.data(), std::string(entry.group()), entry.timestamp(), in.tellg()});
+        }
+
+        reset_read();
+        MappedLogFile mapped(log_path);
+        for (const auto& e : expected)
+        {
+            LogEntry entry;
+            entry.parse(&mapped.stream());
+            assert(entry.data() == e.data && std::string(entry.group()) == e.group &&
+                   entry.timestamp() == e.timestamp);
+            assert(std::streamoff(mapped.stream().tellg()) == e.end);
+        }
+    }
+
+    // the sidecar is not used for a log rewritten to the same size, even with the same
+    // modification time
+    {
+        std::stringstream stale_sidecar;
+        stale_sidecar << std::ifstream(LogIndex::sidecar_path(log_path).c_str()).rdbuf();
+        struct stat st;
+        stat(log_path.c_str(), &st);
+
+        write_log("FILTER");
+        std::ofstream(LogIndex::sidecar_path(log_path).c_str()) << stale_sidecar.str();
+        struct timespec times[2] = {st.st_atim, st.st_mtim};
+        utimensat(AT_FDCWD, log_path.c_str(), times, 0);
+
+        MappedLogFile rewritten(log_path);
+        assert(rewritten.size() == log.size() && rewritten.mtime() == log.mtime());
+        reset_read();
+        LogIndex loaded(4096);
+        assert(!loaded.load(LogIndex::sidecar_path(log_path), rewritten));
+
+        // but is after rebuilding
+        loaded.load_or_build(rewritten);
+        LogIndex reloaded(4096);
+        assert(reloaded.load(LogIndex::sidecar_path(log_path), rewritten));
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,258 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>    // for AT_FDCWD
+#include <sys/stat.h> // for stat, utimensat
+
+#include "goby/middleware/log/log_entry.h"
+#include "goby/middleware/log/log_reader.h"
+#include "goby/middleware/marshalling/interface.h"
+#include "goby/util/debug_logger.h"
+
+// checks LogReader range queries against a full LogEntry::parse() scan, reads two files
+// concurrently, and compares the time for a query on a rare type with the full scan
+
+using goby::middleware::log::LogEntry;
+using goby::middleware::log::LogFilter;
+using goby::middleware::log::LogReader;
+
+constexpr int scheme = goby::middleware::MarshallingScheme::CSTR;
+constexpr int other_scheme = goby::middleware::MarshallingScheme::PROTOBUF;
+
+const std::vector<std::string> groups{"nav", "ctd", "status"};
+const std::vector<std::string> types{"NavigationReport", "CTDSample", "Status"};
+
+constexpr int nentries = 50000;
+// one NavigationReport per rare_period entries
+constexpr int rare_period = 500;
+
+goby::time::SystemClock::time_point start_time{goby::time::SystemClock::now()};
+
+goby::time::SystemClock::time_point entry_time(int i)
+{
+    return start_time + std::chrono::milliseconds(i);
+}
+
+struct Expected
+{
+    LogFilter channel;
+    std::string data;
+    goby::time::SystemClock::time_point timestamp;
+};
+
+// writes a log, returning the data entries in file order (data_tag defaults to seed)
+std::vector<Expected> write_log(const std::string& path, int seed, int garbage_at = nentries / 2,
+                                int data_tag = -1)
+{
+    LogEntry::reset();
+    std::remove(LogReader::sidecar_path(path).c_str());
+    std::ofstream out(path.c_str());
+    std::mt19937 rng(seed);
+
+    std::vector<Expected> expected;
+    for (int i = 0; i < nentries; ++i)
+    {
+        int c = (i % rare_period == 0) ? 0 : 1 + rng() % (types.size() - 1);
+        LogFilter channel{(i % 3) ? scheme : other_scheme, groups[c], types[c]};
+        std::string data(std::to_string(data_tag < 0 ? seed : data_tag) + ":" +
+                         std::to_string(i));
+        // timestamps may be out of order within a channel
+        auto timestamp = entry_time((rng() % 100 == 0) ? i - 50 : i);
+
+        LogEntry entry(std::vector<unsigned char>(data.begin(), data.end()), channel.scheme,
+                       channel.type, goby::middleware::DynamicGroup(channel.group), timestamp);
+        entry.serialize(&out);
+        expected.push_back({channel, data, timestamp});
+
+        // garbage between entries is skipped, as by LogEntry::parse()
+        if (i == garbage_at)
+            out << "garbage";
+    }
+    return expected;
+}
+
+bool operator==(const LogFilter& a, const LogFilter& b) { return !(a < b) && !(b < a); }
+
+void check_query(const LogReader& reader, const std::vector<Expected>& expected,
+                 const std::vector<LogFilter>& channels, int begin, int end)
+{
+    std::vector<const Expected*> matches;
+    for (const auto& e : expected)
+    {
+        bool channel_match = false;
+        for (const auto& c : channels) channel_match = channel_match || (c == e.channel);
+        if (channel_match && e.timestamp >= entry_time(begin) && e.timestamp < entry_time(end))
+            matches.push_back(&e);
+    }
+
+    auto range = reader.entries(channels, entry_time(begin), entry_time(end));
+    assert(range.size() == matches.size());
+    std::size_t i = 0;
+    for (const auto& entry : range)
+    {
+        const auto& e = *matches[i++];
+        assert(std::string(entry.data().begin(), entry.data().end()) == e.data);
+        assert(entry.scheme() == e.channel.scheme);
+        assert(entry.type() == e.channel.type);
+        assert(std::string(entry.group()) == e.channel.group);
+        assert(entry.timestamp() == e.timestamp);
+    }
+    assert(i == matches.size());
+}
+
+void check_reader(const std::string& path, const std::vector<Expected>& expected, int seed)
+{
+    LogReader reader(path);
+    assert(reader.version() == LogEntry::compiled_current_version);
+    assert(reader.channels().size() == 2 * types.size());
+    assert(reader.channels("NavigationReport").size() == 2);
+    assert(reader.count(LogFilter{scheme, "nav", "NavigationReport"}) +
+               reader.count(LogFilter{other_scheme, "nav", "NavigationReport"}) ==
+           nentries / rare_period);
+    assert(reader.count(LogFilter{scheme, "nav", "NoSuchType"}) == 0);
+
+    std::mt19937 rng(seed);
+    for (int q = 0; q < 50; ++q)
+    {
+        int begin = rng() % nentries;
+        int end = begin + rng() % (nentries / 10);
+
+        std::vector<LogFilter> channels;
+        for (const auto& c : reader.channels())
+        {
+            if (rng() % 2)
+                channels.push_back(c);
+        }
+        check_query(reader, expected, channels, begin, end);
+        check_query(reader, expected, reader.channels("NavigationReport"), begin, end);
+    }
+    // whole file
+    check_query(reader, expected, reader.channels(), -100, nentries + 100);
+}
+
+int main(int /*argc*/, char* argv[])
+{
+    goby::glog.add_stream(goby::util::logger::WARN, &std::cerr);
+    goby::glog.set_name(argv[0]);
+    goby::glog.set_lock_action(goby::util::logger_lock::lock);
+
+    const std::string path_a("/tmp/goby3_test_log_reader_a.goby");
+    const std::string path_b("/tmp/goby3_test_log_reader_b.goby");
+    auto expected_a = write_log(path_a, 1);
+    auto expected_b = write_log(path_b, 2);
+    LogEntry::reset();
+
+    // builds (and saves) the index of each file concurrently
+    {
+        std::thread thread_a([&]() { check_reader(path_a, expected_a, 10); });
+        std::thread thread_b([&]() { check_reader(path_b, expected_b, 20); });
+        thread_a.join();
+        thread_b.join();
+    }
+
+    // uses the saved index
+    assert(std::ifstream(LogReader::sidecar_path(path_a).c_str()).good());
+    check_reader(path_a, expected_a, 30);
+
+    // the index is rebuilt if the log has changed size
+    std::ofstream(path_a.c_str(), std::ios::app) << "truncated";
+    check_reader(path_a, expected_a, 40);
+
+    // ... or rewritten to the same size with the same modification time (entries after
+    // garbage_at are shifted and the data differ), which leaves the fingerprint to detect it
+    {
+        std::stringstream stale_sidecar;
+        stale_sidecar << std::ifstream(LogReader::sidecar_path(path_b).c_str()).rdbuf();
+        struct stat st;
+        stat(path_b.c_str(), &st);
+
+        auto expected_rewritten = write_log(path_b, 2, nentries / 4, 7);
+        LogEntry::reset();
+        std::ofstream(LogReader::sidecar_path(path_b).c_str()) << stale_sidecar.str();
+        struct timespec times[2] = {st.st_atim, st.st_mtim};
+        utimensat(AT_FDCWD, path_b.c_str(), times, 0);
+
+        check_reader(path_b, expected_rewritten, 50);
+    }
+
+    // all NavigationReport entries in a time window: indexed query vs. full scan
+    {
+        const int begin = nentries / 4, end = 3 * nentries / 4;
+
+        auto scan_start = std::chrono::steady_clock::now();
+        int scan_count = 0;
+        {
+            LogEntry::reset();
+            std::ifstream in(path_a.c_str());
+            try
+            {
+                LogEntry entry;
+                for (;;)
+                {
+                    entry.parse(&in);
+                    if (entry.type() == "NavigationReport" &&
+                        entry.timestamp() >= entry_time(begin) &&
+                        entry.timestamp() < entry_time(end))
+                        ++scan_count;
+                }
+            }
+            catch (std::ios_base::failure& e)
+            {
+            }
+            catch (goby::middleware::log::LogException& e)
+            {
+            }
+        }
+        auto scan_end = std::chrono::steady_clock::now();
+
+        LogReader reader(path_a);
+        auto query_start = std::chrono::steady_clock::now();
+        int query_count = 0;
+        auto channels = reader.channels("NavigationReport");
+        for (const auto& entry : reader.entries(channels, entry_time(begin), entry_time(end)))
+        {
+            if (!entry.data().empty())
+                ++query_count;
+        }
+        auto query_end = std::chrono::steady_clock::now();
+
+        assert(scan_count == query_count);
+        using ms = std::chrono::duration<double, std::milli>;
+        std::cout << query_count << " NavigationReport entries: full scan: "
+                  << ms(scan_end - scan_start).count()
+                  << " ms, LogReader query: " << ms(query_end - query_start).count() << " ms"
+                  << std::endl;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
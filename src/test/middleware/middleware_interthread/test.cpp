@@ -21,20 +21,25 @@
 // You should have received a copy of the GNU General Public License
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <deque>
+#include <iomanip>
 #include <utility>
 
 #include "goby/middleware/transport/interthread.h"
 #include "goby/test/middleware/middleware_interthread/test.pb.h"
 #include "goby/util/debug_logger.h"
 
-// tests InterThreadTransporter
+// tests InterThreadTransporter, and benchmarks throughput and latency of the selected mailbox backend
+// usage: goby_test_middleware_interthread [mutex|ring]
 
 using namespace goby::test::middleware::protobuf;
 
-goby::middleware::InterThreadTransporter inproc1;
-goby::middleware::InterThreadTransporter inproc2;
+// constructed in main() once the mailbox backend has been chosen
+std::unique_ptr<goby::middleware::InterThreadTransporter> inproc1;
+std::unique_ptr<goby::middleware::InterThreadTransporter> inproc2;
 
 int publish_count = 0;
 const int max_publish = 100;
@@ -45,6 +50,15 @@ extern constexpr goby::middleware::Group sample1{"Sample1"};
 extern constexpr goby::middleware::Group sample2{"Sample2"};
 extern constexpr goby::middleware::Group widget{"Widget"};
 
+extern constexpr goby::middleware::Group bench_data{"BenchData"};
+extern constexpr goby::middleware::Group bench_ping{"BenchPing"};
+extern constexpr goby::middleware::Group bench_pong{"BenchPong"};
+
+// benchmark parameters
+const int bench_publishers = 4;
+const int bench_publish_per_thread = 50000;
+const int bench_round_trips = 10000;
+
 namespace goby
 {
 namespace test
@@ -59,14 +73,14 @@ void publisher()
     {
         auto s1 = std::make_shared<Sample>();
         s1->set_a(a++);
-        inproc1.publish<sample1>(s1);
+        inproc1->publish<sample1>(s1);
         auto s2 = std::make_shared<Sample>();
         s2->set_a(s1->a() + 10);
         std::shared_ptr<const Sample> s2_const = s2;
-        inproc1.publish<sample2>(s2_const);
+        inproc1->publish<sample2>(s2_const);
         auto w1 = std::make_shared<Widget>();
         w1->set_b(s1->a() - 8);
-        inproc1.publish<widget>(w1);
+        inproc1->publish<widget>(w1);
         ++publish_count;
     }
 }
@@ -78,17 +92,17 @@ class Subscriber
   public:
     void run()
     {
-        inproc2.subscribe<sample1, Sample>(
+        inproc2->subscribe<sample1, Sample>(
             [this](std::shared_ptr<const Sample> s) { handle_sample1(std::move(s)); });
-        inproc2.subscribe<sample2, Sample>(
+        inproc2->subscribe<sample2, Sample>(
             [this](std::shared_ptr<const Sample> s) { handle_sample2(std::move(s)); });
-        inproc2.subscribe<widget, Widget>(
+        inproc2->subscribe<widget, Widget>(
             [this](std::shared_ptr<const Widget> w) { handle_widget1(std::move(w)); });
         while (receive_count1 < max_publish || receive_count2 < max_publish ||
                receive_count3 < max_publish)
         {
             ++ready;
-            inproc2.poll();
+            inproc2->poll();
             //  std::cout << "Polled " << items  << " items. " << std::endl;
         }
     }
@@ -122,16 +136,145 @@ class Subscriber
     int receive_count2 = {0};
     int receive_count3 = {0};
 };
+
+struct BenchMessage
+{
+    int index{0};
+    std::chrono::steady_clock::time_point publish_time;
+};
+
+// many publishing threads flooding one subscribing thread
+void benchmark_throughput()
+{
+    std::atomic<bool> subscribed(false);
+    int receive_count = 0;
+    const int expected = bench_publishers * bench_publish_per_thread;
+    std::chrono::steady_clock::duration total_latency{0};
+
+    std::thread subscriber([&]() {
+        goby::middleware::InterThreadTransporter sub_transporter;
+        sub_transporter.subscribe<bench_data, BenchMessage>(
+            [&](std::shared_ptr<const BenchMessage> msg) {
+                total_latency += std::chrono::steady_clock::now() - msg->publish_time;
+                ++receive_count;
+            });
+        subscribed = true;
+        while (receive_count < expected) sub_transporter.poll();
+    });
+
+    while (!subscribed) usleep(1e3);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> publishers;
+    for (int i = 0; i < bench_publishers; ++i)
+    {
+        publishers.emplace_back([]() {
+            goby::middleware::InterThreadTransporter pub_transporter;
+            for (int j = 0; j < bench_publish_per_thread; ++j)
+            {
+                auto msg = std::make_shared<BenchMessage>();
+                msg->index = j;
+                msg->publish_time = std::chrono::steady_clock::now();
+                pub_transporter.publish<bench_data>(msg);
+            }
+        });
+    }
+    for (auto& t : publishers) t.join();
+    subscriber.join();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Throughput: " << bench_publishers << " publishers, " << receive_count
+              << " messages in " << seconds << " s (" << std::fixed << std::setprecision(0)
+              << receive_count / seconds << " msgs/s), mean queued latency: "
+              << std::setprecision(2)
+              << std::chrono::duration<double, std::micro>(total_latency).count() / receive_count
+              << " us" << std::defaultfloat << std::endl;
+}
+
+// ping-pong between two threads: measures the wakeup latency of an idle subscriber
+void benchmark_latency()
+{
+    std::atomic<bool> ponger_ready(false);
+    std::atomic<bool> done(false);
+
+    std::thread ponger([&]() {
+        goby::middleware::InterThreadTransporter transporter;
+        transporter.subscribe<bench_ping, BenchMessage>(
+            [&](std::shared_ptr<const BenchMessage> msg) {
+                transporter.publish<bench_pong>(msg);
+            });
+        ponger_ready = true;
+        while (!done) transporter.poll(std::chrono::milliseconds(10));
+    });
+
+    while (!ponger_ready) usleep(1e3);
+
+    goby::middleware::InterThreadTransporter transporter;
+    std::vector<double> round_trips_us;
+    round_trips_us.reserve(bench_round_trips);
+    bool pong = false;
+    transporter.subscribe<bench_pong, BenchMessage>(
+        [&](std::shared_ptr<const BenchMessage> msg) {
+            round_trips_us.push_back(std::chrono::duration<double, std::micro>(
+                                         std::chrono::steady_clock::now() - msg->publish_time)
+                                         .count());
+            pong = true;
+        });
+
+    for (int i = 0; i < bench_round_trips; ++i)
+    {
+        auto msg = std::make_shared<BenchMessage>();
+        msg->index = i;
+        msg->publish_time = std::chrono::steady_clock::now();
+        pong = false;
+        transporter.publish<bench_ping>(msg);
+        while (!pong) transporter.poll();
+    }
+    done = true;
+    ponger.join();
+
+    std::sort(round_trips_us.begin(), round_trips_us.end());
+    std::cout << "Latency: " << bench_round_trips << " round trips, one-way median: " << std::fixed
+              << std::setprecision(2) << round_trips_us[round_trips_us.size() / 2] / 2
+              << " us, 99th percentile: " << round_trips_us[round_trips_us.size() * 99 / 100] / 2
+              << " us" << std::defaultfloat << std::endl;
+}
+
 } // namespace middleware
 } // namespace test
 } // namespace goby
 
-int main(int /*argc*/, char* argv[])
+int main(int argc, char* argv[])
 {
     goby::glog.add_stream(goby::util::logger::DEBUG3, &std::cerr);
     goby::glog.set_name(argv[0]);
     goby::glog.set_lock_action(goby::util::logger_lock::lock);
 
+    std::string backend = (argc > 1) ? argv[1] : "mutex";
+    if (backend == "mutex")
+    {
+        goby::middleware::InterThreadSettings::mailbox_backend =
+            goby::middleware::InterThreadSettings::MailboxBackend::MUTEX_QUEUE;
+    }
+    else if (backend == "ring")
+    {
+        goby::middleware::InterThreadSettings::mailbox_backend =
+            goby::middleware::InterThreadSettings::MailboxBackend::LOCK_FREE_RING;
+        // large enough that the throughput benchmark never drops data
+        goby::middleware::InterThreadSettings::ring_capacity =
+            bench_publishers * bench_publish_per_thread;
+    }
+    else
+    {
+        std::cerr << "Usage: " << argv[0] << " [mutex|ring]" << std::endl;
+        return 1;
+    }
+    std::cout << "Mailbox backend: " << backend << std::endl;
+
+    inproc1.reset(new goby::middleware::InterThreadTransporter);
+    inproc2.reset(new goby::middleware::InterThreadTransporter);
+
     //    std::thread t3(subscriber);
     const int max_subs = 10;
     std::vector<goby::test::middleware::Subscriber> subscribers(
@@ -154,5 +297,8 @@ int main(int /*argc*/, char* argv[])
 
     for (int i = 0; i < max_subs; ++i) threads.at(i).join();
 
+    goby::test::middleware::benchmark_throughput();
+    goby::test::middleware::benchmark_latency();
+
     std::cout << "all tests passed" << std::endl;
 }
@@ -0,0 +1,132 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "goby/middleware/marshalling/cstr.h"
+#include "goby/middleware/transport/interprocess.h"
+#include "goby/middleware/transport/interthread.h"
+
+// tests the shared default Publisher/Subscriber metadata and that the InterProcessForwarder
+// omits the default configuration from its publications, and benchmarks publishing with the
+// default Publisher against constructing a Publisher for each call
+
+using goby::middleware::Publisher;
+using goby::middleware::Subscriber;
+using goby::middleware::protobuf::SerializerTransporterMessage;
+
+extern constexpr goby::middleware::Group nav{"navigation"};
+extern constexpr goby::middleware::Group to_portal{"goby::middleware::interprocess::to_portal"};
+
+using Forwarder = goby::middleware::InterProcessForwarder<goby::middleware::InterThreadTransporter>;
+
+void test_metadata()
+{
+    assert(&Publisher<std::string>::default_instance() ==
+           &Publisher<std::string>::default_instance());
+    assert(Publisher<std::string>::default_instance().cfg_is_default());
+    assert(!Publisher<std::string>::default_instance().has_set_group_func());
+    assert(&Subscriber<std::string>::default_instance() ==
+           &Subscriber<std::string>::default_instance());
+    assert(Subscriber<std::string>::default_instance().cfg_is_default());
+
+    goby::middleware::protobuf::TransporterConfig echo_cfg;
+    echo_cfg.set_echo(true);
+    assert(!Publisher<std::string>(echo_cfg).cfg_is_default());
+    assert(!Subscriber<std::string>(echo_cfg).cfg_is_default());
+
+    // setting an acked_func sets ack_required
+    Publisher<std::string> acked_publisher(
+        goby::middleware::protobuf::TransporterConfig(),
+        [](const std::string&, const goby::middleware::intervehicle::protobuf::AckData&) {});
+    assert(!acked_publisher.cfg_is_default());
+}
+
+// publishes from a separate thread, since the InterThreadTransporter does not deliver to
+// subscribers on the publishing thread
+template <typename PublishFunc> int forward(int n, PublishFunc publish, bool expect_cfg)
+{
+    goby::middleware::InterThreadTransporter interthread;
+    std::atomic<int> received(0);
+    interthread.subscribe<to_portal, SerializerTransporterMessage>(
+        [&](const SerializerTransporterMessage& msg) {
+            assert(msg.key().group() == "navigation");
+            assert(msg.data() == std::string("x", 2)); // CSTR includes the terminating null
+            assert(msg.key().has_cfg() == expect_cfg);
+            ++received;
+        });
+
+    std::atomic<bool> ready(false);
+    std::thread publisher_thread([&]() {
+        goby::middleware::InterThreadTransporter inner;
+        Forwarder forwarder(inner);
+        ready = true;
+        for (int i = 0; i < n; ++i) publish(forwarder);
+    });
+
+    while (!ready) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    while (received < n) interthread.poll(std::chrono::milliseconds(10));
+    publisher_thread.join();
+    return received;
+}
+
+template <typename PublishFunc> void benchmark(const std::string& name, PublishFunc publish)
+{
+    goby::middleware::InterThreadTransporter inner;
+    Forwarder forwarder(inner);
+
+    const int n = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) publish(forwarder);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << name << ": " << std::chrono::duration<double, std::nano>(end - start).count() / n
+              << " ns per publish" << std::endl;
+}
+
+int main()
+{
+    test_metadata();
+
+    const std::string x("x");
+    assert(forward(100, [&](Forwarder& f) { f.publish<nav>(x); }, false) == 100);
+
+    goby::middleware::protobuf::TransporterConfig echo_cfg;
+    echo_cfg.set_echo(true);
+    Publisher<std::string> echo_publisher(echo_cfg);
+    assert(forward(100, [&](Forwarder& f) { f.publish<nav>(x, echo_publisher); }, true) == 100);
+
+    benchmark("InterProcessForwarder::publish, default Publisher",
+              [&](Forwarder& f) { f.publish<nav>(x); });
+    benchmark("InterProcessForwarder::publish, Publisher constructed per call",
+              [&](Forwarder& f) { f.publish<nav>(x, Publisher<std::string>()); });
+    benchmark("InterProcessForwarder::publish, non-default Publisher",
+              [&](Forwarder& f) { f.publish<nav>(x, echo_publisher); });
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "goby/middleware/transport/interthread.h"
+#include "goby/test/middleware/queue_depth/test.pb.h"
+#include "goby/util/debug_logger.h"
+
+// checks that InterThreadTransporter subscriptions with a TransporterConfig::queue_depth only
+// receive the newest queue_depth data on each poll, and count the rest in Subscriber::dropped()
+// usage: goby_test_middleware_queue_depth [mutex|ring]
+
+using goby::test::middleware::protobuf::DepthSample;
+
+extern constexpr goby::middleware::Group latest{"Latest"};
+extern constexpr goby::middleware::Group mixed{"Mixed"};
+
+const std::size_t num_publish = 10;
+
+goby::middleware::Subscriber<DepthSample> make_subscriber(int queue_depth)
+{
+    goby::middleware::protobuf::TransporterConfig cfg;
+    cfg.set_queue_depth(queue_depth);
+    return goby::middleware::Subscriber<DepthSample>(cfg);
+}
+
+void publish(std::size_t begin, std::size_t end)
+{
+    goby::middleware::InterThreadTransporter publisher;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        DepthSample s;
+        s.set_index(i);
+        publisher.publish<latest>(s);
+        publisher.publish<mixed>(s);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    goby::glog.add_stream(goby::util::logger::DEBUG3, &std::cerr);
+    goby::glog.set_name(argv[0]);
+
+    std::string backend = (argc > 1) ? argv[1] : "mutex";
+    if (backend == "ring")
+        goby::middleware::InterThreadSettings::mailbox_backend =
+            goby::middleware::InterThreadSettings::MailboxBackend::LOCK_FREE_RING;
+    else if (backend != "mutex")
+    {
+        std::cerr << "Usage: " << argv[0] << " [mutex|ring]" << std::endl;
+        return 1;
+    }
+
+    goby::middleware::InterThreadTransporter transporter;
+
+    // "latest" only has depth limited subscriptions, "mixed" also has an unlimited one
+    std::vector<int> conflated, latest3, mixed2, mixed_all;
+    auto conflated_sub = make_subscriber(1);
+    auto latest3_sub = make_subscriber(3);
+    auto mixed2_sub = make_subscriber(2);
+
+    transporter.subscribe<latest, DepthSample>(
+        [&](const DepthSample& s) { conflated.push_back(s.index()); }, conflated_sub);
+    transporter.subscribe<latest, DepthSample>(
+        [&](const DepthSample& s) { latest3.push_back(s.index()); }, latest3_sub);
+    transporter.subscribe<mixed, DepthSample>(
+        [&](const DepthSample& s) { mixed2.push_back(s.index()); }, mixed2_sub);
+    transporter.subscribe<mixed, DepthSample>(
+        [&](const DepthSample& s) { mixed_all.push_back(s.index()); });
+
+    std::thread(publish, 0, num_publish).join();
+
+    // everything has been published before the poll, so it is delivered in one call
+    transporter.poll();
+
+    assert(conflated == std::vector<int>({9}));
+    assert(latest3 == std::vector<int>({7, 8, 9}));
+    assert(mixed2 == std::vector<int>({8, 9}));
+    assert(mixed_all.size() == num_publish && mixed_all.front() == 0 && mixed_all.back() == 9);
+
+    assert(conflated_sub.dropped() == num_publish - 1);
+    assert(latest3_sub.dropped() == num_publish - 3);
+    assert(mixed2_sub.dropped() == num_publish - 2);
+
+    // data published after a poll are delivered on the next one
+    std::thread(publish, num_publish, num_publish + 1).join();
+    transporter.poll();
+    assert(conflated.back() == 10 && latest3.back() == 10 && mixed2.back() == 10);
+    assert(conflated_sub.dropped() == num_publish - 1);
+
+    std::cout << "all tests passed" << std::endl;
+}
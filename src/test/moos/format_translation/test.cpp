@@ -0,0 +1,263 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+// tests that FormatSerializer and FormatParser give the same results as
+// MOOSTranslation<TECHNIQUE_FORMAT> and compares their speed
+
+#include <cassert>  // for assert
+#include <chrono>   // for steady_clock
+#include <iostream> // for cout
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <boost/algorithm/string/case_conv.hpp> // for to_upper_copy
+
+#include "goby/moos/moos_format_translation.h"
+#include "goby/moos/moos_protobuf_helpers.h"
+#include "goby/test/acomms/dccl1/test.pb.h"
+
+using goby::moos::FormatParser;
+using goby::moos::FormatSerializer;
+using goby::moos::protobuf::TranslatorEntry;
+using goby::test::acomms::protobuf::TestMsg;
+using Legacy = goby::moos::MOOSTranslation<TranslatorEntry::TECHNIQUE_FORMAT>;
+using SerializerAlgorithms =
+    google::protobuf::RepeatedPtrField<TranslatorEntry::PublishSerializer::Algorithm>;
+using ParserAlgorithms =
+    google::protobuf::RepeatedPtrField<TranslatorEntry::CreateParser::Algorithm>;
+
+void to_upper(goby::moos::transitional::DCCLMessageVal& val)
+{
+    val = boost::to_upper_copy(std::string(val));
+}
+
+TestMsg make_test_msg()
+{
+    TestMsg msg;
+    msg.set_double_default_optional(-12.125);
+    msg.set_float_default_optional(1.5);
+    msg.set_int32_default_optional(-2000);
+    msg.set_uint64_default_optional(12345678901);
+    msg.set_bool_default_optional(true);
+    msg.set_string_default_optional("Unicorn");
+    msg.set_bytes_default_optional(std::string("\x01\x02\xff", 3));
+    msg.set_enum_default_optional(goby::test::acomms::protobuf::ENUM_B);
+    msg.mutable_msg_default_optional()->set_val(19.998);
+    msg.mutable_msg_default_optional()->mutable_msg()->set_sval("deep");
+
+    msg.set_double_default_required(1.0 / 3);
+    msg.set_float_default_required(2.0f / 3);
+    msg.set_int32_default_required(3);
+    msg.set_int64_default_required(-4);
+    msg.set_uint32_default_required(5);
+    msg.set_uint64_default_required(6);
+    msg.set_sint32_default_required(-7);
+    msg.set_sint64_default_required(8);
+    msg.set_fixed32_default_required(9);
+    msg.set_fixed64_default_required(10);
+    msg.set_sfixed32_default_required(-11);
+    msg.set_sfixed64_default_required(12);
+    msg.set_bool_default_required(false);
+    msg.set_string_default_required("abc");
+    msg.set_bytes_default_required("def");
+    msg.set_enum_default_required(goby::test::acomms::protobuf::ENUM_C);
+    msg.mutable_msg_default_required()->mutable_msg()->set_val(45);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        msg.add_double_default_repeat(i + 0.25);
+        msg.add_float_default_repeat(i - 0.5);
+        msg.add_int32_default_repeat(-i);
+        msg.add_uint64_default_repeat(100 * i);
+        msg.add_bool_default_repeat(i % 2);
+        msg.add_string_default_repeat("s" + std::to_string(i));
+        msg.add_bytes_default_repeat(std::string(1, char(i)));
+        msg.add_enum_default_repeat(goby::test::acomms::protobuf::ENUM_A);
+        msg.add_msg_default_repeat()->set_val(i * 10);
+    }
+    return msg;
+}
+
+void check_serialize(const TestMsg& msg, const std::string& format, bool expect_compiled,
+                     const SerializerAlgorithms& algorithms = SerializerAlgorithms(),
+                     bool use_short_enum = false)
+{
+    FormatSerializer serializer(format, ",", algorithms, use_short_enum);
+    assert(serializer.precompile(msg.GetDescriptor()) == expect_compiled);
+
+    std::string legacy, compiled;
+    Legacy::serialize(&legacy, msg, algorithms, format, ",", use_short_enum);
+    serializer.serialize(&compiled, msg);
+
+    std::cout << "serialize \"" << format << "\": " << compiled << std::endl;
+    if (legacy != compiled)
+        std::cout << "expected: " << legacy << std::endl;
+    assert(legacy == compiled);
+}
+
+void check_parse(const std::string& in, const std::string& format, bool expect_compiled,
+                 const ParserAlgorithms& algorithms = ParserAlgorithms(),
+                 bool use_short_enum = false)
+{
+    FormatParser parser(format, ",", algorithms, use_short_enum);
+    assert(parser.precompile(TestMsg::descriptor()) == expect_compiled);
+
+    TestMsg legacy, compiled;
+    Legacy::parse(in, &legacy, format, ",", algorithms, use_short_enum);
+    parser.parse(in, &compiled);
+
+    std::cout << "parse \"" << format << "\" from \"" << in
+              << "\": " << compiled.ShortDebugString() << std::endl;
+    assert(legacy.SerializePartialAsString() == compiled.SerializePartialAsString());
+}
+
+template <typename Translate> double microseconds_per_message(int n, Translate translate)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) translate();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    goby::moos::transitional::DCCLAlgorithmPerformer::getInstance()->add_algorithm("to_upper",
+                                                                                   &to_upper);
+
+    TestMsg msg = make_test_msg();
+
+    // singular fields of each type
+    check_serialize(msg, "%1%;%2%;%3%;%4%;%6%;%13%;%14%;%15%;%16%;%17%", true);
+    check_serialize(msg,
+                    "%21%;%22%;%23%;%24%;%25%;%26%;%27%;%28%;%29%;%30%;%31%;%32%;%33%;%34%;%35%;"
+                    "%36%;%37%",
+                    true);
+    check_serialize(msg, "ENUM=%16%,%36%", true, SerializerAlgorithms(), true);
+
+    // repeated fields, whole and indexed (including past the end)
+    check_serialize(msg, "{%101%};{%102%};{%103%};{%106%};{%113%};{%114%};{%115%};{%116%}", true);
+    check_serialize(msg, "%101.0%,%101.3%,%101.5%,%106.1%,%113.2%,%116.7%,%117.1%", true);
+
+    // embedded messages, including repeated and duplicated specifiers
+    check_serialize(msg, "em.val=%17:1%,em.em.sval=%17:2:2%,em0.em1.val=%37:2:1%", true);
+    check_serialize(msg, "%117.1:1%/%117.3:1%/%17:1%/%17:1%", true);
+
+    // literals, unknown fields and values past the last argument
+    check_serialize(msg, "100%% of %14%", true);
+    check_serialize(msg, "NODE_REPORT", true);
+    check_serialize(msg, "%18%:%50%:%117%:%500%", true);
+    check_serialize(msg, "", true);
+
+    // algorithms
+    {
+        SerializerAlgorithms algorithms;
+        auto* algorithm = algorithms.Add();
+        algorithm->set_name("to_upper");
+        algorithm->set_primary_field(14);
+        algorithm->set_output_virtual_field(200);
+
+        // repeated primary fields are ignored
+        algorithm = algorithms.Add();
+        algorithm->set_name("to_upper");
+        algorithm->set_primary_field(114);
+        algorithm->set_output_virtual_field(201);
+
+        check_serialize(msg, "%14%->%200%,%201%,%199%", true, algorithms);
+        check_serialize(msg, "%17:2:2%", true, algorithms);
+        check_serialize(msg, "%17:5%", true, algorithms);
+    }
+
+    // directives only handled by boost::format
+    check_serialize(msg, "%s-%s", false);
+    check_serialize(msg, "%x", false);
+    check_serialize(msg, "%1$s", false);
+
+    // parsing
+    std::string report;
+    Legacy::serialize(&report, msg, SerializerAlgorithms(),
+                      "D=%1%,F=%2%,I=%3%,S=%14%,E=%16%,R={%103%},EM=%17:1%,X=%101.2%", ",");
+    check_parse(report, "D=%1%,F=%2%,I=%3%,S=%14%,E=%16%,R={%103%},EM=%17:1%,X=%101.2%", true);
+    check_parse(report, "d=%1%,f=%2%", true);
+    check_parse("a:b:c", "%14%:%34%:%114%", true);
+    check_parse("x=1,y=2", "%14%=%3%,", true);
+    check_parse("em=5.5;deep", "em=%17:1%;%17:2:2%", true);
+    check_parse("e=b", "e=%16%", true, ParserAlgorithms(), true);
+    check_parse("no separators here", "%14%-%34%", true);
+    {
+        ParserAlgorithms algorithms;
+        auto* algorithm = algorithms.Add();
+        algorithm->set_name("to_upper");
+        algorithm->set_primary_field(14);
+        check_parse("name=unicorn", "name=%14%", true, algorithms);
+    }
+
+    for (const char* bad_format : {"%abc%", "%999%", "%1:1%"})
+    {
+        FormatParser parser(bad_format, ",", ParserAlgorithms(), false);
+        assert(!parser.precompile(TestMsg::descriptor()));
+
+        TestMsg out;
+        bool threw = false;
+        try
+        {
+            parser.parse("1", &out);
+        }
+        catch (std::runtime_error&)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // speed comparison
+    {
+        const std::string format =
+            "NAME=%14%,X=%1%,Y=%21%,HEADING=%2%,REPEAT={%103%},EM=%17:1%,R2=%101.2%";
+        const int n = 20000;
+
+        FormatSerializer serializer(format, ",", SerializerAlgorithms(), false);
+        std::string out;
+        double legacy_us = microseconds_per_message(n, [&]() {
+            Legacy::serialize(&out, msg, SerializerAlgorithms(), format, ",");
+        });
+        double compiled_us =
+            microseconds_per_message(n, [&]() { serializer.serialize(&out, msg); });
+        std::cout << "serialize: MOOSTranslation: " << legacy_us
+                  << " us/msg, FormatSerializer: " << compiled_us << " us/msg" << std::endl;
+
+        FormatParser parser(format, ",", ParserAlgorithms(), false);
+        TestMsg parsed;
+        legacy_us = microseconds_per_message(n, [&]() {
+            parsed.Clear();
+            Legacy::parse(out, &parsed, format, ",");
+        });
+        compiled_us = microseconds_per_message(n, [&]() {
+            parsed.Clear();
+            parser.parse(out, &parsed);
+        });
+        std::cout << "parse: MOOSTranslation: " << legacy_us
+                  << " us/msg, FormatParser: " << compiled_us << " us/msg" << std::endl;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,180 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "goby/time/steady_clock.h"
+#include "goby/time/system_clock.h"
+#include "goby/time/virtual_clock.h"
+
+using goby::time::SimulatorSettings;
+using goby::time::SteadyClock;
+using goby::time::SystemClock;
+using goby::time::VirtualClock;
+
+// simulate six hours
+const SteadyClock::time_point end_time(std::chrono::hours(6));
+const SteadyClock::duration tick_period(std::chrono::seconds(10));
+const SteadyClock::duration other_period(std::chrono::seconds(7));
+const SteadyClock::time_point end_marker(SteadyClock::duration(-1));
+
+std::mutex consumer_mutex;
+std::condition_variable_any consumer_cv;
+std::deque<SteadyClock::time_point> consumer_queue;
+
+// order in which the timeouts occurred (virtual time, thread)
+std::mutex events_mutex;
+std::vector<std::pair<SteadyClock::time_point, int>> events;
+
+// wait (as a participant) until virtual time reaches t
+void sleep_until(std::mutex& m, std::condition_variable_any& cv, SteadyClock::time_point t)
+{
+    std::unique_lock<std::mutex> lock(m);
+    VirtualClock::active();
+    while (VirtualClock::wait_until(lock, cv, VirtualClock::deadline(t)) !=
+           std::cv_status::timeout)
+        ;
+    assert(SteadyClock::now() == t);
+
+    std::lock_guard<std::mutex> events_lock(events_mutex);
+    events.emplace_back(t, &m == &consumer_mutex ? 0 : 1);
+}
+
+// publishes each tick time to the consumer
+void ticker()
+{
+    std::mutex m;
+    std::condition_variable_any cv;
+    for (auto t = SteadyClock::time_point() + tick_period; t <= end_time; t += tick_period)
+    {
+        sleep_until(m, cv, t);
+        {
+            std::lock_guard<std::mutex> lock(consumer_mutex);
+            consumer_queue.push_back(t);
+        }
+        consumer_cv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(consumer_mutex);
+        consumer_queue.push_back(end_marker);
+    }
+    consumer_cv.notify_all();
+}
+
+// waits for events only (never times out)
+int consumer()
+{
+    int received = 0;
+    std::unique_lock<std::mutex> lock(consumer_mutex);
+    while (true)
+    {
+        VirtualClock::active();
+        while (consumer_queue.empty())
+            VirtualClock::wait_until(lock, consumer_cv, VirtualClock::duration::max());
+
+        auto t = consumer_queue.front();
+        consumer_queue.pop_front();
+        if (t == end_marker)
+            return received;
+
+        // time does not advance while the consumer has an event to process
+        assert(SteadyClock::now() == t);
+        ++received;
+    }
+}
+
+void other()
+{
+    std::mutex m;
+    std::condition_variable_any cv;
+    for (auto t = SteadyClock::time_point() + other_period; t <= end_time; t += other_period)
+        sleep_until(m, cv, t);
+}
+
+int main()
+{
+    SimulatorSettings::using_sim_time = true;
+    SimulatorSettings::using_virtual_time = true;
+
+    assert(SteadyClock::now() == SteadyClock::time_point());
+    assert(SystemClock::now().time_since_epoch() ==
+           std::chrono::duration_cast<SystemClock::duration>(
+               SimulatorSettings::reference_time.time_since_epoch()));
+
+    auto real_start = std::chrono::steady_clock::now();
+
+    int received = 0;
+    // hold time until all three threads are participants
+    for (int i = 0; i < 3; ++i) VirtualClock::expect();
+    std::thread consumer_thread([&]() {
+        VirtualClock::join();
+        received = consumer();
+    });
+    std::thread ticker_thread([]() {
+        VirtualClock::join();
+        ticker();
+    });
+    std::thread other_thread([]() {
+        VirtualClock::join();
+        other();
+    });
+    ticker_thread.join();
+    other_thread.join();
+    consumer_thread.join();
+
+    auto real_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start);
+    std::cout << "simulated " << std::chrono::duration<double>(end_time.time_since_epoch()).count()
+              << " s in " << real_elapsed.count() << " s" << std::endl;
+
+    assert(received == end_time.time_since_epoch() / tick_period);
+    assert(events.size() == static_cast<std::size_t>(end_time.time_since_epoch() / tick_period +
+                                                     end_time.time_since_epoch() / other_period));
+    for (std::size_t i = 1, n = events.size(); i < n; ++i)
+        assert(events[i - 1].first <= events[i].first);
+
+    // timeouts on real time clocks are treated as virtual time remaining (less the real time
+    // spent computing the deadline)
+    auto start = SteadyClock::now();
+    std::mutex m;
+    std::condition_variable_any cv;
+    {
+        std::unique_lock<std::mutex> lock(m);
+        auto deadline =
+            VirtualClock::deadline(std::chrono::system_clock::now() + std::chrono::minutes(5));
+        while (VirtualClock::wait_until(lock, cv, deadline) != std::cv_status::timeout)
+            ;
+    }
+    assert(SteadyClock::now() - start > std::chrono::minutes(5) - std::chrono::seconds(1));
+    assert(SteadyClock::now() - start <= std::chrono::minutes(5));
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -28,6 +28,7 @@
 #include "goby/acomms/modemdriver/rudics_packet.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
@@ -79,6 +80,49 @@ std::string randstring(int size)
     return test;
 }
 
+using goby::acomms::RudicsEncoding;
+
+void test_block(const std::string& in, const std::string& reserved, bool include_crc)
+{
+    std::string rudics, out;
+    goby::acomms::serialize_rudics_packet(in, &rudics, reserved, include_crc,
+                                          RudicsEncoding::BLOCK);
+    assert(rudics.back() == '\r');
+    for (char c : rudics.substr(0, rudics.size() - 1))
+        assert(reserved.find(c) == std::string::npos);
+
+    goby::acomms::parse_rudics_packet(&out, rudics, reserved, include_crc,
+                                      RudicsEncoding::BLOCK);
+    assert(in == out);
+}
+
+void benchmark(int size)
+{
+    const std::string in = randstring(size);
+    for (auto encoding : {RudicsEncoding::BASE_CONVERT, RudicsEncoding::BLOCK})
+    {
+        const int n = 20;
+        std::string rudics, out;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i)
+        {
+            goby::acomms::serialize_rudics_packet(in, &rudics, std::string("\0\r\n", 3) +
+                                                                   std::string(1, 0xff),
+                                                  true, encoding);
+            goby::acomms::parse_rudics_packet(&out, rudics, std::string("\0\r\n", 3) +
+                                                                 std::string(1, 0xff),
+                                              true, encoding);
+        }
+        auto end = std::chrono::steady_clock::now();
+        assert(in == out);
+
+        double seconds = std::chrono::duration<double>(end - start).count() / n;
+        std::cout << (encoding == RudicsEncoding::BLOCK ? "BLOCK" : "BASE_CONVERT") << ": "
+                  << size << " bytes encoded as " << rudics.size() << " bytes, "
+                  << size / seconds / 1e6 << " MB/s (serialize + parse)" << std::endl;
+    }
+}
+
 int main()
 {
     {
@@ -130,6 +174,40 @@ int main()
     std::cout << "fixed: ";
     intprint(out);
 
+    {
+        const std::string iridium_reserved = std::string("\0\r\n", 3) + std::string(1, 0xff);
+        for (int size : {0, 1, 2, 63, 64, 65, 127, 128, 129, 1500})
+        {
+            test_block(randstring(size), iridium_reserved, true);
+            test_block(randstring(size), "\r", false);
+            test_block(std::string(size, 0), iridium_reserved, true);
+            test_block(std::string(size, 0xff), iridium_reserved, true);
+        }
+        test_block(randstring(300), std::string(), false);
+
+        // a full block is one character longer than the input
+        std::string rudics;
+        goby::acomms::serialize_rudics_packet(randstring(128), &rudics, iridium_reserved, false,
+                                              RudicsEncoding::BLOCK);
+        assert(rudics.size() == 2 * (goby::acomms::rudics_block_size + 1) + 1);
+
+        // falls back to the other encoding
+        std::string bytes = randstring(200);
+        for (auto encoding : {RudicsEncoding::BASE_CONVERT, RudicsEncoding::BLOCK})
+        {
+            goby::acomms::serialize_rudics_packet(bytes, &rudics, iridium_reserved, true,
+                                                  encoding);
+            std::string parsed;
+            goby::acomms::parse_rudics_packet_any_encoding(&parsed, rudics, RudicsEncoding::BLOCK);
+            assert(parsed == bytes);
+            goby::acomms::parse_rudics_packet_any_encoding(&parsed, rudics,
+                                                           RudicsEncoding::BASE_CONVERT);
+            assert(parsed == bytes);
+        }
+    }
+
+    for (int size : {100, 1500, 5000, 15000}) benchmark(size);
+
     std::cout << "all tests passed" << std::endl;
 
     return 0;
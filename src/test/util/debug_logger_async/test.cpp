@@ -0,0 +1,151 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "goby/util/debug_logger.h"
+
+using goby::glog;
+using namespace goby::util::logger;
+
+constexpr int num_threads = 4;
+constexpr int lines_per_thread = 5000;
+
+// stream buffer that takes a long time to write each line
+class SlowBuf : public std::stringbuf
+{
+  protected:
+    int sync() override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        return std::stringbuf::sync();
+    }
+};
+
+// incremented while holding the logger mutex, so it gives the order lines were written in
+int sequence = 0;
+
+// write lines_per_thread lines from each of num_threads threads, returning the time taken
+double spew()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < lines_per_thread; ++i)
+                glog.is_debug1() && glog << "thread " << t << " line " << i << " sequence "
+                                         << sequence++ << std::endl;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// checks that each thread's lines are all present and in order (also across threads), returning
+// the number found
+int check_lines(std::stringstream& ss)
+{
+    std::vector<int> next(num_threads, 0);
+    int last_sequence = -1;
+    int found = 0;
+    std::string line;
+    while (std::getline(ss, line))
+    {
+        auto pos = line.find("D: thread ");
+        if (pos == std::string::npos)
+            continue;
+
+        std::stringstream fields(line.substr(pos + std::string("D: thread ").size()));
+        int t, i, s;
+        std::string word;
+        fields >> t >> word >> i >> word >> s;
+        assert(t >= 0 && t < num_threads);
+        assert(i == next[t]);
+        assert(s > last_sequence);
+        last_sequence = s;
+        ++next[t];
+        ++found;
+    }
+    return found;
+}
+
+int main()
+{
+    glog.set_name("test");
+    glog.set_lock_action(goby::util::logger_lock::lock);
+
+    std::stringstream ss;
+    glog.add_stream(DEBUG1, &ss);
+
+    double sync_time = spew();
+    assert(check_lines(ss) == num_threads * lines_per_thread);
+
+    ss.str("");
+    ss.clear();
+    glog.enable_async(lines_per_thread);
+    double async_time = spew();
+    glog.flush_async();
+    assert(glog.async_dropped() == 0);
+    assert(check_lines(ss) == num_threads * lines_per_thread);
+
+    std::cout << "sync: " << sync_time * 1e6 / (num_threads * lines_per_thread)
+              << " us/line, async: " << async_time * 1e6 / (num_threads * lines_per_thread)
+              << " us/line" << std::endl;
+
+    // lines written after the buffer fills are dropped and counted, not blocked on
+    glog.disable_async();
+    ss.str("");
+    ss.clear();
+    SlowBuf slow_buf;
+    std::ostream slow(&slow_buf);
+    glog.add_stream(DEBUG1, &slow);
+    glog.enable_async(16);
+
+    const int slow_lines = 1000;
+    for (int i = 0; i < slow_lines; ++i)
+        glog.is_debug1() && glog << "thread 0 line " << i << std::endl;
+    glog.flush_async();
+
+    int delivered = 0;
+    std::string line;
+    while (std::getline(ss, line))
+    {
+        if (line.find("D: thread 0 line ") != std::string::npos)
+            ++delivered;
+    }
+    std::uint64_t dropped = glog.async_dropped();
+    std::cout << "slow stream: delivered " << delivered << ", dropped " << dropped << std::endl;
+    assert(dropped > 0);
+    assert(delivered + dropped == slow_lines);
+
+    glog.disable_async();
+    assert(ss.str().find("glog dropped") != std::string::npos);
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
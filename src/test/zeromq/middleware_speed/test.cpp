@@ -25,6 +25,7 @@
 #include <sys/wait.h>
 
 #include <atomic>
+#include <cassert>
 #include <deque>
 
 #include <boost/units/io.hpp>
@@ -54,6 +55,10 @@ goby::middleware::InterThreadTransporter interthread2;
 
 std::atomic<double> start(0);
 std::atomic<double> end(0);
+double receive_start(0);
+// microseconds
+double total_latency(0);
+double max_latency(0);
 
 std::mutex cout_mutex;
 
@@ -107,7 +112,7 @@ void publisher(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg)
                       << goby::time::SystemClock::now<goby::time::SITime>() << std::endl;
         }
     }
-    else if (test == 1)
+    else
     {
         goby::zeromq::InterProcessPortal<> zmq(cfg);
         zmq.ready();
@@ -130,6 +135,7 @@ void publisher(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg)
             s.set_temperature(a++);
             s.set_salinity(30.1);
             s.set_depth(5.2);
+            s.set_publish_time(goby::time::SystemClock::now<goby::time::MicroTime>().value());
 #endif
             zmq.publish<sample1_group>(s);
 
@@ -149,6 +155,7 @@ void handle_sample1(const Type& sample)
     if (ipc_receive_count == 0)
     {
         std::lock_guard<decltype(cout_mutex)> lock(cout_mutex);
+        receive_start = goby::time::SystemClock::now().time_since_epoch() / std::chrono::seconds(1);
         std::cout << "Receive start: " << std::setprecision(15)
                   << goby::time::SystemClock::now<goby::time::SITime>() << std::endl;
     }
@@ -156,6 +163,16 @@ void handle_sample1(const Type& sample)
     //    std::cout << sample.ShortDebugString() << std::endl;
     ++ipc_receive_count;
 
+#ifndef LARGE_MESSAGE
+    if (sample.has_publish_time())
+    {
+        double latency = goby::time::SystemClock::now<goby::time::MicroTime>().value() -
+                         sample.publish_time();
+        total_latency += latency;
+        max_latency = std::max(max_latency, latency);
+    }
+#endif
+
     if ((ipc_receive_count % 100000) == 0)
         std::cout << ipc_receive_count << std::endl;
 
@@ -167,6 +184,13 @@ void handle_sample1(const Type& sample)
         if (test == 0)
             std::cout << "Seconds per message: " << std::setprecision(15)
                       << (end - start) / max_publish << std::endl;
+        else
+            std::cout << "Seconds per message (from first received): " << std::setprecision(15)
+                      << (end - receive_start) / (max_publish - 1) << std::endl;
+
+        if (test != 0)
+            std::cout << "Latency (microseconds): mean: " << total_latency / max_publish
+                      << ", max: " << max_latency << std::endl;
     }
 }
 
@@ -183,7 +207,7 @@ void subscriber(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg)
 
         while (ipc_receive_count < max_publish) { interthread2.poll(); }
     }
-    else if (test == 1)
+    else
     {
         goby::zeromq::InterProcessPortal<> zmq(cfg);
         zmq.subscribe<sample1_group, Type>(&handle_sample1);
@@ -202,10 +226,13 @@ void subscriber(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg)
 
 int main(int argc, char* argv[])
 {
-    if (argc == 2)
+    if (argc >= 2)
         test = std::stoi(argv[1]);
 
-    std::cout << "Running test type (0 = interthread, 1 = interprocess): " << test << std::endl;
+    std::cout << "Running test type (0 = interthread, 1 = interprocess, 2 = interprocess peer to "
+                 "peer, 3 = interprocess sharded router, 4 = interprocess batched "
+                 "[max_latency_us]): "
+              << test << std::endl;
 
     goby::zeromq::protobuf::InterProcessPortalConfig cfg;
     cfg.set_platform("test6_" + std::to_string(test));
@@ -214,10 +241,18 @@ int main(int argc, char* argv[])
     //cfg.set_tcp_port(10005);
     cfg.set_send_queue_size(max_publish);
     cfg.set_receive_queue_size(max_publish);
+    // publisher and subscriber connect directly, bypassing the Router
+    cfg.set_peer_to_peer(test == 2);
+    // groups are spread across several XPUB/XSUB proxies
+    if (test == 3)
+        cfg.set_router_shards(4);
+    // publications are packed into batches, trading latency for throughput
+    if (test == 4)
+        cfg.mutable_publish_batching()->set_max_latency_us(argc >= 3 ? std::stoi(argv[2]) : 1000);
 
     pid_t child_pid = 0;
     bool is_child = false;
-    if (test == 1)
+    if (test != 0)
     {
         child_pid = fork();
         is_child = (child_pid == 0);
@@ -267,6 +302,16 @@ int main(int argc, char* argv[])
         forward = false;
         t1.join();
 
+        if (test == 3)
+        {
+            auto status = router.status();
+            std::cout << "Router status: " << status.ShortDebugString() << std::endl;
+            assert(status.shard_size() == 4);
+            std::uint64_t messages = 0;
+            for (const auto& shard : status.shard()) messages += shard.messages();
+            assert(messages >= static_cast<std::uint64_t>(max_publish));
+        }
+
         manager_context.reset();
         router_context.reset();
         t10->join();
@@ -0,0 +1,246 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Binaries
+// ("The Goby Binaries").
+//
+// The Goby Binaries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// The Goby Binaries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cassert>    // for assert
+#include <chrono>     // for milliseconds
+#include <cstring>    // for memcmp
+#include <fcntl.h>    // for O_RDONLY
+#include <sys/mman.h> // for shm_open
+#include <sys/wait.h> // for waitpid
+#include <thread>     // for sleep_for
+#include <unistd.h>   // for fork
+
+#include "goby/util/debug_logger.h"
+#include "goby/zeromq/transport/shared_memory.h"
+
+using goby::zeromq::SharedMemoryReader;
+using goby::zeromq::SharedMemoryWriter;
+using goby::zeromq::protobuf::SharedMemoryDescriptor;
+
+const std::string identifier = std::string("/group/1/Type/1234/1/") + '\0';
+
+std::string payload(char c, std::size_t size) { return std::string(size, c); }
+
+bool matches(const SharedMemoryReader::View& view, const std::string& data)
+{
+    return view.size() == identifier.size() + data.size() &&
+           std::memcmp(view.data(), identifier.data(), identifier.size()) == 0 &&
+           std::memcmp(view.data() + identifier.size(), data.data(), data.size()) == 0;
+}
+
+SharedMemoryDescriptor write(SharedMemoryWriter& writer, const std::string& data)
+{
+    SharedMemoryDescriptor descriptor;
+    bool written = writer.write(identifier, data.data(), data.size(), &descriptor);
+    assert(written);
+    return descriptor;
+}
+
+int main(int /*argc*/, char* argv[])
+{
+    goby::glog.add_stream(goby::util::logger::DEBUG3, &std::cerr);
+    goby::glog.set_name(argv[0]);
+
+    goby::zeromq::protobuf::SharedMemoryConfig cfg;
+    cfg.set_threshold(100);
+    cfg.set_slot_count(2);
+    cfg.set_slot_size(4096);
+    // slots are reused as soon as they are released (min_slot_reuse_ms is tested below)
+    cfg.set_min_slot_reuse_ms(0);
+
+    std::string name = SharedMemoryWriter::unique_name("test/platform");
+    assert(name.find('/', 1) == std::string::npos);
+
+    std::string e = payload('e', 500);
+    std::unique_ptr<SharedMemoryReader::View> view_e;
+    {
+        SharedMemoryWriter writer(cfg, name);
+        SharedMemoryReader reader;
+
+        assert(!writer.use_for(99));
+        assert(writer.use_for(100));
+
+        // too large for a slot
+        {
+            SharedMemoryDescriptor descriptor;
+            auto data = payload('x', cfg.slot_size());
+            assert(!writer.write(identifier, data.data(), data.size(), &descriptor));
+        }
+
+        // write and read
+        auto a = payload('a', 1000);
+        auto desc_a = write(writer, a);
+        assert(desc_a.segment() == name);
+        assert(desc_a.slot() == 0);
+        {
+            auto view = reader.acquire(desc_a);
+            assert(view);
+            assert(matches(*view, a));
+        }
+
+        // read from another process
+        auto b = payload('b', 3000);
+        auto desc_b = write(writer, b);
+        assert(desc_b.slot() == 1);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            bool ok = false;
+            {
+                SharedMemoryReader child_reader;
+                auto view = child_reader.acquire(desc_b);
+                ok = view && matches(*view, b);
+            }
+            exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        int status;
+        waitpid(child, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+
+        // slots are reused in turn, invalidating previous descriptors
+        auto c = payload('c', 200);
+        auto desc_c = write(writer, c);
+        assert(desc_c.slot() == 0);
+        assert(!reader.acquire(desc_a));
+        assert(reader.dropped() == 1);
+        auto view_c = reader.acquire(desc_c);
+        assert(view_c && matches(*view_c, c));
+
+        // slot 0 is pinned by view_c, so slot 1 is used (again)
+        auto d = payload('d', 300);
+        auto desc_d = write(writer, d);
+        assert(desc_d.slot() == 1);
+        assert(!reader.acquire(desc_b));
+        assert(reader.dropped() == 2);
+        auto view_d = reader.acquire(desc_d);
+        assert(view_d && matches(*view_d, d));
+
+        // both slots pinned: no space
+        {
+            SharedMemoryDescriptor descriptor;
+            assert(!writer.write(identifier, e.data(), e.size(), &descriptor));
+        }
+
+        // contents are unchanged while pinned
+        assert(matches(*view_c, c));
+        assert(matches(*view_d, d));
+
+        view_d.reset();
+        auto desc_e = write(writer, e);
+        assert(desc_e.slot() == 1);
+        view_e = reader.acquire(desc_e);
+        assert(view_e && matches(*view_e, e));
+
+        // invalid slot
+        auto desc_invalid = desc_e;
+        desc_invalid.set_slot(cfg.slot_count());
+        assert(!reader.acquire(desc_invalid));
+    }
+
+    // views keep the segment mapped after the writer is gone
+    assert(matches(*view_e, e));
+    view_e.reset();
+
+    // writer has unlinked the segment
+    assert(shm_open(name.c_str(), O_RDONLY, 0) == -1);
+
+    // slots are not reused until min_slot_reuse_ms after they were written, even if one of the
+    // subscribers has already read (and released) them
+    {
+        auto reuse_cfg = cfg;
+        reuse_cfg.set_min_slot_reuse_ms(50);
+        SharedMemoryWriter writer(reuse_cfg, SharedMemoryWriter::unique_name("test/platform"));
+        SharedMemoryReader fast_reader, slow_reader;
+
+        auto f = payload('f', 100);
+        auto g = payload('g', 100);
+        auto desc_f = write(writer, f);
+        auto desc_g = write(writer, g);
+        assert(fast_reader.acquire(desc_f));
+        assert(fast_reader.acquire(desc_g));
+        {
+            SharedMemoryDescriptor descriptor;
+            assert(!writer.write(identifier, f.data(), f.size(), &descriptor));
+        }
+
+        // the descriptors were still valid for the second subscriber
+        auto view_f = slow_reader.acquire(desc_f);
+        assert(view_f && matches(*view_f, f));
+        view_f.reset();
+        auto view_g = slow_reader.acquire(desc_g);
+        assert(view_g && matches(*view_g, g));
+        view_g.reset();
+        assert(slow_reader.dropped() == 0);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2 * reuse_cfg.min_slot_reuse_ms()));
+        auto desc_h = write(writer, payload('h', 100));
+        assert(desc_h.slot() == desc_f.slot());
+        assert(!slow_reader.acquire(desc_f));
+        assert(slow_reader.dropped() == 1);
+    }
+
+    // segments are unlinked when a process exits without destroying its writers, and segments of
+    // processes that were killed are removed by remove_stale()
+    for (bool killed : {false, true})
+    {
+        int fds[2];
+        int rc = pipe(fds);
+        assert(rc == 0);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            auto* writer =
+                new SharedMemoryWriter(cfg, SharedMemoryWriter::unique_name("test/platform"));
+            if (::write(fds[1], writer->name().c_str(), writer->name().size() + 1) <= 0)
+                _exit(EXIT_FAILURE);
+            if (killed)
+                _exit(EXIT_SUCCESS);
+            else
+                exit(EXIT_SUCCESS);
+        }
+        char child_name[256];
+        auto bytes_read = read(fds[0], child_name, sizeof(child_name));
+        assert(bytes_read > 0);
+        close(fds[0]);
+        close(fds[1]);
+        int status;
+        waitpid(child, &status, 0);
+
+        SharedMemoryWriter live_writer(cfg, SharedMemoryWriter::unique_name("test/platform"));
+        if (killed)
+        {
+            int fd = shm_open(child_name, O_RDONLY, 0);
+            assert(fd != -1);
+            close(fd);
+            SharedMemoryWriter::remove_stale("test/platform");
+        }
+        assert(shm_open(child_name, O_RDONLY, 0) == -1);
+
+        // but not those of running processes
+        int fd = shm_open(live_writer.name().c_str(), O_RDONLY, 0);
+        assert(fd != -1);
+        close(fd);
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -25,6 +25,7 @@
 #include <sys/wait.h>
 
 #include <atomic>
+#include <cassert>
 #include <deque>
 
 #include "goby/middleware/marshalling/protobuf.h"
@@ -91,11 +92,32 @@ void handle_sample1(const Sample& sample)
     ++ipc_receive_count;
 }
 
+// both sample2 subscriptions should receive the same (singly parsed) message
+std::shared_ptr<const Sample> sample2_a, sample2_b;
+void check_sample2_shared()
+{
+    if (sample2_a && sample2_b)
+    {
+        assert(sample2_a == sample2_b);
+        sample2_a.reset();
+        sample2_b.reset();
+    }
+}
+
 void handle_sample2(const std::shared_ptr<const Sample>& sample)
 {
     glog.is(DEBUG1) && glog << "InterProcessPortal received publication sample2: "
                             << sample->ShortDebugString() << std::endl;
     ++ipc_receive_count;
+    sample2_a = sample;
+    check_sample2_shared();
+}
+
+void handle_sample2_again(const std::shared_ptr<const Sample>& sample)
+{
+    ++ipc_receive_count;
+    sample2_b = sample;
+    check_sample2_shared();
 }
 
 void handle_widget(const Widget& widget)
@@ -112,11 +134,12 @@ void subscriber(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg)
     glog.is(DEBUG1) && glog << "Subscriber InterProcessPortal constructed" << std::endl;
     zmq.subscribe<sample1, Sample>(&handle_sample1);
     zmq.subscribe<sample2, Sample>(&handle_sample2);
+    zmq.subscribe<sample2, Sample>(&handle_sample2_again);
     zmq.subscribe<widget, Widget>(&handle_widget);
     zmq.ready();
-    while (ipc_receive_count < 3 * max_publish)
+    while (ipc_receive_count < 4 * max_publish)
     {
-        glog.is(DEBUG1) && glog << ipc_receive_count << "/" << 3 * max_publish << std::endl;
+        glog.is(DEBUG1) && glog << ipc_receive_count << "/" << 4 * max_publish << std::endl;
         zmq.poll();
     }
     glog.is(DEBUG1) && glog << "Subscriber complete." << std::endl;
@@ -35,6 +35,7 @@
 
 bool goby::time::SimulatorSettings::using_sim_time = false;
 int goby::time::SimulatorSettings::warp_factor = 1;
+bool goby::time::SimulatorSettings::using_virtual_time = false;
 
 // creates the default reference time, which is Jan 1 of the current year
 std::chrono::system_clock::time_point create_reference_time()
@@ -40,6 +40,8 @@ struct SimulatorSettings
     static int warp_factor;
     /// \brief Reference time when calculating SystemClock::now(). If this is unset, the default is 1 January of the current year.
     static std::chrono::system_clock::time_point reference_time;
+    /// \brief If true, SteadyClock::now() and SystemClock::now() return discrete-event virtual time controlled by VirtualClock rather than warped real time (warp_factor is not used)
+    static bool using_virtual_time;
 };
 
 } // namespace time
@@ -1,2 +1,3 @@
 set(TIME_SRC
-  time/simulation.cpp)
+  time/simulation.cpp
+  time/virtual_clock.cpp)
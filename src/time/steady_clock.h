@@ -28,6 +28,7 @@
 #include <chrono>
 
 #include "goby/time/simulation.h"
+#include "goby/time/virtual_clock.h"
 
 namespace goby
 {
@@ -45,7 +46,7 @@ struct SteadyClock
     typedef std::chrono::time_point<SteadyClock> time_point;
     static const bool is_steady = true;
 
-    /// \brief Returns the current steady time unless `SimulatorSettings::using_sim_time == true` in which case a simulated time is returned that is sped up by (multiplied by) the `SimulatorSettings::warp_factor`
+    /// \brief Returns the current steady time unless `SimulatorSettings::using_sim_time == true` in which case a simulated time is returned that is sped up by (multiplied by) the `SimulatorSettings::warp_factor` (or VirtualClock::elapsed() if `SimulatorSettings::using_virtual_time == true`)
     static time_point now() noexcept
     {
         using namespace std::chrono;
@@ -53,6 +54,8 @@ struct SteadyClock
 
         if (!SimulatorSettings::using_sim_time)
             return time_point(duration_cast<duration>(now.time_since_epoch()));
+        else if (SimulatorSettings::using_virtual_time)
+            return time_point(VirtualClock::elapsed());
         else
             return time_point(SimulatorSettings::warp_factor *
                               duration_cast<duration>(now.time_since_epoch()));
@@ -28,6 +28,7 @@
 #include <cstdint>
 
 #include "goby/time/simulation.h"
+#include "goby/time/virtual_clock.h"
 
 namespace goby
 {
@@ -59,6 +60,7 @@ struct SystemClock
     ///
     /// When using simulated time, the returned time (t_sim) is computed relative to SimulatorSettings::reference_time (t_0) with an accelerated progression by a factor of the SimulatorSettings::warp_time (w) such that:
     /// t_sim = (t-t_0)*w + t_0
+    /// When using virtual time (SimulatorSettings::using_virtual_time), the returned time is SimulatorSettings::reference_time + VirtualClock::elapsed().
     /// A note when using MOOS middleware's MOOSTimeWarp: the value returned by this function is the same as MOOSTime() when \code SimulatorSettings::reference_time == 0 \endcode
     static time_point now() noexcept
     {
@@ -67,6 +69,10 @@ struct SystemClock
 
         if (!SimulatorSettings::using_sim_time)
             return time_point(duration_cast<duration>(now.time_since_epoch()));
+        else if (SimulatorSettings::using_virtual_time)
+            return time_point(
+                duration_cast<duration>(SimulatorSettings::reference_time.time_since_epoch()) +
+                VirtualClock::elapsed());
         else
             return warp(now);
     }
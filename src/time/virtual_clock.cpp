@@ -0,0 +1,223 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm> // for min
+#include <list>      // for list
+#include <mutex>     // for mutex, lock_guard
+
+#include "goby/time/steady_clock.h"  // for SteadyClock
+#include "goby/time/system_clock.h"  // for SystemClock
+#include "goby/time/virtual_clock.h" // for VirtualClock
+
+std::atomic<std::int64_t> goby::time::VirtualClock::elapsed_{0};
+
+namespace
+{
+using goby::time::VirtualClock;
+
+struct Participant
+{
+    // waiting in VirtualClock::wait_until()
+    bool idle{false};
+    // has done work since last waiting
+    bool busy{true};
+    // has checked for events since the last participant finished doing work
+    std::uint64_t confirmed_epoch{0};
+    bool confirm_requested{false};
+    VirtualClock::duration deadline{VirtualClock::duration::max()};
+    std::condition_variable_any* cv{nullptr};
+};
+
+struct Authority
+{
+    std::mutex mutex;
+    std::list<Participant> participants;
+    // incremented each time a busy participant becomes idle
+    std::uint64_t epoch{0};
+    // calls to expect() not yet matched by join()
+    int expected{0};
+};
+
+Authority& authority()
+{
+    static Authority authority;
+    return authority;
+}
+
+struct ThreadParticipant
+{
+    ~ThreadParticipant() { VirtualClock::leave(); }
+    bool registered{false};
+    std::list<Participant>::iterator it;
+};
+thread_local ThreadParticipant this_thread;
+
+Participant& self(Authority& a)
+{
+    if (!this_thread.registered)
+    {
+        this_thread.it = a.participants.emplace(a.participants.end());
+        this_thread.registered = true;
+    }
+    return *this_thread.it;
+}
+
+// advances time to the next deadline if all the participants are idle and have checked for
+// events caused by the work done by the others (must hold authority().mutex)
+void advance_if_idle(Authority& a, std::atomic<std::int64_t>& elapsed)
+{
+    if (a.expected > 0)
+        return;
+
+    for (const auto& p : a.participants)
+    {
+        if (!p.idle)
+            return;
+    }
+
+    bool confirming = false;
+    for (auto& p : a.participants)
+    {
+        if (p.confirmed_epoch < a.epoch)
+        {
+            confirming = true;
+            if (!p.confirm_requested)
+            {
+                p.confirm_requested = true;
+                p.cv->notify_all();
+            }
+        }
+    }
+    if (confirming)
+        return;
+
+    auto next = VirtualClock::duration::max();
+    for (const auto& p : a.participants) next = std::min(next, p.deadline);
+
+    // everyone is waiting on events that will never come
+    if (next == VirtualClock::duration::max())
+        return;
+
+    if (next.count() > elapsed.load(std::memory_order_relaxed))
+        elapsed.store(next.count(), std::memory_order_release);
+
+    for (auto& p : a.participants)
+    {
+        if (p.deadline <= next)
+            p.cv->notify_all();
+    }
+}
+} // namespace
+
+bool goby::time::VirtualClock::begin_wait(std::condition_variable_any* cv, duration deadline)
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    Participant& p = self(a);
+    if (p.busy)
+    {
+        ++a.epoch;
+        p.busy = false;
+    }
+    p.idle = true;
+    p.deadline = deadline;
+    p.cv = cv;
+    p.confirmed_epoch = a.epoch;
+    p.confirm_requested = false;
+
+    advance_if_idle(a, elapsed_);
+    return elapsed() < deadline;
+}
+
+std::cv_status goby::time::VirtualClock::end_wait(duration deadline)
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    Participant& p = self(a);
+    p.idle = false;
+    p.cv = nullptr;
+    p.confirm_requested = false;
+    return elapsed() >= deadline ? std::cv_status::timeout : std::cv_status::no_timeout;
+}
+
+void goby::time::VirtualClock::expect()
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    ++a.expected;
+}
+
+void goby::time::VirtualClock::join()
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    self(a).busy = true;
+    if (a.expected > 0)
+        --a.expected;
+}
+
+void goby::time::VirtualClock::active()
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    self(a).busy = true;
+}
+
+void goby::time::VirtualClock::leave()
+{
+    if (!this_thread.registered)
+        return;
+
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    if (this_thread.it->busy)
+        ++a.epoch;
+    a.participants.erase(this_thread.it);
+    this_thread.registered = false;
+
+    advance_if_idle(a, elapsed_);
+}
+
+void goby::time::VirtualClock::reset()
+{
+    Authority& a = authority();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    elapsed_.store(0, std::memory_order_release);
+}
+
+goby::time::VirtualClock::duration goby::time::VirtualClock::deadline(
+    const std::chrono::time_point<SteadyClock, duration>& timeout)
+{
+    return timeout.time_since_epoch();
+}
+
+goby::time::VirtualClock::duration goby::time::VirtualClock::deadline(
+    const std::chrono::time_point<SystemClock, duration>& timeout)
+{
+    if (timeout == SystemClock::time_point::max())
+        return duration::max();
+
+    return timeout.time_since_epoch() -
+           std::chrono::duration_cast<duration>(
+               SimulatorSettings::reference_time.time_since_epoch());
+}
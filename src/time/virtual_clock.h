@@ -0,0 +1,134 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_TIME_VIRTUAL_CLOCK_H
+#define GOBY_TIME_VIRTUAL_CLOCK_H
+
+#include <atomic>             // for atomic
+#include <chrono>             // for microseconds, time_point
+#include <condition_variable> // for condition_variable_any, cv_status
+#include <cstdint>            // for int64_t
+
+#include "goby/time/simulation.h"
+
+namespace goby
+{
+namespace time
+{
+struct SteadyClock;
+struct SystemClock;
+
+/// \brief Central time authority for discrete-event (virtual time) simulation
+///
+/// When enabled (SimulatorSettings::using_sim_time and SimulatorSettings::using_virtual_time), SteadyClock::now() and SystemClock::now() return virtual time, which only moves when every participant is idle. It then jumps directly to the earliest deadline any participant is waiting for. A participant is any thread that has called wait_until() (e.g. through goby::middleware::PollerInterface::poll()) and has not left. Thus, simulations run as fast as the participants can process events, and the order of timeouts does not depend on the wall clock.
+///
+/// Only participants within this process are coordinated, so events arriving from other processes do not hold back time. A participant that blocks outside of wait_until() (e.g. on I/O) holds back time until it returns. To avoid time advancing before a new thread has started waiting, call expect() before launching it and join() at the start of the thread.
+class VirtualClock
+{
+  public:
+    /// \brief Virtual time resolution (same as SteadyClock and SystemClock)
+    using duration = std::chrono::microseconds;
+
+    /// \brief Is virtual time enabled?
+    static bool enabled()
+    {
+        return SimulatorSettings::using_sim_time && SimulatorSettings::using_virtual_time;
+    }
+
+    /// \brief Virtual time elapsed since the start of the simulation
+    static duration elapsed() { return duration(elapsed_.load(std::memory_order_acquire)); }
+
+    /// \brief Block the calling participant until notified on \c cv or until elapsed() reaches \c deadline
+    ///
+    /// Registers the calling thread as a participant (if it is not already one) and marks it idle while waiting.
+    /// \param lock Lock held on the mutex protecting the events notified on \c cv (released while waiting)
+    /// \param cv Condition variable notified when an event for this participant occurs
+    /// \param deadline Virtual time to wait until (duration::max() to wait for events only)
+    /// \return std::cv_status::timeout if elapsed() reached \c deadline, otherwise std::cv_status::no_timeout, after which the caller should check for events and wait again if there are none (as for a spurious wakeup of std::condition_variable_any::wait_until)
+    template <typename Lock>
+    static std::cv_status wait_until(Lock& lock, std::condition_variable_any& cv,
+                                     duration deadline);
+
+    /// \brief Hold virtual time until a matching call to join() (e.g. before launching a thread that will be a participant)
+    static void expect();
+
+    /// \brief Register the calling thread as a (busy) participant, releasing one expect()
+    static void join();
+
+    /// \brief Mark that the calling participant has done work since it last waited (e.g. published data), so all other participants check for events before time next advances
+    static void active();
+
+    /// \brief Stop treating the calling thread as a participant (done automatically when the thread exits)
+    static void leave();
+
+    /// \brief Converts a timeout for any clock into the elapsed() value at which it occurs
+    ///
+    /// The time remaining until the timeout on real-time clocks (e.g. std::chrono::system_clock) is treated as virtual time.
+    template <typename Clock, typename Duration>
+    static duration deadline(const std::chrono::time_point<Clock, Duration>& timeout)
+    {
+        using namespace std::chrono;
+        if (timeout == time_point<Clock, Duration>::max())
+            return duration::max();
+
+        auto now = Clock::now();
+        if (timeout <= now)
+            return elapsed();
+        auto remaining = duration_cast<duration>(timeout - now);
+        return (remaining > duration::max() - elapsed()) ? duration::max() : elapsed() + remaining;
+    }
+    static duration deadline(const std::chrono::time_point<SteadyClock, duration>& timeout);
+    static duration deadline(const std::chrono::time_point<SystemClock, duration>& timeout);
+
+    /// \brief Reset elapsed() to zero. Only intended for use between simulations when no participant is waiting.
+    static void reset();
+
+  private:
+    // returns false if time advanced to deadline without waiting
+    static bool begin_wait(std::condition_variable_any* cv, duration deadline);
+    static std::cv_status end_wait(duration deadline);
+
+  private:
+    static std::atomic<std::int64_t> elapsed_;
+};
+
+} // namespace time
+} // namespace goby
+
+template <typename Lock>
+std::cv_status goby::time::VirtualClock::wait_until(Lock& lock, std::condition_variable_any& cv,
+                                                    duration deadline)
+{
+    if (elapsed() >= deadline)
+        return std::cv_status::timeout;
+
+    // also wake up periodically (in real time) so that the caller checks for events that were
+    // notified between begin_wait() and cv.wait_for()
+    const std::chrono::milliseconds recheck_interval(1);
+
+    if (begin_wait(&cv, deadline))
+        cv.wait_for(lock, recheck_interval);
+    return end_wait(deadline);
+}
+
+#endif
@@ -76,6 +76,36 @@ class FlexOstream : public std::ostream
         sb_.enable_gui();
     }
 
+    /// \brief Write to the attached streams (and GUI) from a background thread. Lines are still formatted (and timestamped) by the calling thread, but the I/O is removed from the calling thread.
+    ///
+    /// \param buffer_size Maximum number of lines queued for each thread writing to the logger before further lines are dropped (see async_dropped())
+    void enable_async(std::size_t buffer_size = 1024)
+    {
+        std::lock_guard<std::recursive_mutex> l(goby::util::logger::mutex);
+        sb_.enable_async(buffer_size);
+    }
+
+    /// \brief Write out any queued lines and return to writing from the calling thread
+    void disable_async()
+    {
+        std::lock_guard<std::recursive_mutex> l(goby::util::logger::mutex);
+        sb_.disable_async();
+    }
+
+    /// \brief Block until all lines written so far are written to the attached streams (when enable_async() has been called)
+    void flush_async()
+    {
+        std::lock_guard<std::recursive_mutex> l(goby::util::logger::mutex);
+        sb_.flush_async();
+    }
+
+    /// \brief Number of lines dropped because the asynchronous buffer was full
+    std::uint64_t async_dropped()
+    {
+        std::lock_guard<std::recursive_mutex> l(goby::util::logger::mutex);
+        return sb_.async_dropped();
+    }
+
     bool is(goby::util::logger::Verbosity verbosity);
 
     bool is_die() { return is(goby::util::logger::DIE); }
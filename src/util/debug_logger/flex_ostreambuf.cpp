@@ -22,24 +22,25 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <algorithm> // for copy, max
-#include <atomic>    // for atomic
-#include <cassert>   // for assert
-#include <chrono>    // for time_point
-#include <cstdio>    // for EOF
-#include <cstdlib>   // for exit
-#include <deque>     // for deque
-#include <iomanip>   // for operator<<
-#include <iostream>  // for operator<<
-#include <iterator>  // for ostreamb...
-#include <map>       // for map, map...
-#include <memory>    // for make_shared
-#include <mutex>     // for mutex
-#include <sstream>   // for basic_st...
-#include <string>    // for string
-#include <thread>    // for thread
-#include <utility>   // for move, pair
-#include <vector>    // for vector
+#include <algorithm>          // for copy, max
+#include <atomic>             // for atomic
+#include <cassert>            // for assert
+#include <chrono>             // for time_point
+#include <condition_variable> // for condition_variable
+#include <cstdio>             // for EOF
+#include <cstdlib>            // for exit
+#include <deque>              // for deque
+#include <iomanip>            // for operator<<
+#include <iostream>           // for operator<<
+#include <iterator>           // for ostreamb...
+#include <map>                // for map, map...
+#include <memory>             // for make_shared
+#include <mutex>              // for mutex
+#include <sstream>            // for basic_st...
+#include <string>             // for string
+#include <thread>             // for thread
+#include <utility>            // for move, pair
+#include <vector>             // for vector
 
 #include <boost/date_time/gregorian/gregorian.hpp>          // for date
 #include <boost/date_time/posix_time/posix_time_config.hpp> // for time_dur...
@@ -66,6 +67,264 @@ std::mutex curses_mutex;
 
 std::recursive_mutex goby::util::logger::mutex;
 
+namespace goby
+{
+namespace util
+{
+namespace detail
+{
+/// \brief Writes lines queued by FlexOStreamBuf::sync() to the attached streams from a background thread
+///
+/// Each thread writing to the logger queues its lines on its own fixed size single-producer/single-consumer ring, so queuing a line takes no locks beyond the logger::mutex already held for formatting. Lines carry a sequence number so that the order they were written in across threads is preserved.
+class AsyncLogWriter
+{
+  public:
+    AsyncLogWriter(FlexOStreamBuf* buf, std::size_t buffer_size)
+        : buf_(buf),
+          buffer_size_(std::max<std::size_t>(buffer_size, 1)),
+          id_(++next_id_),
+          thread_([this]() { run(); })
+    {
+    }
+
+    ~AsyncLogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            running_ = false;
+        }
+        wake_cv_.notify_one();
+        thread_.join();
+    }
+
+    void push(logger::Record&& record)
+    {
+        Ring& ring = thread_ring();
+        Entry entry{next_sequence_++, std::move(record)};
+        if (!ring.push(entry))
+        {
+            ++dropped_;
+            return;
+        }
+        ++pushed_;
+
+        // otherwise the writer thread picks up the line on its next poll
+        if (ring.size() > buffer_size_ / 2)
+            wake_cv_.notify_one();
+    }
+
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        const std::uint64_t target = pushed_;
+        flush_requested_ = true;
+        wake_cv_.notify_one();
+        flushed_cv_.wait(lock, [&]() { return written_ >= target; });
+    }
+
+    std::uint64_t dropped() const { return dropped_; }
+
+  private:
+    struct Entry
+    {
+        std::uint64_t sequence{0};
+        logger::Record record;
+    };
+
+    class Ring
+    {
+      public:
+        explicit Ring(std::size_t capacity) : cells_(capacity + 1) {}
+
+        // producer thread only, leaves entry untouched if the ring is full
+        bool push(Entry& entry)
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+            auto next = (head + 1) % cells_.size();
+            if (next == tail_.load(std::memory_order_acquire))
+                return false;
+            cells_[head] = std::move(entry);
+            head_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // writer thread only
+        bool pop(Entry& entry)
+        {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return false;
+            entry = std::move(cells_[tail]);
+            tail_.store((tail + 1) % cells_.size(), std::memory_order_release);
+            return true;
+        }
+
+        std::size_t size() const
+        {
+            auto head = head_.load(std::memory_order_acquire);
+            auto tail = tail_.load(std::memory_order_acquire);
+            return (head + cells_.size() - tail) % cells_.size();
+        }
+
+        std::atomic<bool> producer_exited{false};
+
+      private:
+        std::vector<Entry> cells_;
+        std::atomic<std::size_t> head_{0};
+        std::atomic<std::size_t> tail_{0};
+    };
+
+    Ring& thread_ring()
+    {
+        struct ThreadRing
+        {
+            ~ThreadRing()
+            {
+                if (ring)
+                    ring->producer_exited = true;
+            }
+            std::uint64_t writer_id{0};
+            std::shared_ptr<Ring> ring;
+        };
+        thread_local ThreadRing thread_ring;
+
+        if (thread_ring.writer_id != id_)
+        {
+            if (thread_ring.ring)
+                thread_ring.ring->producer_exited = true;
+            thread_ring.ring = std::make_shared<Ring>(buffer_size_);
+            thread_ring.writer_id = id_;
+
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            new_rings_.push_back(thread_ring.ring);
+        }
+        return *thread_ring.ring;
+    }
+
+    void run()
+    {
+        // popped but not yet written (newer than the newest line seen in the first pass)
+        std::vector<Entry> pending;
+        std::uint64_t reported_dropped = 0;
+        while (true)
+        {
+            // read before draining so that every line pushed before the destructor is written
+            bool stopping = false;
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stopping = !running_;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.insert(rings_.end(), new_rings_.begin(), new_rings_.end());
+                new_rings_.clear();
+            }
+
+            // Lines are pushed in sequence order (under logger::mutex), so once the first pass
+            // has seen a line, every earlier line is visible to the second pass. Lines newer
+            // than those seen in the first pass may have been pushed to a ring after the second
+            // pass drained it while an older line was pushed to a later ring, so they are held
+            // back until the next batch (where they count as seen before the first pass).
+            bool first_pass_popped = !pending.empty();
+            std::uint64_t max_first_pass_sequence = pending.empty() ? 0 : pending.back().sequence;
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                for (auto& ring : rings_)
+                {
+                    Entry entry;
+                    while (ring->pop(entry))
+                    {
+                        if (pass == 0)
+                        {
+                            first_pass_popped = true;
+                            max_first_pass_sequence =
+                                std::max(max_first_pass_sequence, entry.sequence);
+                        }
+                        pending.push_back(std::move(entry));
+                    }
+                }
+            }
+            std::sort(pending.begin(), pending.end(), [](const Entry& a, const Entry& b) {
+                return a.sequence < b.sequence;
+            });
+
+            // when stopping, all lines have been pushed so there is nothing to wait for
+            std::size_t written = 0;
+            while (written < pending.size() &&
+                   (stopping ||
+                    (first_pass_popped && pending[written].sequence <= max_first_pass_sequence)))
+            {
+                buf_->display(pending[written].record, false);
+                ++written;
+            }
+            pending.erase(pending.begin(), pending.begin() + written);
+
+            std::uint64_t dropped = dropped_;
+            if (dropped != reported_dropped)
+            {
+                std::stringstream ss;
+                ss << logger::warn << "glog dropped " << (dropped - reported_dropped)
+                   << " line(s) as the asynchronous buffer (" << buffer_size_
+                   << " lines per thread) was full";
+                logger::Record record{SystemClock::now(), logger::WARN, "", ss.str()};
+                buf_->display(record, false);
+                reported_dropped = dropped;
+            }
+
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                        [](const std::shared_ptr<Ring>& ring) {
+                                            return ring->producer_exited && ring->size() == 0;
+                                        }),
+                         rings_.end());
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            written_ += written;
+            flushed_cv_.notify_all();
+            if (stopping)
+                break;
+
+            if (written == 0 && pending.empty())
+            {
+                wake_cv_.wait_for(lock, poll_interval_,
+                                  [this]() { return !running_ || flush_requested_; });
+                flush_requested_ = false;
+            }
+        }
+    }
+
+  private:
+    FlexOStreamBuf* buf_;
+    const std::size_t buffer_size_;
+    const std::uint64_t id_;
+    static std::atomic<std::uint64_t> next_id_;
+    const std::chrono::milliseconds poll_interval_{10};
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> new_rings_;
+    // writer thread only
+    std::vector<std::shared_ptr<Ring>> rings_;
+
+    std::atomic<std::uint64_t> next_sequence_{0};
+    std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+    // protected by wake_mutex_
+    std::uint64_t written_{0};
+    bool flush_requested_{false};
+    bool running_{true};
+
+    std::thread thread_;
+};
+
+std::atomic<std::uint64_t> AsyncLogWriter::next_id_{0};
+} // namespace detail
+} // namespace util
+} // namespace goby
+
 goby::util::FlexOStreamBuf::FlexOStreamBuf(FlexOstream* parent)
     : buffer_(1),
       name_("no name"),
@@ -84,6 +343,8 @@ goby::util::FlexOStreamBuf::FlexOStreamBuf(FlexOstream* parent)
 
 goby::util::FlexOStreamBuf::~FlexOStreamBuf()
 {
+    disable_async();
+
 #ifdef HAS_NCURSES
     if (curses_)
         delete curses_;
@@ -92,6 +353,8 @@ goby::util::FlexOStreamBuf::~FlexOStreamBuf()
 
 void goby::util::FlexOStreamBuf::add_stream(logger::Verbosity verbosity, std::ostream* os)
 {
+    std::lock_guard<std::mutex> display_lock(display_mutex_);
+
     //check that this stream doesn't exist
     // if so, update its verbosity and return
     bool stream_exists = false;
@@ -118,6 +381,7 @@ void goby::util::FlexOStreamBuf::add_stream(logger::Verbosity verbosity, std::os
 void goby::util::FlexOStreamBuf::enable_gui()
 {
 #ifdef HAS_NCURSES
+    std::lock_guard<std::mutex> display_lock(display_mutex_);
 
     is_gui_ = true;
     curses_ = new FlexNCurses;
@@ -143,6 +407,8 @@ void goby::util::FlexOStreamBuf::enable_gui()
 
 void goby::util::FlexOStreamBuf::add_group(const std::string& name, logger::Group g)
 {
+    std::lock_guard<std::mutex> display_lock(display_mutex_);
+
     bool group_existed = groups_.count(name);
 
     groups_[name] = std::move(g);
@@ -187,10 +453,23 @@ int goby::util::FlexOStreamBuf::sync()
     }
 
     // all but last one
+    const auto now = SystemClock::now();
     while (buffer_.size() > 1)
     {
-        display(buffer_.front());
+        logger::Record record{now, current_verbosity_, group_name_, std::move(buffer_.front())};
         buffer_.pop_front();
+
+        if (async_ && !die_flag_)
+        {
+            async_->push(std::move(record));
+        }
+        else
+        {
+            // write out everything queued before this line (only relevant for die)
+            if (async_)
+                async_->flush();
+            display(record, die_flag_);
+        }
     }
 
     group_name_.erase();
@@ -208,39 +487,42 @@ int goby::util::FlexOStreamBuf::sync()
     return 0;
 }
 
-void goby::util::FlexOStreamBuf::display(std::string& s)
+void goby::util::FlexOStreamBuf::display(logger::Record& record, bool die)
 {
+    std::lock_guard<std::mutex> display_lock(display_mutex_);
+
+    std::string& s = record.text;
+    const std::string& group_name = record.group;
     bool gui_displayed = false;
     for (const StreamConfig& cfg : streams_)
     {
         if ((cfg.os() == &std::cout || cfg.os() == &std::cerr || cfg.os() == &std::clog) &&
-            current_verbosity_ <= cfg.verbosity())
+            record.verbosity <= cfg.verbosity())
         {
 #ifdef HAS_NCURSES
-            if (is_gui_ && current_verbosity_ <= cfg.verbosity() && !gui_displayed)
+            if (is_gui_ && record.verbosity <= cfg.verbosity() && !gui_displayed)
             {
-                if (!die_flag_)
+                if (!die)
                 {
                     std::lock_guard<std::mutex> lock(curses_mutex);
                     std::stringstream line;
-                    boost::posix_time::time_duration time_of_day =
-                        SystemClock::now<boost::posix_time::ptime>().time_of_day();
+                    const auto time = goby::time::convert<boost::posix_time::ptime>(record.time);
+                    boost::posix_time::time_duration time_of_day = time.time_of_day();
                     line << "\n"
                          << std::setfill('0') << std::setw(2) << time_of_day.hours() << ":"
                          << std::setw(2) << time_of_day.minutes() << ":" << std::setw(2)
                          << time_of_day.seconds()
-                         << TermColor::esc_code_from_col(groups_[group_name_].color()) << " | "
+                         << TermColor::esc_code_from_col(groups_[group_name].color()) << " | "
                          << esc_nocolor << s;
 
-                    curses_->insert(SystemClock::now<boost::posix_time::ptime>(), line.str(),
-                                    &groups_[group_name_]);
+                    curses_->insert(time, line.str(), &groups_[group_name]);
                 }
                 else
                 {
                     curses_->alive(false);
                     input_thread_->join();
                     curses_->cleanup();
-                    std::cerr << TermColor::esc_code_from_col(groups_[group_name_].color()) << name_
+                    std::cerr << TermColor::esc_code_from_col(groups_[group_name].color()) << name_
                               << esc_nocolor << ": " << s << esc_nocolor << std::endl;
                 }
                 gui_displayed = true;
@@ -251,22 +533,59 @@ void goby::util::FlexOStreamBuf::display(std::string& s)
             (void)gui_displayed;
 #endif
 
-            *cfg.os() << TermColor::esc_code_from_col(groups_[group_name_].color()) << name_
-                      << esc_nocolor << " [" << goby::time::str() << "]";
-            if (!group_name_.empty())
+            *cfg.os() << TermColor::esc_code_from_col(groups_[group_name].color()) << name_
+                      << esc_nocolor << " [" << goby::time::str(record.time) << "]";
+            if (!group_name.empty())
                 *cfg.os() << " "
-                          << "{" << group_name_ << "}";
+                          << "{" << group_name << "}";
             *cfg.os() << ": " << s << std::endl;
         }
-        else if (cfg.os() && current_verbosity_ <= cfg.verbosity())
+        else if (cfg.os() && record.verbosity <= cfg.verbosity())
         {
-            goby::util::logger::basic_log_header(*cfg.os(), group_name_);
+            goby::util::logger::basic_log_header(*cfg.os(), group_name, record.time);
             strip_escapes(s);
             *cfg.os() << s << std::endl;
         }
     }
 }
 
+void goby::util::FlexOStreamBuf::enable_async(std::size_t buffer_size)
+{
+    static FlexOStreamBuf* async_buf = nullptr;
+
+    if (async_)
+        return;
+
+    async_.reset(new detail::AsyncLogWriter(this, buffer_size));
+
+    // write out any remaining lines before static destruction (e.g. after exit())
+    if (!async_buf)
+    {
+        async_buf = this;
+        std::atexit([]() {
+            std::lock_guard<std::recursive_mutex> l(goby::util::logger::mutex);
+            async_buf->disable_async();
+        });
+    }
+}
+
+void goby::util::FlexOStreamBuf::disable_async()
+{
+    // the destructor writes all the queued lines before joining the writer thread
+    async_.reset();
+}
+
+void goby::util::FlexOStreamBuf::flush_async()
+{
+    if (async_)
+        async_->flush();
+}
+
+std::uint64_t goby::util::FlexOStreamBuf::async_dropped() const
+{
+    return async_ ? async_->dropped() : 0;
+}
+
 void goby::util::FlexOStreamBuf::refresh()
 {
 #ifdef HAS_NCURSES
@@ -26,6 +26,7 @@
 #define GOBY_UTIL_DEBUG_LOGGER_FLEX_OSTREAMBUF_H
 
 #include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <deque>
 #include <iostream>
@@ -38,6 +39,7 @@
 #include <boost/date_time.hpp>
 #include <memory>
 
+#include "goby/time/system_clock.h"
 #include "goby/util/protobuf/debug_logger.pb.h"
 
 #include "term_color.h"
@@ -79,8 +81,23 @@ enum Verbosity
     DEBUG3 = protobuf::GLogConfig::DEBUG3,
     DIE = -1
 };
+
+/// \brief One line written to the logger, along with the state needed to display it
+struct Record
+{
+    /// time the line was written (not displayed)
+    goby::time::SystemClock::time_point time;
+    Verbosity verbosity{UNKNOWN};
+    std::string group;
+    std::string text;
+};
 }; // namespace logger
 
+namespace detail
+{
+class AsyncLogWriter;
+}
+
 /// Class derived from std::stringbuf that allows us to insert things before the stream and control output. This is the string buffer used by goby::util::FlexOstream for the Goby Logger (glogger)
 class FlexOstream;
 
@@ -97,7 +114,11 @@ class FlexOStreamBuf : public std::streambuf
     int overflow(int c = EOF);
 
     /// name of the application being served
-    void name(const std::string& s) { name_ = s; }
+    void name(const std::string& s)
+    {
+        std::lock_guard<std::mutex> lock(display_mutex_);
+        name_ = s;
+    }
 
     /// add a stream to the logger
     void add_stream(logger::Verbosity verbosity, std::ostream* os);
@@ -132,8 +153,25 @@ class FlexOStreamBuf : public std::streambuf
 
     logger_lock::LockAction lock_action() { return lock_action_; }
 
+    /// \brief Write to the attached streams from a background thread rather than the thread calling sync()
+    ///
+    /// \param buffer_size Maximum number of lines queued for each thread writing to the logger. Lines written when this thread's queue is full are dropped and counted in async_dropped()
+    void enable_async(std::size_t buffer_size);
+
+    /// \brief Write out any queued lines and return to writing from the thread calling sync()
+    void disable_async();
+
+    bool is_async() const { return async_ != nullptr; }
+
+    /// \brief Block until all lines queued so far have been written (does nothing if !is_async())
+    void flush_async();
+
+    /// \brief Number of lines dropped since enable_async() because the writing thread's queue was full
+    std::uint64_t async_dropped() const;
+
   private:
-    void display(std::string& s);
+    friend class detail::AsyncLogWriter;
+    void display(logger::Record& record, bool die);
     void strip_escapes(std::string& s);
 
   private:
@@ -176,6 +214,10 @@ class FlexOStreamBuf : public std::streambuf
     std::atomic<logger::Verbosity> highest_verbosity_;
 
     std::atomic<logger_lock::LockAction> lock_action_;
+
+    // protects streams_, groups_, name_ and curses_ between display() and the configuration calls
+    std::mutex display_mutex_;
+    std::unique_ptr<detail::AsyncLogWriter> async_;
     //    FlexOstream* parent_;
 };
 } // namespace util
@@ -61,7 +61,13 @@ void goby::util::logger::GroupSetter::operator()(std::ostream& os) const
 
 std::ostream& goby::util::logger::basic_log_header(std::ostream& os, const std::string& group_name)
 {
-    os << "[ " << goby::time::str() << " ]";
+    return basic_log_header(os, group_name, goby::time::SystemClock::now());
+}
+
+std::ostream& goby::util::logger::basic_log_header(std::ostream& os, const std::string& group_name,
+                                                   goby::time::SystemClock::time_point time)
+{
+    os << "[ " << goby::time::str(time) << " ]";
 
     if (!group_name.empty())
         os << " " << std::setfill(' ') << std::setw(15) << "{" << group_name << "}";
@@ -29,6 +29,8 @@
 #include <string>
 #include <utility>
 
+#include "goby/time/system_clock.h"
+
 #include "term_color.h"
 
 namespace goby
@@ -116,6 +118,10 @@ class GroupSetter
 /// used for non tty ostreams (everything but std::cout / std::cerr) as the header for every line
 std::ostream& basic_log_header(std::ostream& os, const std::string& group_name);
 
+/// as basic_log_header(std::ostream&, const std::string&) but for a line written at the given time
+std::ostream& basic_log_header(std::ostream& os, const std::string& group_name,
+                               goby::time::SystemClock::time_point time);
+
 std::ostream& operator<<(std::ostream& os, const Group& g);
 inline std::ostream& operator<<(std::ostream& os, const GroupSetter& gs)
 {
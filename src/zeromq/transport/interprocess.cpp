@@ -22,6 +22,8 @@
 // along with Goby.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>   // for copy, max, copy_backward, equal, set_d...
+#include <cerrno>      // for errno, ESRCH
+#include <csignal>     // for kill
 #include <cstring>     // for memcpy, size_t
 #include <ostream>     // for endl, basic_ostream, basic_ostream<>::...
 #include <stdexcept>   // for runtime_error
@@ -46,6 +48,16 @@ auto zmq_send_flags_none{zmq::send_flags::none};
 auto zmq_recv_flags_none{zmq::recv_flags::none};
 #endif
 
+#ifdef USE_OLD_ZMQ_CPP_API
+int zmq_send_flags_sndmore{ZMQ_SNDMORE};
+int zmq_send_flags_dontwait{ZMQ_DONTWAIT};
+int zmq_recv_flags_dontwait{ZMQ_DONTWAIT};
+#else
+auto zmq_send_flags_sndmore{zmq::send_flags::sndmore};
+auto zmq_send_flags_dontwait{zmq::send_flags::dontwait};
+auto zmq_recv_flags_dontwait{zmq::recv_flags::dontwait};
+#endif
+
 bool zmq_socket_recv(zmq::socket_t& socket, zmq::message_t& msg,
                      goby::zeromq::zmq_recv_flags_type flags = zmq_recv_flags_none)
 {
@@ -56,6 +68,40 @@ bool zmq_socket_recv(zmq::socket_t& socket, zmq::message_t& msg,
 #endif
 }
 
+template <typename Flags>
+bool zmq_socket_send(zmq::socket_t& socket, zmq::message_t& msg, Flags flags)
+{
+#ifdef USE_OLD_ZMQ_CPP_API
+    return socket.send(msg, flags);
+#else
+    return bool(socket.send(msg, flags));
+#endif
+}
+
+std::string zmq_socket_endpoint(const goby::zeromq::protobuf::Socket& cfg)
+{
+    using goby::zeromq::protobuf::Socket;
+    bool bind = (cfg.connect_or_bind() == Socket::BIND);
+    switch (cfg.transport())
+    {
+        case Socket::IPC: return "ipc://" + cfg.socket_name();
+        case Socket::TCP:
+            return "tcp://" + (bind ? std::string("*") : cfg.ethernet_address()) + ":" +
+                   std::to_string(cfg.ethernet_port());
+        default:
+            throw(std::runtime_error("Unsupported transport type: " +
+                                     Socket::Transport_Name(cfg.transport())));
+    }
+}
+
+// IPC socket name for the given Router shard: shard 0 uses the names from before sharding
+std::string router_socket_name(const goby::zeromq::protobuf::InterProcessPortalConfig& cfg,
+                               const std::string& type, unsigned shard)
+{
+    return (cfg.has_socket_name() ? cfg.socket_name() : "/tmp/goby_" + cfg.platform()) + "." +
+           type + (shard == 0 ? std::string() : "." + std::to_string(shard));
+}
+
 void goby::zeromq::setup_socket(zmq::socket_t& socket, const protobuf::Socket& cfg)
 {
     int send_hwm = cfg.send_queue_size();
@@ -64,20 +110,7 @@ void goby::zeromq::setup_socket(zmq::socket_t& socket, const protobuf::Socket& c
     socket.setsockopt(ZMQ_RCVHWM, &receive_hwm, sizeof(receive_hwm));
 
     bool bind = (cfg.connect_or_bind() == protobuf::Socket::BIND);
-
-    std::string endpoint;
-    switch (cfg.transport())
-    {
-        case protobuf::Socket::IPC: endpoint = "ipc://" + cfg.socket_name(); break;
-        case protobuf::Socket::TCP:
-            endpoint = "tcp://" + (bind ? std::string("*") : cfg.ethernet_address()) + ":" +
-                       std::to_string(cfg.ethernet_port());
-            break;
-        default:
-            throw(std::runtime_error("Unsupported transport type: " +
-                                     protobuf::Socket::Transport_Name(cfg.transport())));
-            break;
-    }
+    std::string endpoint = zmq_socket_endpoint(cfg);
 
     if (bind)
         socket.bind(endpoint.c_str());
@@ -90,7 +123,7 @@ void goby::zeromq::setup_socket(zmq::socket_t& socket, const protobuf::Socket& c
 //
 
 goby::zeromq::InterProcessPortalMainThread::InterProcessPortalMainThread(zmq::context_t& context)
-    : control_socket_(context, ZMQ_PAIR), publish_socket_(context, ZMQ_PUB)
+    : context_(context), control_socket_(context, ZMQ_PAIR), publish_socket_(context, ZMQ_PUB)
 {
     control_socket_.bind("inproc://control");
 }
@@ -111,9 +144,16 @@ bool goby::zeromq::InterProcessPortalMainThread::recv(protobuf::InprocControl* c
     return message_received;
 }
 
-void goby::zeromq::InterProcessPortalMainThread::set_publish_cfg(const protobuf::Socket& cfg)
+void goby::zeromq::InterProcessPortalMainThread::set_publish_cfg(
+    const protobuf::Socket& cfg,
+    const google::protobuf::RepeatedPtrField<protobuf::Socket>& shard_cfgs)
 {
     setup_socket(publish_socket_, cfg);
+    for (const auto& shard_cfg : shard_cfgs)
+    {
+        shard_publish_sockets_.push_back(std::make_unique<zmq::socket_t>(context_, ZMQ_PUB));
+        setup_socket(*shard_publish_sockets_.back(), shard_cfg);
+    }
     have_pubsub_sockets_ = true;
 }
 
@@ -155,11 +195,19 @@ void goby::zeromq::InterProcessPortalMainThread::publish(const std::string& iden
 {
     if (publish_ready() || ignore_buffer)
     {
+        if (shared_memory_ && shared_memory_->use_for(size) &&
+            publish_shared_memory(identifier, bytes, size))
+            return;
+
+        // not the ManagerRequest (ignore_buffer), as the Manager expects a single publication
+        if (batching_ && !ignore_buffer && publish_batched(identifier, bytes, size))
+            return;
+
         zmq::message_t msg(identifier.size() + size);
         memcpy(msg.data(), identifier.data(), identifier.size());
         memcpy(static_cast<char*>(msg.data()) + identifier.size(), bytes, size);
 
-        publish_socket_.send(msg, zmq_send_flags_none);
+        publish_socket(identifier).send(msg, zmq_send_flags_none);
 
         glog.is(DEBUG3) && glog << "Published " << size << " bytes to ["
                                 << identifier.substr(0, identifier.size() - 1) << "]" << std::endl;
@@ -173,6 +221,135 @@ void goby::zeromq::InterProcessPortalMainThread::publish(const std::string& iden
     }
 }
 
+bool goby::zeromq::InterProcessPortalMainThread::publish_shared_memory(
+    const std::string& identifier, const char* bytes, int size)
+{
+    protobuf::SharedMemoryDescriptor descriptor;
+    if (!shared_memory_->write(identifier, bytes, size, &descriptor))
+        return false;
+
+    // send after the publications already batched for this identifier
+    auto batch_it = publish_batches_.find(identifier);
+    if (batch_it != publish_batches_.end() && !batch_it->second.frame.empty())
+        flush(batch_it->second.deadline);
+
+    // the identifier alone for the subscription filters, then the location of identifier + data
+    auto& socket = publish_socket(identifier);
+    zmq::message_t identifier_msg(identifier.data(), identifier.size());
+    socket.send(identifier_msg, zmq_send_flags_sndmore);
+
+    zmq::message_t descriptor_msg(descriptor.ByteSizeLong());
+    descriptor.SerializeToArray(descriptor_msg.data(), descriptor_msg.size());
+    socket.send(descriptor_msg, zmq_send_flags_none);
+
+    glog.is(DEBUG3) && glog << "Published " << size << " bytes to ["
+                            << identifier.substr(0, identifier.size() - 1)
+                            << "] using shared memory: " << descriptor.ShortDebugString()
+                            << std::endl;
+    return true;
+}
+
+bool goby::zeromq::InterProcessPortalMainThread::publish_batched(const std::string& identifier,
+                                                                 const char* bytes, int size)
+{
+    const int size_bytes = 4;
+    auto now = std::chrono::steady_clock::now();
+    auto& batch = publish_batches_[identifier];
+
+    // too large: send on its own, after the publications already batched for this identifier
+    if (identifier.empty() || identifier.back() != '\0' ||
+        identifier.size() + size_bytes + size > batching_->max_bytes())
+    {
+        if (!batch.frame.empty())
+            flush(batch.deadline);
+        return false;
+    }
+
+    if (batch.frame.size() + size_bytes + size > batching_->max_bytes())
+        flush(batch.deadline);
+
+    if (batch.frame.empty())
+    {
+        batch.frame.append(identifier.data(), identifier.size() - 1);
+        batch.frame.push_back(batch_identifier_delimiter);
+        batch.deadline = now + std::chrono::microseconds(batching_->max_latency_us());
+        if (!batch_pending_ || batch.deadline < next_batch_deadline_)
+            next_batch_deadline_ = batch.deadline;
+        if (!batch_pending_)
+        {
+            batch_pending_ = true;
+            // the read thread may be blocked without a timeout
+            protobuf::InprocControl control;
+            control.set_type(protobuf::InprocControl::NOTIFY_BATCH_PENDING);
+            send_control_msg(control);
+        }
+    }
+
+    // little-endian size, then the data
+    auto record_size = static_cast<std::uint32_t>(size);
+    for (int i = 0; i < size_bytes; ++i)
+        batch.frame.push_back(static_cast<char>((record_size >> (8 * i)) & 0xFF));
+    batch.frame.append(bytes, size);
+
+    glog.is(DEBUG3) && glog << "Batched " << size << " bytes to ["
+                            << identifier.substr(0, identifier.size() - 1) << "]" << std::endl;
+
+    flush_expired();
+    return true;
+}
+
+void goby::zeromq::InterProcessPortalMainThread::flush()
+{
+    flush(std::chrono::steady_clock::time_point::max());
+}
+
+void goby::zeromq::InterProcessPortalMainThread::flush(std::chrono::steady_clock::time_point latest)
+{
+    if (!batch_pending_)
+        return;
+
+    bool pending = false;
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (auto& identifier_batch : publish_batches_)
+    {
+        PublishBatch& batch = identifier_batch.second;
+        if (batch.frame.empty())
+            continue;
+
+        if (batch.deadline <= latest)
+        {
+            zmq::message_t msg(batch.frame.data(), batch.frame.size());
+            publish_socket(identifier_batch.first).send(msg, zmq_send_flags_none);
+
+            glog.is(DEBUG3) && glog << "Published batch of " << batch.frame.size()
+                                    << " bytes to ["
+                                    << identifier_batch.first.substr(
+                                           0, identifier_batch.first.size() - 1)
+                                    << "]" << std::endl;
+            batch.frame.clear();
+        }
+        else
+        {
+            pending = true;
+            next_deadline = std::min(next_deadline, batch.deadline);
+        }
+    }
+    next_batch_deadline_ = next_deadline;
+    batch_pending_ = pending;
+}
+
+void goby::zeromq::InterProcessPortalMainThread::enable_batching(
+    const protobuf::PublishBatchingConfig& cfg)
+{
+    batching_ = std::make_unique<protobuf::PublishBatchingConfig>(cfg);
+}
+
+void goby::zeromq::InterProcessPortalMainThread::enable_shared_memory(
+    const protobuf::SharedMemoryConfig& cfg, const std::string& name)
+{
+    shared_memory_.reset(new SharedMemoryWriter(cfg, name));
+}
+
 void goby::zeromq::InterProcessPortalMainThread::subscribe(const std::string& identifier)
 {
     protobuf::InprocControl control;
@@ -229,13 +406,18 @@ void goby::zeromq::InterProcessPortalMainThread::send_control_msg(
 //
 goby::zeromq::InterProcessPortalReadThread::InterProcessPortalReadThread(
     const protobuf::InterProcessPortalConfig& cfg, zmq::context_t& context,
-    std::atomic<bool>& alive, std::shared_ptr<std::condition_variable_any> poller_cv)
+    std::atomic<bool>& alive, std::shared_ptr<std::condition_variable_any> poller_cv,
+    std::shared_ptr<std::timed_mutex> poller_mutex, InterProcessReceiveQueue& received_data,
+    const std::atomic<bool>& batch_pending)
     : cfg_(cfg),
       control_socket_(context, ZMQ_PAIR),
       subscribe_socket_(context, ZMQ_SUB),
       manager_socket_(context, ZMQ_REQ),
       alive_(alive),
-      poller_cv_(std::move(poller_cv))
+      poller_cv_(std::move(poller_cv)),
+      poller_mutex_(std::move(poller_mutex)),
+      received_data_(received_data),
+      batch_pending_(batch_pending)
 {
     poll_items_.resize(NUMBER_SOCKETS);
     poll_items_[SOCKET_CONTROL] = {(void*)control_socket_, 0, ZMQ_POLLIN, 0};
@@ -264,15 +446,40 @@ goby::zeromq::InterProcessPortalReadThread::InterProcessPortalReadThread(
     }
     query_socket.set_connect_or_bind(protobuf::Socket::CONNECT);
     setup_socket(manager_socket_, query_socket);
+
+    // offered to the Manager in case it enables peer to peer mode
+    if (cfg_.transport() == protobuf::InterProcessPortalConfig::IPC)
+    {
+        static std::atomic<int> peer_socket_index(0);
+        peer_publish_socket_.set_socket_type(protobuf::Socket::PUBLISH);
+        peer_publish_socket_.set_transport(protobuf::Socket::IPC);
+        peer_publish_socket_.set_connect_or_bind(protobuf::Socket::BIND);
+        peer_publish_socket_.set_socket_name(
+            (cfg_.has_socket_name() ? cfg_.socket_name() : "/tmp/goby_" + cfg_.platform()) +
+            ".peer." + std::to_string(getpid()) + "." + std::to_string(peer_socket_index++));
+        peer_publish_socket_.set_send_queue_size(cfg_.send_queue_size());
+        peer_publish_socket_.set_receive_queue_size(cfg_.receive_queue_size());
+    }
 }
 
 void goby::zeromq::InterProcessPortalReadThread::run()
 {
     while (alive_)
     {
+        long timeout_ms = peer_to_peer_ ? request_peers() : -1;
+
+        // wake up to have the main thread send batches that have reached max_latency_us
+        // (the main thread sends NOTIFY_BATCH_PENDING when the first publication is batched)
+        if (cfg_.has_publish_batching() && batch_pending_)
+        {
+            long batch_timeout_ms = std::max(1u, cfg_.publish_batching().max_latency_us() / 1000);
+            timeout_ms = timeout_ms < 0 ? batch_timeout_ms : std::min(timeout_ms, batch_timeout_ms);
+        }
+
         if (have_pubsub_sockets_ && !hold_)
         {
-            poll();
+            poll(timeout_ms);
+            notify_batch_pending();
         }
         else
         {
@@ -282,6 +489,8 @@ void goby::zeromq::InterProcessPortalReadThread::run()
                 req.set_request(protobuf::PROVIDE_PUB_SUB_SOCKETS);
                 req.set_client_name(cfg_.client_name());
                 req.set_client_pid(getpid());
+                if (peer_publish_socket_.IsInitialized())
+                    *req.mutable_peer_publish_socket() = peer_publish_socket_;
 
                 send_manager_request(req);
 
@@ -323,8 +532,68 @@ void goby::zeromq::InterProcessPortalReadThread::send_manager_request(
     manager_waiting_for_reply_ = true;
 }
 
+long goby::zeromq::InterProcessPortalReadThread::request_peers()
+{
+    // poll the Manager for new (and exited) peers
+    auto now = goby::time::SystemClock::now();
+    if (now >= next_peer_request_time_)
+    {
+        if (!manager_waiting_for_reply_)
+        {
+            protobuf::ManagerRequest req;
+            req.set_request(protobuf::PROVIDE_PEERS);
+            req.set_client_name(cfg_.client_name());
+            req.set_client_pid(getpid());
+            send_manager_request(req);
+        }
+        next_peer_request_time_ = now + peer_request_period_;
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(next_peer_request_time_ - now)
+               .count() +
+           1;
+}
+
+void goby::zeromq::InterProcessPortalReadThread::update_peers(
+    const protobuf::ManagerResponse& response)
+{
+    std::set<std::string> endpoints;
+    for (auto peer : response.peer())
+    {
+        peer.set_connect_or_bind(protobuf::Socket::CONNECT);
+        endpoints.insert(zmq_socket_endpoint(peer));
+    }
+
+    for (const auto& endpoint : endpoints)
+    {
+        if (!peer_endpoints_.count(endpoint))
+        {
+            glog.is(DEBUG2) && glog << "Connecting to peer: " << endpoint << std::endl;
+            subscribe_socket_.connect(endpoint.c_str());
+        }
+    }
+
+    for (const auto& endpoint : peer_endpoints_)
+    {
+        if (!endpoints.count(endpoint))
+        {
+            glog.is(DEBUG2) && glog << "Disconnecting from peer: " << endpoint << std::endl;
+            subscribe_socket_.disconnect(endpoint.c_str());
+        }
+    }
+
+    peer_endpoints_.swap(endpoints);
+}
+
 void goby::zeromq::InterProcessPortalReadThread::poll(long timeout_ms)
 {
+    flush_received_backlog();
+
+    // retry the backlog periodically as the main thread drains received_data_
+    const long backlog_retry_ms = 1;
+    if (!received_backlog_.empty() && (timeout_ms < 0 || timeout_ms > backlog_retry_ms))
+        timeout_ms = backlog_retry_ms;
+
     zmq::poll(&poll_items_[0], poll_items_.size(), timeout_ms);
 
     for (int i = 0, n = poll_items_.size(); i < n; ++i)
@@ -349,6 +618,8 @@ void goby::zeromq::InterProcessPortalReadThread::poll(long timeout_ms)
             }
         }
     }
+
+    notify_received_data();
 }
 
 void goby::zeromq::InterProcessPortalReadThread::control_data(const zmq::message_t& zmq_msg)
@@ -400,18 +671,110 @@ void goby::zeromq::InterProcessPortalReadThread::control_data(const zmq::message
             hold_ = control_msg.hold();
             break;
         }
+        case protobuf::InprocControl::NOTIFY_BATCH_PENDING:
+            // nothing to do: run() shortens the poll timeout while batch_pending_ is true
+            break;
 
         default: break;
     }
 }
-void goby::zeromq::InterProcessPortalReadThread::subscribe_data(const zmq::message_t& zmq_msg)
+void goby::zeromq::InterProcessPortalReadThread::subscribe_data(zmq::message_t& zmq_msg)
 {
-    // data from goby - forward to the main thread
-    protobuf::InprocControl control;
-    control.set_type(protobuf::InprocControl::RECEIVE);
-    control.set_received_data(std::string((char*)zmq_msg.data(), zmq_msg.size()));
-    send_control_msg(control);
+    // publications in shared memory are sent as the identifier followed by a SharedMemoryDescriptor
+    if (zmq_msg.more() && !shared_memory_data(zmq_msg))
+        return;
+
+    // data from goby - hand the message itself (no copy) to the main thread
+    if (received_backlog_.empty() && received_data_.push(std::move(zmq_msg)))
+    {
+        received_data_pushed_ = true;
+    }
+    else
+    {
+        if (received_backlog_.empty())
+        {
+            received_data_.increment_overflow();
+            glog.is(DEBUG3) && glog << "Main thread receive queue full ("
+                                    << received_data_.capacity() << " messages), buffering"
+                                    << std::endl;
+        }
+        received_backlog_.push_back(std::move(zmq_msg));
+    }
+}
+
+bool goby::zeromq::InterProcessPortalReadThread::shared_memory_data(zmq::message_t& zmq_msg)
+{
+    zmq::message_t descriptor_msg;
+    if (!zmq_socket_recv(subscribe_socket_, descriptor_msg))
+        return false;
+
+    // discard any further (unexpected) parts
+    bool valid = !descriptor_msg.more();
+    for (bool more = descriptor_msg.more(); more;)
+    {
+        zmq::message_t discard;
+        more = zmq_socket_recv(subscribe_socket_, discard) && discard.more();
+    }
+
+    protobuf::SharedMemoryDescriptor descriptor;
+    if (!valid || !descriptor.ParseFromArray(descriptor_msg.data(), descriptor_msg.size()))
+    {
+        glog.is_warn() && glog << "Received invalid shared memory descriptor" << std::endl;
+        return false;
+    }
+
+    auto view = shared_memory_.acquire(descriptor);
+    if (!view)
+        return false;
+
+    // replace the identifier with a message referencing the identifier and data in shared memory (no copy), which releases the slot when the main thread is done with it
+    auto* view_ptr = view.release();
+    zmq_msg = zmq::message_t(
+        const_cast<char*>(view_ptr->data()), view_ptr->size(),
+        [](void* /*data*/, void* hint) { delete static_cast<SharedMemoryReader::View*>(hint); },
+        view_ptr);
+    return true;
+}
+
+void goby::zeromq::InterProcessPortalReadThread::flush_received_backlog()
+{
+    while (!received_backlog_.empty() && received_data_.push(std::move(received_backlog_.front())))
+    {
+        received_backlog_.pop_front();
+        received_data_pushed_ = true;
+    }
+    notify_received_data();
 }
+
+void goby::zeromq::InterProcessPortalReadThread::notify_received_data()
+{
+    if (!received_data_pushed_)
+        return;
+    received_data_pushed_ = false;
+
+    // the main thread holds the poller mutex from checking received_data_ until it waits on the condition variable, so acquiring it here ensures the notification cannot be lost
+    {
+        std::lock_guard<std::timed_mutex> lock(*poller_mutex_);
+    }
+    poller_cv_->notify_all();
+}
+void goby::zeromq::InterProcessPortalReadThread::notify_batch_pending()
+{
+    if (!batch_pending_)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_batch_notify_time_)
+        return;
+    next_batch_notify_time_ =
+        now + std::chrono::microseconds(cfg_.publish_batching().max_latency_us());
+
+    {
+        std::lock_guard<std::timed_mutex> lock(*poller_mutex_);
+    }
+    poller_cv_->notify_all();
+}
+
 void goby::zeromq::InterProcessPortalReadThread::manager_data(const zmq::message_t& zmq_msg)
 {
     // manager (gobyd) reply
@@ -426,17 +789,41 @@ void goby::zeromq::InterProcessPortalReadThread::manager_data(const zmq::message
             response.mutable_subscribe_socket()->set_ethernet_address(cfg_.ipv4_address());
         if (response.publish_socket().transport() == protobuf::Socket::TCP)
             response.mutable_publish_socket()->set_ethernet_address(cfg_.ipv4_address());
+        for (auto& shard_socket : *response.mutable_publish_shard_socket())
+        {
+            if (shard_socket.transport() == protobuf::Socket::TCP)
+                shard_socket.set_ethernet_address(cfg_.ipv4_address());
+        }
 
         setup_socket(subscribe_socket_, response.subscribe_socket());
+        // publishers choose a Router shard by group, so we need all of them
+        for (auto shard_socket : response.subscribe_shard_socket())
+        {
+            if (shard_socket.transport() == protobuf::Socket::TCP)
+                shard_socket.set_ethernet_address(cfg_.ipv4_address());
+            subscribe_socket_.connect(zmq_socket_endpoint(shard_socket).c_str());
+        }
+
+        // in peer to peer mode, we still subscribe to the Router for the Manager's publications
+        peer_to_peer_ = response.peer_to_peer() && peer_publish_socket_.IsInitialized();
+        if (peer_to_peer_)
+            update_peers(response);
 
         protobuf::InprocControl control;
         control.set_type(protobuf::InprocControl::PUB_CONFIGURATION);
         control.set_hold(response.hold());
-        *control.mutable_publish_socket() = response.publish_socket();
+        *control.mutable_publish_socket() =
+            peer_to_peer_ ? peer_publish_socket_ : response.publish_socket();
+        if (!peer_to_peer_)
+            *control.mutable_publish_shard_socket() = response.publish_shard_socket();
         send_control_msg(control);
 
         have_pubsub_sockets_ = true;
     }
+    else if (response.request() == protobuf::PROVIDE_PEERS && peer_to_peer_)
+    {
+        update_peers(response);
+    }
 
     manager_waiting_for_reply_ = false;
 }
@@ -468,7 +855,26 @@ unsigned goby::zeromq::Router::last_port(zmq::socket_t& socket)
     return port;
 }
 
+goby::zeromq::Router::Router(zmq::context_t& context,
+                             const protobuf::InterProcessPortalConfig& cfg)
+    : context_(context), cfg_(cfg)
+{
+    for (unsigned i = 0, n = std::max(1u, cfg_.router_shards()); i < n; ++i)
+        shards_.push_back(std::make_unique<Shard>());
+}
+
 void goby::zeromq::Router::run()
+{
+    std::vector<std::thread> shard_threads;
+    for (unsigned i = 1, n = shards(); i < n; ++i)
+        shard_threads.emplace_back([this, i]() { run_shard(i); });
+
+    run_shard(0);
+
+    for (auto& shard_thread : shard_threads) shard_thread.join();
+}
+
+void goby::zeromq::Router::run_shard(unsigned index)
 {
     zmq::socket_t frontend(context_, ZMQ_XPUB);
     zmq::socket_t backend(context_, ZMQ_XSUB);
@@ -480,18 +886,17 @@ void goby::zeromq::Router::run()
     frontend.setsockopt(ZMQ_RCVHWM, &receive_hwm, sizeof(receive_hwm));
     backend.setsockopt(ZMQ_RCVHWM, &receive_hwm, sizeof(receive_hwm));
 
+    // report full subscriber queues as EAGAIN (instead of silently dropping) so we can count them
+    int nodrop = 1;
+    frontend.setsockopt(ZMQ_XPUB_NODROP, &nodrop, sizeof(nodrop));
+
+    Shard& shard = *shards_[index];
     switch (cfg_.transport())
     {
         case protobuf::InterProcessPortalConfig::IPC:
         {
-            std::string xpub_sock_name =
-                "ipc://" +
-                (cfg_.has_socket_name() ? cfg_.socket_name() : "/tmp/goby_" + cfg_.platform()) +
-                ".xpub";
-            std::string xsub_sock_name =
-                "ipc://" +
-                (cfg_.has_socket_name() ? cfg_.socket_name() : "/tmp/goby_" + cfg_.platform()) +
-                ".xsub";
+            std::string xpub_sock_name = "ipc://" + router_socket_name(cfg_, "xpub", index);
+            std::string xsub_sock_name = "ipc://" + router_socket_name(cfg_, "xsub", index);
             frontend.bind(xpub_sock_name.c_str());
             backend.bind(xsub_sock_name.c_str());
             break;
@@ -500,18 +905,42 @@ void goby::zeromq::Router::run()
         {
             frontend.bind("tcp://*:0");
             backend.bind("tcp://*:0");
-            pub_port = last_port(frontend);
-            sub_port = last_port(backend);
+            shard.pub_port = last_port(frontend);
+            shard.sub_port = last_port(backend);
+            if (index == 0)
+            {
+                pub_port = shard.pub_port.load();
+                sub_port = shard.sub_port.load();
+            }
             break;
         }
     }
+
+    // equivalent to zmq::proxy(frontend, backend), with statistics
     try
     {
-#ifdef USE_OLD_ZMQ_CPP_API
-        zmq::proxy((void*)frontend, (void*)backend, nullptr);
-#else
-        zmq::proxy(frontend, backend);
-#endif
+        zmq::pollitem_t items[] = {{(void*)frontend, 0, ZMQ_POLLIN, 0},
+                                   {(void*)backend, 0, ZMQ_POLLIN, 0}};
+        while (true)
+        {
+            zmq::poll(items, 2, -1);
+
+            // (un)subscriptions
+            if (items[0].revents & ZMQ_POLLIN)
+            {
+                bool more = true;
+                while (more)
+                {
+                    zmq::message_t part;
+                    zmq_socket_recv(frontend, part);
+                    more = part.more();
+                    backend.send(part, more ? zmq_send_flags_sndmore : zmq_send_flags_none);
+                }
+            }
+
+            if (items[1].revents & ZMQ_POLLIN)
+                forward_publications(shard, backend, frontend);
+        }
     }
     catch (const zmq::error_t& e)
     {
@@ -523,6 +952,90 @@ void goby::zeromq::Router::run()
     }
 }
 
+void goby::zeromq::Router::forward_publications(Shard& shard, zmq::socket_t& backend,
+                                                zmq::socket_t& frontend)
+{
+    // forward up to this many messages per poll, so that subscriptions are not delayed
+    const int max_burst = 1000;
+
+    std::uint64_t messages = 0, bytes = 0, hwm_drops = 0;
+    for (int i = 0; i < max_burst; ++i)
+    {
+        zmq::message_t part;
+        if (!zmq_socket_recv(backend, part, zmq_recv_flags_dontwait))
+            break;
+        ++messages;
+
+        bool first = true;
+        while (true)
+        {
+            bytes += part.size();
+            bool more = part.more();
+            auto flags = more ? zmq_send_flags_sndmore : zmq_send_flags_none;
+
+            // the high water mark is only checked on the first part of a message
+            if (first && !zmq_socket_send(frontend, part, flags | zmq_send_flags_dontwait))
+            {
+                // one or more subscribers are full: send to the others (normal PUB behavior)
+                ++hwm_drops;
+                int nodrop = 0;
+                frontend.setsockopt(ZMQ_XPUB_NODROP, &nodrop, sizeof(nodrop));
+                frontend.send(part, flags);
+                nodrop = 1;
+                frontend.setsockopt(ZMQ_XPUB_NODROP, &nodrop, sizeof(nodrop));
+            }
+            else if (!first)
+            {
+                frontend.send(part, flags);
+            }
+
+            if (!more)
+                break;
+
+            first = false;
+            part = zmq::message_t();
+            zmq_socket_recv(backend, part);
+        }
+    }
+
+    shard.messages.fetch_add(messages, std::memory_order_relaxed);
+    shard.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    shard.hwm_drops.fetch_add(hwm_drops, std::memory_order_relaxed);
+}
+
+goby::zeromq::protobuf::RouterStatus goby::zeromq::Router::status()
+{
+    std::lock_guard<std::mutex> lock(status_mutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last_status_time_).count();
+
+    protobuf::RouterStatus status;
+    for (unsigned i = 0, n = shards(); i < n; ++i)
+    {
+        const Shard& shard = *shards_[i];
+        auto& shard_status = *status.add_shard();
+        shard_status.set_index(i);
+        shard_status.set_messages(shard.messages.load(std::memory_order_relaxed));
+        shard_status.set_bytes(shard.bytes.load(std::memory_order_relaxed));
+        shard_status.set_hwm_drops(shard.hwm_drops.load(std::memory_order_relaxed));
+
+        if (i < static_cast<unsigned>(last_status_.shard_size()) && seconds > 0)
+        {
+            const auto& last = last_status_.shard(i);
+            shard_status.set_messages_per_second((shard_status.messages() - last.messages()) /
+                                                 seconds);
+            shard_status.set_bytes_per_second((shard_status.bytes() - last.bytes()) / seconds);
+            shard_status.set_hwm_drops_per_second(
+                (shard_status.hwm_drops() - last.hwm_drops()) / seconds);
+        }
+    }
+
+    last_status_ = status;
+    last_status_time_ = now;
+    return status;
+}
+
 //
 // Manager
 //
@@ -536,14 +1049,21 @@ goby::zeromq::Manager::Manager(zmq::context_t& context,
       subscribe_socket_(std::make_unique<zmq::socket_t>(context_, ZMQ_SUB)),
       publish_socket_(std::make_unique<zmq::socket_t>(context_, ZMQ_PUB))
 {
-    setup_socket(*subscribe_socket_, subscribe_socket_cfg());
-    setup_socket(*publish_socket_, publish_socket_cfg());
+    // only the Router shards that carry the ManagerRequest and ManagerResponse groups
+    setup_socket(*subscribe_socket_,
+                 subscribe_socket_cfg(router_shard(zmq_filter_req_, router_.shards())));
+    setup_socket(*publish_socket_,
+                 publish_socket_cfg(router_shard(zmq_filter_rep_, router_.shards())));
     poll_items_.resize(NUMBER_SOCKETS);
     poll_items_[SOCKET_MANAGER] = {(void*)*manager_socket_, 0, ZMQ_POLLIN, 0};
     poll_items_[SOCKET_SUBSCRIBE] = {(void*)*subscribe_socket_, 0, ZMQ_POLLIN, 0};
 
     subscribe_socket_->setsockopt(ZMQ_SUBSCRIBE, zmq_filter_req_.c_str(), zmq_filter_req_.size());
 
+    if (cfg_.peer_to_peer() && cfg_.transport() != protobuf::InterProcessPortalConfig::IPC)
+        glog.is_warn() && glog << "peer_to_peer is only supported for transport == IPC, ignoring"
+                               << std::endl;
+
     switch (cfg_.transport())
     {
         case protobuf::InterProcessPortalConfig::IPC:
@@ -653,23 +1173,87 @@ goby::zeromq::Manager::handle_request(const protobuf::ManagerRequest& pb_request
     {
         *pb_response.mutable_subscribe_socket() = subscribe_socket_cfg();
         *pb_response.mutable_publish_socket() = publish_socket_cfg();
+        for (unsigned shard = 1, n = router_.shards(); shard < n; ++shard)
+        {
+            *pb_response.add_subscribe_shard_socket() = subscribe_socket_cfg(shard);
+            *pb_response.add_publish_shard_socket() = publish_socket_cfg(shard);
+        }
+        update_peers(pb_request, &pb_response);
     }
     else if (pb_request.request() == protobuf::PROVIDE_HOLD_STATE)
     {
         if (pb_request.ready() && required_clients_.count(pb_request.client_name()))
             reported_clients_.insert(pb_request.client_name());
 
-        pb_response.set_hold(hold_state());
+        // a new peer holds until the existing peers have connected to it (see peer_connecting())
+        pb_response.set_hold(hold_state() || peer_connecting(pb_request));
+    }
+    else if (pb_request.request() == protobuf::PROVIDE_PEERS)
+    {
+        update_peers(pb_request, &pb_response);
     }
 
     return pb_response;
 }
 
-goby::zeromq::protobuf::Socket goby::zeromq::Manager::publish_socket_cfg()
+void goby::zeromq::Manager::update_peers(const protobuf::ManagerRequest& pb_request,
+                                         protobuf::ManagerResponse* pb_response)
+{
+    if (!cfg_.peer_to_peer() || cfg_.transport() != protobuf::InterProcessPortalConfig::IPC)
+        return;
+
+    auto connect_endpoint = [](protobuf::Socket peer) {
+        peer.set_connect_or_bind(protobuf::Socket::CONNECT);
+        return zmq_socket_endpoint(peer);
+    };
+
+    if (pb_request.has_peer_publish_socket())
+    {
+        auto client = std::make_pair(pb_request.client_name(), pb_request.client_pid());
+        auto it = peers_.find(client);
+        if (it != peers_.end())
+            subscribe_socket_->disconnect(connect_endpoint(it->second.publish_socket).c_str());
+
+        // we subscribe to the clients' ManagerRequest publications directly as well
+        subscribe_socket_->connect(connect_endpoint(pb_request.peer_publish_socket()).c_str());
+        peers_[client] = {pb_request.peer_publish_socket(), std::chrono::steady_clock::now()};
+    }
+
+    // remove clients that have exited (IPC clients are all on this machine)
+    for (auto it = peers_.begin(); it != peers_.end();)
+    {
+        if (kill(it->first.second, 0) == -1 && errno == ESRCH)
+        {
+            glog.is(DEBUG2) && glog << "(Manager) Removing exited peer: " << it->first.first
+                                    << " (pid " << it->first.second << ")" << std::endl;
+            subscribe_socket_->disconnect(connect_endpoint(it->second.publish_socket).c_str());
+            it = peers_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    pb_response->set_peer_to_peer(true);
+    for (const auto& peer : peers_) *pb_response->add_peer() = peer.second.publish_socket;
+}
+
+bool goby::zeromq::Manager::peer_connecting(const protobuf::ManagerRequest& pb_request)
+{
+    // the existing peers only learn about a new peer from their next PROVIDE_PEERS request, so
+    // anything it published before then would be lost
+    auto it = peers_.find(std::make_pair(pb_request.client_name(), pb_request.client_pid()));
+    return it != peers_.end() &&
+           std::chrono::steady_clock::now() < it->second.registered + 2 * peer_request_period;
+}
+
+goby::zeromq::protobuf::Socket goby::zeromq::Manager::publish_socket_cfg(unsigned shard)
 {
     protobuf::Socket publish_socket;
 
-    while (cfg_.transport() == protobuf::InterProcessPortalConfig::TCP && (router_.sub_port == 0))
+    while (cfg_.transport() == protobuf::InterProcessPortalConfig::TCP &&
+           (router_.shard_sub_port(shard) == 0))
         usleep(1e4);
 
     publish_socket.set_socket_type(protobuf::Socket::PUBLISH);
@@ -682,21 +1266,20 @@ goby::zeromq::protobuf::Socket goby::zeromq::Manager::publish_socket_cfg()
     {
         case protobuf::InterProcessPortalConfig::IPC:
             publish_socket.set_transport(protobuf::Socket::IPC);
-            publish_socket.set_socket_name(
-                (cfg_.has_socket_name() ? cfg_.socket_name() : "/tmp/goby_" + cfg_.platform()) +
-                ".xsub");
+            publish_socket.set_socket_name(router_socket_name(cfg_, "xsub", shard));
             break;
         case protobuf::InterProcessPortalConfig::TCP:
             publish_socket.set_transport(protobuf::Socket::TCP);
-            publish_socket.set_ethernet_port(router_.sub_port);
+            publish_socket.set_ethernet_port(router_.shard_sub_port(shard));
             break;
     }
     return publish_socket;
 }
 
-goby::zeromq::protobuf::Socket goby::zeromq::Manager::subscribe_socket_cfg()
+goby::zeromq::protobuf::Socket goby::zeromq::Manager::subscribe_socket_cfg(unsigned shard)
 {
-    while (cfg_.transport() == protobuf::InterProcessPortalConfig::TCP && (router_.pub_port == 0))
+    while (cfg_.transport() == protobuf::InterProcessPortalConfig::TCP &&
+           (router_.shard_pub_port(shard) == 0))
         usleep(1e4);
 
     protobuf::Socket subscribe_socket;
@@ -710,13 +1293,12 @@ goby::zeromq::protobuf::Socket goby::zeromq::Manager::subscribe_socket_cfg()
     {
         case protobuf::InterProcessPortalConfig::IPC:
             subscribe_socket.set_transport(protobuf::Socket::IPC);
-            subscribe_socket.set_socket_name(
-                (cfg_.has_socket_name() ? cfg_.socket_name() : "/tmp/goby_" + cfg_.platform()) +
-                ".xpub");
+            subscribe_socket.set_socket_name(router_socket_name(cfg_, "xpub", shard));
             break;
         case protobuf::InterProcessPortalConfig::TCP:
             subscribe_socket.set_transport(protobuf::Socket::TCP);
-            subscribe_socket.set_ethernet_port(router_.pub_port); // our publish is their subscribe
+            // our publish is their subscribe
+            subscribe_socket.set_ethernet_port(router_.shard_pub_port(shard));
             break;
     }
 
@@ -26,18 +26,23 @@
 
 #include "goby/middleware/marshalling/protobuf.h"
 
+#include <algorithm>          // for find
 #include <atomic>             // for atomic
 #include <chrono>             // for mill...
 #include <condition_variable> // for cond...
+#include <cstdint>            // for uint32_t
 #include <deque>              // for deque
 #include <functional>         // for func...
 #include <iosfwd>             // for size_t
+#include <map>                // for map
 #include <memory>             // for shar...
 #include <mutex>              // for time...
 #include <set>                // for set
 #include <string>             // for string
 #include <thread>             // for get_id
 #include <tuple>              // for make...
+#include <type_traits>        // for true...
+#include <typeindex>          // for type...
 #include <unistd.h>           // for getpid
 #include <unordered_map>      // for unor...
 #include <utility>            // for make...
@@ -52,6 +57,7 @@
 #include "goby/middleware/protobuf/serializer_transporter.pb.h" // for Seri...
 #include "goby/middleware/protobuf/transporter_config.pb.h"     // for Tran...
 #include "goby/middleware/transport/interface.h"                // for Poll...
+#include "goby/middleware/transport/detail/bounded_mpsc_queue.h" // for Boun...
 #include "goby/middleware/transport/interprocess.h"             // for Inte...
 #include "goby/middleware/transport/null.h"                     // for Null...
 #include "goby/middleware/transport/serialization_handlers.h"   // for Seri...
@@ -61,6 +67,7 @@
 #include "goby/util/debug_logger/flex_ostreambuf.h"             // for lock
 #include "goby/zeromq/protobuf/interprocess_config.pb.h"        // for Inte...
 #include "goby/zeromq/protobuf/interprocess_zeromq.pb.h"        // for Inpr...
+#include "goby/zeromq/transport/shared_memory.h"                // for Shar...
 
 #if ZMQ_VERSION <= ZMQ_MAKE_VERSION(4, 3, 1)
 #define USE_OLD_ZMQ_CPP_API
@@ -79,10 +86,33 @@ namespace groups
 {
 constexpr goby::middleware::Group manager_request{"goby::zeromq::_internal_manager_request"};
 constexpr goby::middleware::Group manager_response{"goby::zeromq::_internal_manager_response"};
+constexpr goby::middleware::Group router_status{"goby::zeromq::router_status"};
 } // namespace groups
 
 void setup_socket(zmq::socket_t& socket, const protobuf::Socket& cfg);
 
+/// \brief How often clients in peer to peer mode ask the Manager for the current list of peers
+constexpr std::chrono::milliseconds peer_request_period{500};
+
+/// \brief Router shard (0 to shards-1) that carries the publications for a given identifier, chosen by hashing (FNV-1a) the group (the first component of the identifier)
+inline unsigned router_shard(const std::string& identifier, unsigned shards)
+{
+    if (shards <= 1)
+        return 0;
+
+    std::uint32_t hash = 2166136261u;
+    for (auto it = identifier.begin() + (identifier.empty() ? 0 : 1), end = identifier.end();
+         it != end && *it != '/'; ++it)
+    {
+        hash ^= static_cast<unsigned char>(*it);
+        hash *= 16777619u;
+    }
+    return hash % shards;
+}
+
+/// \brief Terminates the identifier of a batch of publications (instead of '\0' for a single publication), followed by the records: each a 4 byte (little-endian) size and then the data
+constexpr char batch_identifier_delimiter{'\x01'};
+
 enum class IdentifierWildcard
 {
     NO_WILDCARDS,
@@ -149,6 +179,110 @@ make_identifier(const std::string& type_name, int scheme, const std::string& gro
     }
 }
 
+/// \brief True if SerializerParserHelper<Data, scheme>::type_name() can be called without a Data instance (i.e. the type name is known at compile time)
+template <typename Data, int scheme, typename Enable = void>
+struct has_static_type_name : std::false_type
+{
+};
+
+template <typename Data, int scheme>
+struct has_static_type_name<
+    Data, scheme, decltype(void(middleware::SerializerParserHelper<Data, scheme>::type_name()))>
+    : std::true_type
+{
+};
+
+/// \brief Caches the fully qualified identifiers used for publishing so that they are only built once for each combination of data type, scheme, group and type name.
+///
+/// Lookup hashes the key components in place, so finding an existing identifier does not allocate. This cache is owned by a single InterProcessPortal (and thus used from a single thread), which is why the thread component of the identifier is not part of the key.
+class PublishIdentifierCache
+{
+  public:
+    /// \brief Find the identifier for the given key, or create it by calling make_identifier() and store it
+    ///
+    /// \param data_type C++ type of the published data (typeid(void) for already serialized data)
+    /// \param scheme Marshalling scheme
+    /// \param group Group published to
+    /// \param type_name Type name if it is not fixed by data_type, otherwise ""
+    /// \param make_identifier Function returning the identifier for this key (called only on a cache miss)
+    template <typename MakeIdentifier>
+    const std::string& find_or_create(std::type_index data_type, int scheme,
+                                      const middleware::Group& group, const char* type_name,
+                                      MakeIdentifier make_identifier)
+    {
+        return find_or_create(data_type, scheme, group.c_str(), group.numeric(), type_name,
+                              make_identifier);
+    }
+
+    /// \brief Find the identifier for the given key (with the group given as a string), or create it by calling make_identifier() and store it
+    template <typename MakeIdentifier>
+    const std::string& find_or_create(std::type_index data_type, int scheme,
+                                      const std::string& group, const char* type_name,
+                                      MakeIdentifier make_identifier)
+    {
+        return find_or_create(data_type, scheme, group.c_str(),
+                              middleware::Group::invalid_numeric_group, type_name,
+                              make_identifier);
+    }
+
+  private:
+    template <typename MakeIdentifier>
+    const std::string& find_or_create(std::type_index data_type, int scheme,
+                                      const char* group_c_str, std::uint32_t group_numeric,
+                                      const char* type_name, MakeIdentifier make_identifier)
+    {
+        bool group_has_c_str = (group_c_str != nullptr);
+        if (!group_has_c_str)
+            group_c_str = "";
+
+        std::size_t hash = std::hash<std::type_index>()(data_type);
+        hash_combine(hash, static_cast<std::size_t>(scheme));
+        hash_combine(hash, hash_c_str(group_c_str));
+        hash_combine(hash, static_cast<std::size_t>(group_numeric));
+        hash_combine(hash, hash_c_str(type_name));
+
+        auto range = identifiers_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const Entry& entry = it->second;
+            if (entry.data_type == data_type && entry.scheme == scheme &&
+                entry.group_numeric == group_numeric && entry.group_has_c_str == group_has_c_str &&
+                entry.group == group_c_str && entry.type_name == type_name)
+                return entry.identifier;
+        }
+
+        auto it = identifiers_.insert(
+            std::make_pair(hash, Entry{data_type, scheme, group_c_str, group_numeric,
+                                       group_has_c_str, type_name, make_identifier()}));
+        return it->second.identifier;
+    }
+
+    static void hash_combine(std::size_t& seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    // FNV-1a
+    static std::size_t hash_c_str(const char* c)
+    {
+        std::size_t hash = 14695981039346656037ull;
+        for (; *c != '\0'; ++c) hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+        return hash;
+    }
+
+    struct Entry
+    {
+        std::type_index data_type;
+        int scheme;
+        std::string group;
+        std::uint32_t group_numeric;
+        bool group_has_c_str;
+        std::string type_name;
+        std::string identifier;
+    };
+    std::unordered_multimap<std::size_t, Entry> identifiers_;
+};
+
 #ifdef USE_OLD_ZMQ_CPP_API
 using zmq_recv_flags_type = int;
 using zmq_send_flags_type = int;
@@ -157,6 +291,9 @@ using zmq_recv_flags_type = zmq::recv_flags;
 using zmq_send_flags_type = zmq::send_flags;
 #endif
 
+/// \brief Queue used to hand received publications (identifier + data) from the InterProcessPortalReadThread to the InterProcessPortal main thread without copying them
+using InterProcessReceiveQueue = middleware::detail::BoundedMPSCQueue<zmq::message_t>;
+
 // run in the same thread as InterProcessPortal
 class InterProcessPortalMainThread
 {
@@ -166,6 +303,7 @@ class InterProcessPortalMainThread
     {
         control_socket_.setsockopt(ZMQ_LINGER, 0);
         publish_socket_.setsockopt(ZMQ_LINGER, 0);
+        for (auto& socket : shard_publish_sockets_) socket->setsockopt(ZMQ_LINGER, 0);
     }
 
     bool publish_ready() { return !hold_; }
@@ -173,13 +311,35 @@ class InterProcessPortalMainThread
 
     bool recv(protobuf::InprocControl* control_msg,
               zmq_recv_flags_type flags = zmq_recv_flags_type());
-    void set_publish_cfg(const protobuf::Socket& cfg);
+    /// \brief Connect to the Router
+    ///
+    /// \param cfg Publish socket for shard 0 (or the peer publish socket)
+    /// \param shard_cfgs Publish sockets for shards 1 through N-1, if the Router is sharded
+    void set_publish_cfg(const protobuf::Socket& cfg,
+                         const google::protobuf::RepeatedPtrField<protobuf::Socket>& shard_cfgs);
 
     void set_hold_state(bool hold);
     bool hold_state() { return hold_; }
 
     void publish(const std::string& identifier, const char* bytes, int size,
                  bool ignore_buffer = false);
+
+    /// \brief Write publications larger than cfg.threshold() to the shared memory segment given by name
+    void enable_shared_memory(const protobuf::SharedMemoryConfig& cfg, const std::string& name);
+
+    /// \brief Pack publications to the same identifier into a single message (see protobuf::PublishBatchingConfig)
+    void enable_batching(const protobuf::PublishBatchingConfig& cfg);
+    /// \brief Send all the batched publications now
+    void flush();
+    /// \brief Send the batched publications that have been held for max_latency_us
+    void flush_expired()
+    {
+        if (batch_pending_ && std::chrono::steady_clock::now() >= next_batch_deadline_)
+            flush(std::chrono::steady_clock::now());
+    }
+    /// \brief True while there are batched publications waiting to be sent
+    const std::atomic<bool>& batch_pending() const { return batch_pending_; }
+
     void subscribe(const std::string& identifier);
     void unsubscribe(const std::string& identifier);
     void reader_shutdown();
@@ -188,9 +348,39 @@ class InterProcessPortalMainThread
     void send_control_msg(const protobuf::InprocControl& control);
 
   private:
+    bool publish_shared_memory(const std::string& identifier, const char* bytes, int size);
+    bool publish_batched(const std::string& identifier, const char* bytes, int size);
+    // send the batches with deadline <= latest
+    void flush(std::chrono::steady_clock::time_point latest);
+    zmq::socket_t& publish_socket(const std::string& identifier)
+    {
+        if (shard_publish_sockets_.empty())
+            return publish_socket_;
+        auto shard = router_shard(identifier, shard_publish_sockets_.size() + 1);
+        return shard == 0 ? publish_socket_ : *shard_publish_sockets_[shard - 1];
+    }
+
   private:
+    zmq::context_t& context_;
     zmq::socket_t control_socket_;
     zmq::socket_t publish_socket_;
+    // Router shards 1 through N-1 (publish_socket_ is shard 0)
+    std::vector<std::unique_ptr<zmq::socket_t>> shard_publish_sockets_;
+    std::unique_ptr<SharedMemoryWriter> shared_memory_;
+
+    struct PublishBatch
+    {
+        // identifier, batch_identifier_delimiter, records
+        std::string frame;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    std::unique_ptr<protobuf::PublishBatchingConfig> batching_;
+    // identifier (as passed to publish()) to the batch in progress
+    // entries are kept (empty) after sending to reuse their buffers
+    std::unordered_map<std::string, PublishBatch> publish_batches_;
+    std::atomic<bool> batch_pending_{false};
+    std::chrono::steady_clock::time_point next_batch_deadline_;
+
     bool hold_{true};
     bool have_pubsub_sockets_{false};
 
@@ -207,7 +397,10 @@ class InterProcessPortalReadThread
   public:
     InterProcessPortalReadThread(const protobuf::InterProcessPortalConfig& cfg,
                                  zmq::context_t& context, std::atomic<bool>& alive,
-                                 std::shared_ptr<std::condition_variable_any> poller_cv);
+                                 std::shared_ptr<std::condition_variable_any> poller_cv,
+                                 std::shared_ptr<std::timed_mutex> poller_mutex,
+                                 InterProcessReceiveQueue& received_data,
+                                 const std::atomic<bool>& batch_pending);
     void run();
     ~InterProcessPortalReadThread()
     {
@@ -219,10 +412,16 @@ class InterProcessPortalReadThread
   private:
     void poll(long timeout_ms = -1);
     void control_data(const zmq::message_t& zmq_msg);
-    void subscribe_data(const zmq::message_t& zmq_msg);
+    void subscribe_data(zmq::message_t& zmq_msg);
+    bool shared_memory_data(zmq::message_t& zmq_msg);
+    void flush_received_backlog();
+    void notify_received_data();
+    void notify_batch_pending();
     void manager_data(const zmq::message_t& zmq_msg);
     void send_control_msg(const protobuf::InprocControl& control);
     void send_manager_request(const protobuf::ManagerRequest& req);
+    long request_peers();
+    void update_peers(const protobuf::ManagerResponse& response);
 
   private:
     const protobuf::InterProcessPortalConfig& cfg_;
@@ -231,6 +430,16 @@ class InterProcessPortalReadThread
     zmq::socket_t manager_socket_;
     std::atomic<bool>& alive_;
     std::shared_ptr<std::condition_variable_any> poller_cv_;
+    std::shared_ptr<std::timed_mutex> poller_mutex_;
+    InterProcessReceiveQueue& received_data_;
+    // publications batched by the main thread are waiting to be sent
+    const std::atomic<bool>& batch_pending_;
+    std::chrono::steady_clock::time_point next_batch_notify_time_{
+        std::chrono::steady_clock::now()};
+    // holds (in order) received data when received_data_ is full, so that we keep servicing the control socket
+    std::deque<zmq::message_t> received_backlog_;
+    bool received_data_pushed_{false};
+    SharedMemoryReader shared_memory_;
     std::vector<zmq::pollitem_t> poll_items_;
     enum
     {
@@ -250,6 +459,14 @@ class InterProcessPortalReadThread
         goby::time::SystemClock::now()};
     const goby::time::SystemClock::duration hold_state_request_period_{
         std::chrono::milliseconds(100)};
+
+    // socket bound by the main thread if the Manager enables peer to peer mode (IPC only)
+    protobuf::Socket peer_publish_socket_;
+    bool peer_to_peer_{false};
+    // peer publish sockets that subscribe_socket_ is connected to
+    std::set<std::string> peer_endpoints_;
+    goby::time::SystemClock::time_point next_peer_request_time_{goby::time::SystemClock::now()};
+    const goby::time::SystemClock::duration peer_request_period_{peer_request_period};
 };
 
 template <typename InnerTransporter,
@@ -265,8 +482,11 @@ class InterProcessPortalImplementation
     InterProcessPortalImplementation(const protobuf::InterProcessPortalConfig& cfg)
         : cfg_(cfg),
           zmq_context_(cfg.zeromq_number_io_threads()),
+          received_data_(cfg.receive_queue_size()),
           zmq_main_(zmq_context_),
-          zmq_read_thread_(cfg_, zmq_context_, zmq_alive_, middleware::PollerInterface::cv())
+          zmq_read_thread_(cfg_, zmq_context_, zmq_alive_, middleware::PollerInterface::cv(),
+                           middleware::PollerInterface::poll_mutex(), received_data_,
+                           zmq_main_.batch_pending())
     {
         _init();
     }
@@ -276,8 +496,11 @@ class InterProcessPortalImplementation
         : Base(inner),
           cfg_(cfg),
           zmq_context_(cfg.zeromq_number_io_threads()),
+          received_data_(cfg.receive_queue_size()),
           zmq_main_(zmq_context_),
-          zmq_read_thread_(cfg_, zmq_context_, zmq_alive_, middleware::PollerInterface::cv())
+          zmq_read_thread_(cfg_, zmq_context_, zmq_alive_, middleware::PollerInterface::cv(),
+                           middleware::PollerInterface::poll_mutex(), received_data_,
+                           zmq_main_.batch_pending())
     {
         _init();
     }
@@ -286,6 +509,7 @@ class InterProcessPortalImplementation
     {
         if (zmq_thread_)
         {
+            zmq_main_.flush();
             zmq_main_.reader_shutdown();
             zmq_thread_->join();
         }
@@ -297,6 +521,9 @@ class InterProcessPortalImplementation
     /// \brief When using hold functionality, returns whether the system is holding (true) and thus waiting for all processes to connect and be ready, or running (false).
     bool hold_state() { return zmq_main_.hold_state(); }
 
+    /// \brief When publish_batching is configured, send all the batched publications now instead of waiting for their batch to fill or for max_latency_us
+    void flush() { zmq_main_.flush(); }
+
     friend Base;
     friend typename Base::Base;
 
@@ -305,6 +532,34 @@ class InterProcessPortalImplementation
     {
         goby::glog.set_lock_action(goby::util::logger_lock::lock);
 
+        if (cfg_.has_shared_memory())
+        {
+            if (cfg_.transport() == protobuf::InterProcessPortalConfig::IPC)
+            {
+                try
+                {
+                    SharedMemoryWriter::remove_stale(cfg_.platform());
+                    zmq_main_.enable_shared_memory(
+                        cfg_.shared_memory(), SharedMemoryWriter::unique_name(cfg_.platform()));
+                }
+                catch (const SharedMemoryException& e)
+                {
+                    goby::glog.is_warn() && goby::glog << e.what()
+                                                       << ", publishing without shared memory"
+                                                       << std::endl;
+                }
+            }
+            else
+            {
+                goby::glog.is_warn() &&
+                    goby::glog << "shared_memory is only supported for transport == IPC, ignoring"
+                               << std::endl;
+            }
+        }
+
+        if (cfg_.has_publish_batching())
+            zmq_main_.enable_batching(cfg_.publish_batching());
+
         // start zmq read thread
         zmq_thread_ = std::make_unique<std::thread>([this]() { zmq_read_thread_.run(); });
 
@@ -316,7 +571,8 @@ class InterProcessPortalImplementation
                 switch (control_msg.type())
                 {
                     case protobuf::InprocControl::PUB_CONFIGURATION:
-                        zmq_main_.set_publish_cfg(control_msg.publish_socket());
+                        zmq_main_.set_publish_cfg(control_msg.publish_socket(),
+                                                  control_msg.publish_shard_socket());
                         break;
                     default: break;
                 }
@@ -355,21 +611,48 @@ class InterProcessPortalImplementation
                   const middleware::Publisher<Data>& /*publisher*/, bool ignore_buffer = false)
     {
         std::vector<char> bytes(middleware::SerializerParserHelper<Data, scheme>::serialize(d));
-        std::string type_name = middleware::SerializerParserHelper<Data, scheme>::type_name(d);
-        _publish_serialized(type_name, scheme, bytes, group, ignore_buffer);
+        const std::string& identifier = _publish_identifier<Data, scheme>(
+            d, group, has_static_type_name<Data, scheme>());
+        zmq_main_.publish(identifier, &bytes[0], bytes.size(), ignore_buffer);
     }
 
     void _publish_serialized(std::string type_name, int scheme, const std::vector<char>& bytes,
                              const goby::middleware::Group& group, bool ignore_buffer = false)
     {
-        std::string identifier = _make_fully_qualified_identifier(type_name, scheme, group) + '\0';
+        const std::string& identifier = publish_identifiers_.find_or_create(
+            typeid(void), scheme, group, type_name.c_str(),
+            [&]() { return _make_fully_qualified_identifier(type_name, scheme, group) + '\0'; });
         zmq_main_.publish(identifier, &bytes[0], bytes.size(), ignore_buffer);
     }
 
+    // type name only depends on Data (not the value of d), so it is part of the cache key via typeid(Data)
+    template <typename Data, int scheme>
+    const std::string& _publish_identifier(const Data& /*d*/, const goby::middleware::Group& group,
+                                           std::true_type /*static type name*/)
+    {
+        return publish_identifiers_.find_or_create(typeid(Data), scheme, group, "", [&]() {
+            return _make_fully_qualified_identifier(
+                       middleware::SerializerParserHelper<Data, scheme>::type_name(), scheme,
+                       group) +
+                   '\0';
+        });
+    }
+
+    // type name is determined at runtime from d (e.g. google::protobuf::Message)
+    template <typename Data, int scheme>
+    const std::string& _publish_identifier(const Data& d, const goby::middleware::Group& group,
+                                           std::false_type /*static type name*/)
+    {
+        std::string type_name = middleware::SerializerParserHelper<Data, scheme>::type_name(d);
+        return publish_identifiers_.find_or_create(
+            typeid(Data), scheme, group, type_name.c_str(),
+            [&]() { return _make_fully_qualified_identifier(type_name, scheme, group) + '\0'; });
+    }
+
     template <typename Data, int scheme>
     void _subscribe(std::function<void(std::shared_ptr<const Data> d)> f,
                     const goby::middleware::Group& group,
-                    const middleware::Subscriber<Data>& /*subscriber*/)
+                    const middleware::Subscriber<Data>& subscriber)
     {
         std::string identifier =
             _make_identifier<Data, scheme>(group, IdentifierWildcard::PROCESS_THREAD_WILDCARD);
@@ -383,6 +666,12 @@ class InterProcessPortalImplementation
             portal_subscriptions_.count(identifier) == 0)
             zmq_main_.subscribe(identifier);
         portal_subscriptions_.insert(std::make_pair(identifier, subscription));
+
+        if (subscriber.cfg().queue_depth() > 0)
+            queue_depth_limits_.insert(std::make_pair(
+                subscription.get(),
+                QueueDepthLimit{subscriber.cfg().queue_depth(),
+                                [subscriber](std::uint64_t n) { subscriber.add_dropped(n); }}));
     }
 
     std::shared_ptr<middleware::SerializationSubscriptionRegex> _subscribe_regex(
@@ -400,11 +689,15 @@ class InterProcessPortalImplementation
     template <typename Data, int scheme>
     void _unsubscribe(
         const goby::middleware::Group& group,
-        const middleware::Subscriber<Data>& /*subscriber*/ = middleware::Subscriber<Data>())
+        const middleware::Subscriber<Data>& /*subscriber*/ =
+            middleware::Subscriber<Data>::default_instance())
     {
         std::string identifier =
             _make_identifier<Data, scheme>(group, IdentifierWildcard::PROCESS_THREAD_WILDCARD);
 
+        auto portal_range = portal_subscriptions_.equal_range(identifier);
+        for (auto it = portal_range.first; it != portal_range.second; ++it)
+            queue_depth_limits_.erase(it->second.get());
         portal_subscriptions_.erase(identifier);
 
         // If no forwarded subscriptions, do the actual unsubscribe
@@ -425,6 +718,7 @@ class InterProcessPortalImplementation
                     zmq_main_.unsubscribe(identifier);
             }
             portal_subscriptions_.clear();
+            queue_depth_limits_.clear();
         }
         else // forwarder unsubscribe
         {
@@ -448,6 +742,8 @@ class InterProcessPortalImplementation
         int items = 0;
         protobuf::InprocControl new_control_msg;
 
+        zmq_main_.flush_expired();
+
 #ifdef USE_OLD_ZMQ_CPP_API
         int flags = ZMQ_NOBLOCK;
 #else
@@ -462,63 +758,6 @@ class InterProcessPortalImplementation
             const auto& control_msg = zmq_main_.control_buffer().front();
             switch (control_msg.type())
             {
-                case protobuf::InprocControl::RECEIVE:
-                {
-                    ++items;
-                    if (lock)
-                        lock.reset();
-
-                    const auto& data = control_msg.received_data();
-
-                    std::string group, type, thread;
-                    int scheme, process;
-                    std::tie(group, scheme, type, process, thread) = parse_identifier(data);
-                    std::string identifier = _make_identifier(
-                        type, scheme, group, IdentifierWildcard::PROCESS_THREAD_WILDCARD);
-
-                    // build a set so if any of the handlers unsubscribes, we still have a pointer to the middleware::SerializationHandlerBase<>
-                    std::vector<std::weak_ptr<const middleware::SerializationHandlerBase<>>>
-                        subs_to_post;
-                    auto portal_range = portal_subscriptions_.equal_range(identifier);
-                    for (auto it = portal_range.first; it != portal_range.second; ++it)
-                        subs_to_post.push_back(it->second);
-                    auto forwarder_it = forwarder_subscriptions_.find(identifier);
-                    if (forwarder_it != forwarder_subscriptions_.end())
-                        subs_to_post.push_back(forwarder_it->second);
-
-                    // actually post the data
-                    {
-                        const auto& data = control_msg.received_data();
-                        auto null_delim_it = std::find(std::begin(data), std::end(data), '\0');
-                        for (auto& sub : subs_to_post)
-                        {
-                            if (auto sub_sp = sub.lock())
-                                sub_sp->post(null_delim_it + 1, data.end());
-                        }
-                    }
-
-                    if (!regex_subscriptions_.empty())
-                    {
-                        auto null_delim_it = std::find(std::begin(data), std::end(data), '\0');
-
-                        bool forwarder_subscription_posted = false;
-                        for (auto& sub : regex_subscriptions_)
-                        {
-                            // only post at most once for forwarders as the threads will filter
-                            bool is_forwarded_sub =
-                                sub.first != identifier_part_to_string(std::this_thread::get_id());
-                            if (is_forwarded_sub && forwarder_subscription_posted)
-                                continue;
-
-                            if (sub.second->post(null_delim_it + 1, data.end(), scheme, type,
-                                                 group) &&
-                                is_forwarded_sub)
-                                forwarder_subscription_posted = true;
-                        }
-                    }
-                }
-                break;
-
                 case protobuf::InprocControl::REQUEST_HOLD_STATE:
                 {
                     protobuf::ManagerRequest req;
@@ -541,16 +780,236 @@ class InterProcessPortalImplementation
             }
             zmq_main_.control_buffer().pop_front();
         }
+
+        zmq::message_t received_msg;
+        if (queue_depth_limits_.empty())
+        {
+            while (received_data_.pop(received_msg))
+            {
+                ++items;
+                if (lock)
+                    lock.reset();
+                _receive(received_msg);
+            }
+        }
+        else
+        {
+            // drain everything currently queued so that subscriptions with a queue_depth only
+            // receive the newest publications of this batch
+            while (received_data_.pop(received_msg))
+            {
+                ++items;
+                if (lock)
+                    lock.reset();
+                depth_limited_received_.push_back(std::move(received_msg));
+            }
+
+            // number of newer publications on the same identifier, counted newest first
+            std::vector<std::size_t> newer(depth_limited_received_.size(), 0);
+            std::unordered_map<std::string, std::size_t> counts;
+            for (auto i = depth_limited_received_.size(); i-- > 0;)
+            {
+                const auto& msg = depth_limited_received_[i];
+                const char* msg_begin = static_cast<const char*>(msg.data());
+                const char* msg_end = msg_begin + msg.size();
+                const char* delim = _find_identifier_delimiter(msg_begin, msg_end);
+                const char* type_end = _find_type_end(msg_begin, delim);
+                if (delim == msg_end || type_end == delim)
+                    continue;
+
+                std::size_t records = 1;
+                if (*delim == batch_identifier_delimiter)
+                {
+                    records = 0;
+                    const char* record = delim + 1;
+                    const char* bytes_begin;
+                    const char* bytes_end;
+                    while (_next_batch_record(record, msg_end, bytes_begin, bytes_end))
+                        ++records;
+                }
+
+                auto& count = counts[std::string(msg_begin, type_end + 1)];
+                newer[i] = count;
+                count += records;
+            }
+
+            // move out in case a handler calls poll() again
+            std::vector<zmq::message_t> msgs;
+            msgs.swap(depth_limited_received_);
+            for (decltype(msgs.size()) i = 0, n = msgs.size(); i < n; ++i)
+                _receive(msgs[i], newer[i]);
+        }
+
         return items;
     }
 
+    static const char* _find_identifier_delimiter(const char* msg_begin, const char* msg_end)
+    {
+        return std::find_if(msg_begin, msg_end, [](char c) {
+            return c == '\0' || c == batch_identifier_delimiter;
+        });
+    }
+
+    /// \return the '/' ending the "/group/scheme/type/" part of the identifier, or null_delim if malformed
+    static const char* _find_type_end(const char* msg_begin, const char* null_delim)
+    {
+        const char* type_end = msg_begin;
+        for (int i = 0; i < 3 && type_end != null_delim; ++i)
+            type_end = std::find(type_end + 1, null_delim, '/');
+        return type_end;
+    }
+
+    /// \brief Parse the batch record starting at record, advancing it to the next record
+    /// \return false if there are no more (complete) records
+    static bool _next_batch_record(const char*& record, const char* msg_end,
+                                   const char*& bytes_begin, const char*& bytes_end)
+    {
+        const int size_bytes = 4;
+        if (msg_end - record < size_bytes)
+            return false;
+        std::uint32_t size = 0;
+        for (int i = 0; i < size_bytes; ++i)
+            size |= static_cast<std::uint32_t>(static_cast<unsigned char>(record[i])) << (8 * i);
+        if (static_cast<std::uint32_t>(msg_end - record - size_bytes) < size)
+            return false;
+
+        bytes_begin = record + size_bytes;
+        bytes_end = bytes_begin + size;
+        record = bytes_end;
+        return true;
+    }
+
+    // newer is the number of publications to the same identifier received after this message
+    // (used to enforce the subscriptions' queue_depth)
+    void _receive(const zmq::message_t& received_msg, std::size_t newer = 0)
+    {
+        // identifier and data are parsed in place from the zmq buffer
+        const char* msg_begin = static_cast<const char*>(received_msg.data());
+        const char* msg_end = msg_begin + received_msg.size();
+        const char* delim = _find_identifier_delimiter(msg_begin, msg_end);
+        if (delim == msg_end)
+        {
+            goby::glog.is_warn() && goby::glog << "Received data without identifier delimiter"
+                                               << std::endl;
+            return;
+        }
+
+        if (*delim == '\0')
+        {
+            _receive(msg_begin, delim, delim + 1, msg_end, newer);
+            return;
+        }
+
+        // batch of publications to the same identifier
+        const char* record = delim + 1;
+        const char* bytes_begin;
+        const char* bytes_end;
+        // records in this batch after the current one (only needed for queue_depth)
+        std::size_t remaining = 0;
+        if (!queue_depth_limits_.empty())
+        {
+            while (_next_batch_record(record, msg_end, bytes_begin, bytes_end))
+                ++remaining;
+            record = delim + 1;
+        }
+
+        while (_next_batch_record(record, msg_end, bytes_begin, bytes_end))
+        {
+            if (remaining > 0)
+                --remaining;
+            _receive(msg_begin, delim, bytes_begin, bytes_end, newer + remaining);
+        }
+
+        if (record != msg_end)
+            goby::glog.is_warn() && goby::glog << "Received truncated batch" << std::endl;
+    }
+
+    void _receive(const char* msg_begin, const char* null_delim, const char* bytes_begin,
+                  const char* bytes_end, std::size_t newer = 0)
+    {
+        // "/group/scheme/type/" is the PROCESS_THREAD_WILDCARD identifier used for the subscription maps
+        const char* type_end = _find_type_end(msg_begin, null_delim);
+        if (type_end == null_delim)
+        {
+            goby::glog.is_warn() && goby::glog << "Received data with malformed identifier"
+                                               << std::endl;
+            return;
+        }
+        // reuse the buffer's capacity to avoid allocating for each message
+        received_identifier_.assign(msg_begin, type_end + 1);
+
+        // build a set so if any of the handlers unsubscribes, we still have a pointer to the middleware::SerializationHandlerBase<>
+        // (reuses the capacity of the member buffers, which are swapped out in case a handler calls poll() again)
+        std::vector<std::weak_ptr<const middleware::SerializationHandlerBase<>>> subs_to_post;
+        subs_to_post.swap(subs_to_post_buffer_);
+        middleware::SerializationPostCache post_cache;
+        std::swap(post_cache, post_cache_buffer_);
+
+        auto portal_range = portal_subscriptions_.equal_range(received_identifier_);
+        for (auto it = portal_range.first; it != portal_range.second; ++it)
+        {
+            if (newer > 0)
+            {
+                auto limit_it = queue_depth_limits_.find(it->second.get());
+                if (limit_it != queue_depth_limits_.end() && newer >= limit_it->second.depth)
+                {
+                    limit_it->second.add_dropped(1);
+                    continue;
+                }
+            }
+            subs_to_post.push_back(it->second);
+        }
+        auto forwarder_it = forwarder_subscriptions_.find(received_identifier_);
+        if (forwarder_it != forwarder_subscriptions_.end())
+            subs_to_post.push_back(forwarder_it->second);
+
+        // actually post the data
+        {
+            // all the subscriptions to this identifier share a single parse of the data
+            for (auto& sub : subs_to_post)
+            {
+                if (auto sub_sp = sub.lock())
+                    sub_sp->post_cached(bytes_begin, bytes_end, post_cache);
+            }
+        }
+
+        subs_to_post.clear();
+        subs_to_post.swap(subs_to_post_buffer_);
+        post_cache.clear();
+        std::swap(post_cache, post_cache_buffer_);
+
+        if (!regex_subscriptions_.empty())
+        {
+            std::string group, type;
+            int scheme;
+            std::tie(group, scheme, type) = parse_identifier(msg_begin, null_delim);
+
+            bool forwarder_subscription_posted = false;
+            for (auto& sub : regex_subscriptions_)
+            {
+                // only post at most once for forwarders as the threads will filter
+                bool is_forwarded_sub =
+                    sub.first != identifier_part_to_string(std::this_thread::get_id());
+                if (is_forwarded_sub && forwarder_subscription_posted)
+                    continue;
+
+                if (sub.second->post(bytes_begin, bytes_end, scheme, type, group) &&
+                    is_forwarded_sub)
+                    forwarder_subscription_posted = true;
+            }
+        }
+    }
+
     void _receive_publication_forwarded(
         const goby::middleware::protobuf::SerializerTransporterMessage& msg)
     {
-        std::string identifier =
-            _make_identifier(msg.key().type(), msg.key().marshalling_scheme(), msg.key().group(),
-                             IdentifierWildcard::NO_WILDCARDS) +
-            '\0';
+        const auto& key = msg.key();
+        const std::string& identifier = publish_identifiers_.find_or_create(
+            typeid(void), key.marshalling_scheme(), key.group(), key.type().c_str(), [&]() {
+                return _make_identifier(key.type(), key.marshalling_scheme(), key.group(),
+                                        IdentifierWildcard::NO_WILDCARDS) +
+                       '\0';
+            });
         auto& bytes = msg.data();
         zmq_main_.publish(identifier, &bytes[0], bytes.size());
     }
@@ -673,21 +1132,21 @@ class InterProcessPortalImplementation
         return make_identifier(type_name, scheme, group, wildcard, process_, &schemes_, &threads_);
     }
 
-    // group, scheme, type, process, thread
-    std::tuple<std::string, int, std::string, int, std::size_t>
-    parse_identifier(const std::string& identifier)
+    // group, scheme, type from [identifier_begin, identifier_end)
+    std::tuple<std::string, int, std::string> parse_identifier(const char* identifier_begin,
+                                                               const char* identifier_end)
     {
-        const int number_elements = 5;
-        std::string::size_type previous_slash = 0;
-        std::vector<std::string> elem;
-        for (auto i = 0; i < number_elements; ++i)
+        const int number_elements = 3;
+        std::string elem[number_elements];
+        const char* previous_slash = identifier_begin;
+        for (auto i = 0; i < number_elements && previous_slash != identifier_end; ++i)
         {
-            auto slash_pos = identifier.find('/', previous_slash + 1);
-            elem.push_back(identifier.substr(previous_slash + 1, slash_pos - (previous_slash + 1)));
-            previous_slash = slash_pos;
+            const char* slash = std::find(previous_slash + 1, identifier_end, '/');
+            elem[i].assign(previous_slash + 1, slash);
+            previous_slash = slash;
         }
         return std::make_tuple(elem[0], middleware::MarshallingScheme::from_string(elem[1]),
-                               elem[2], std::stoi(elem[3]), std::stoull(elem[4], nullptr, 16));
+                               elem[2]);
     }
 
   private:
@@ -696,6 +1155,7 @@ class InterProcessPortalImplementation
     std::unique_ptr<std::thread> zmq_thread_;
     std::atomic<bool> zmq_alive_{true};
     zmq::context_t zmq_context_;
+    InterProcessReceiveQueue received_data_;
     InterProcessPortalMainThread zmq_main_;
     InterProcessPortalReadThread zmq_read_thread_;
 
@@ -717,31 +1177,74 @@ class InterProcessPortalImplementation
     std::string process_{std::to_string(getpid())};
     std::unordered_map<int, std::string> schemes_;
     std::unordered_map<std::thread::id, std::string> threads_;
+    PublishIdentifierCache publish_identifiers_;
+
+    // buffers reused for each received message
+    std::string received_identifier_;
+    std::vector<std::weak_ptr<const middleware::SerializationHandlerBase<>>> subs_to_post_buffer_;
+
+    // portal subscriptions with a non-zero TransporterConfig::queue_depth
+    struct QueueDepthLimit
+    {
+        std::size_t depth;
+        std::function<void(std::uint64_t)> add_dropped;
+    };
+    std::unordered_map<const middleware::SerializationHandlerBase<>*, QueueDepthLimit>
+        queue_depth_limits_;
+    std::vector<zmq::message_t> depth_limited_received_;
+    middleware::SerializationPostCache post_cache_buffer_;
 
     bool ready_{false};
 };
 
+/// \brief Forwards publications between InterProcessPortals using cfg.router_shards() XPUB/XSUB proxies ("shards"), each run on its own thread
 class Router
 {
   public:
-    Router(zmq::context_t& context, const protobuf::InterProcessPortalConfig& cfg)
-        : context_(context), cfg_(cfg)
-    {
-    }
+    Router(zmq::context_t& context, const protobuf::InterProcessPortalConfig& cfg);
 
+    /// \brief Run all the shards (shard 0 on the calling thread) until the context is terminated
     void run();
     unsigned last_port(zmq::socket_t& socket);
 
     Router(Router&) = delete;
     Router& operator=(Router&) = delete;
 
+    unsigned shards() const { return shards_.size(); }
+    /// \brief TCP port of the XPUB socket for a given shard (0 until bound)
+    unsigned shard_pub_port(unsigned shard) const { return shards_.at(shard)->pub_port; }
+    /// \brief TCP port of the XSUB socket for a given shard (0 until bound)
+    unsigned shard_sub_port(unsigned shard) const { return shards_.at(shard)->sub_port; }
+
+    /// \brief Statistics for each shard, with rates computed since the previous call to status()
+    protobuf::RouterStatus status();
+
   public:
+    // shard 0
     std::atomic<unsigned> pub_port{0};
     std::atomic<unsigned> sub_port{0};
 
+  private:
+    struct Shard
+    {
+        std::atomic<unsigned> pub_port{0};
+        std::atomic<unsigned> sub_port{0};
+        std::atomic<std::uint64_t> messages{0};
+        std::atomic<std::uint64_t> bytes{0};
+        std::atomic<std::uint64_t> hwm_drops{0};
+    };
+
+    void run_shard(unsigned index);
+    void forward_publications(Shard& shard, zmq::socket_t& backend, zmq::socket_t& frontend);
+
   private:
     zmq::context_t& context_;
     const protobuf::InterProcessPortalConfig& cfg_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::mutex status_mutex_;
+    protobuf::RouterStatus last_status_;
+    std::chrono::steady_clock::time_point last_status_time_{std::chrono::steady_clock::now()};
 };
 
 class Manager
@@ -760,15 +1263,28 @@ class Manager
     void run();
 
     protobuf::ManagerResponse handle_request(const protobuf::ManagerRequest& pb_request);
-    protobuf::Socket publish_socket_cfg();
-    protobuf::Socket subscribe_socket_cfg();
+    protobuf::Socket publish_socket_cfg(unsigned shard = 0);
+    protobuf::Socket subscribe_socket_cfg(unsigned shard = 0);
 
     bool hold_state();
 
+  private:
+    void update_peers(const protobuf::ManagerRequest& pb_request,
+                      protobuf::ManagerResponse* pb_response);
+    bool peer_connecting(const protobuf::ManagerRequest& pb_request);
+
   private:
     std::set<std::string> reported_clients_;
     std::set<std::string> required_clients_;
 
+    struct Peer
+    {
+        protobuf::Socket publish_socket;
+        std::chrono::steady_clock::time_point registered;
+    };
+    // client (name, pid) to peer, when cfg_.peer_to_peer() is true
+    std::map<std::pair<std::string, int>, Peer> peers_;
+
     zmq::context_t& context_;
     const protobuf::InterProcessPortalConfig& cfg_;
     const Router& router_;
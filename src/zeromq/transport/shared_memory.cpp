@@ -0,0 +1,408 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>  // for replace, all_of
+#include <cctype>     // for isdigit, isxdigit
+#include <cerrno>     // for errno
+#include <cstdlib>    // for atexit
+#include <cstring>    // for memcpy, strerror
+#include <dirent.h>   // for opendir, readdir
+#include <fcntl.h>    // for O_RDWR, O_CREAT, posix_fallocate
+#include <mutex>      // for mutex, lock_guard
+#include <new>        // for placement new
+#include <random>     // for random_device
+#include <set>        // for set
+#include <signal.h>   // for kill
+#include <sstream>    // for stringstream
+#include <sys/mman.h> // for mmap, munmap, shm_open
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close
+
+#include "goby/util/debug_logger/flex_ostream.h" // for glog
+
+#include "shared_memory.h"
+
+using goby::glog;
+using namespace goby::util::logger;
+
+namespace
+{
+constexpr std::uint64_t segment_magic{0x676f627973686d31ull}; // "gobyshm1"
+constexpr std::uint32_t segment_version{1};
+// segment and slot headers are each padded to one cache line
+constexpr std::size_t header_size{64};
+static_assert(sizeof(goby::zeromq::detail::SharedMemorySegmentHeader) <= header_size,
+              "SharedMemorySegmentHeader too large");
+static_assert(sizeof(goby::zeromq::detail::SharedMemorySlotHeader) <= header_size,
+              "SharedMemorySlotHeader too large");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Shared memory transport requires lock-free atomics");
+
+// how long to keep an unused segment mapped after the last publication referencing it
+constexpr std::chrono::seconds segment_expire_time{10};
+
+std::uint64_t padded_slot_size(std::uint64_t slot_size)
+{
+    return header_size + (slot_size + header_size - 1) / header_size * header_size;
+}
+
+std::uint64_t segment_size(std::uint32_t slot_count, std::uint64_t slot_size)
+{
+    return header_size + slot_count * padded_slot_size(slot_size);
+}
+
+// "/goby_{platform}_", followed by the pid and random hex digits (see unique_name())
+std::string name_prefix(const std::string& platform)
+{
+    // shm_open names may not contain '/' other than the leading one
+    std::string prefix = "/goby_" + platform + "_";
+    std::replace(prefix.begin() + 1, prefix.end(), '/', '_');
+    return prefix;
+}
+
+// segments of the writers in this process, so that they are unlinked by exit() (e.g. from
+// glog.is_die()), which does not run the writers' destructors
+std::mutex& live_segments_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::set<std::string>& live_segments()
+{
+    static std::set<std::string> segments;
+    return segments;
+}
+
+void unlink_live_segments()
+{
+    std::lock_guard<std::mutex> lock(live_segments_mutex());
+    for (const auto& name : live_segments()) ::shm_unlink(name.c_str());
+    live_segments().clear();
+}
+
+void add_live_segment(const std::string& name)
+{
+    // constructed before the handler is registered, so that they are destroyed after it runs
+    std::lock_guard<std::mutex> lock(live_segments_mutex());
+    live_segments();
+    static bool unlink_at_exit = (std::atexit(unlink_live_segments) == 0);
+    (void)unlink_at_exit;
+    live_segments().insert(name);
+}
+
+void remove_live_segment(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(live_segments_mutex());
+    live_segments().erase(name);
+}
+} // namespace
+
+goby::zeromq::detail::SharedMemoryMapping::~SharedMemoryMapping() { ::munmap(addr_, size_); }
+
+goby::zeromq::detail::SharedMemorySlotHeader*
+goby::zeromq::detail::SharedMemoryMapping::slot(std::uint32_t slot)
+{
+    if (slot >= segment()->slot_count)
+        return nullptr;
+
+    return reinterpret_cast<SharedMemorySlotHeader*>(static_cast<char*>(addr_) + header_size +
+                                                     slot * padded_slot_size(segment()->slot_size));
+}
+
+//
+// SharedMemoryWriter
+//
+
+goby::zeromq::SharedMemoryWriter::SharedMemoryWriter(const protobuf::SharedMemoryConfig& cfg,
+                                                     std::string name)
+    : cfg_(cfg), name_(std::move(name))
+{
+    if (cfg_.slot_count() == 0)
+        throw(SharedMemoryException("shared_memory.slot_count must be greater than zero"));
+
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd == -1)
+        throw(SharedMemoryException("Failed to create shared memory segment " + name_ + ": " +
+                                    std::strerror(errno)));
+
+    // reserve all the pages now: writing to a sparse segment once /dev/shm is full raises
+    // SIGBUS rather than returning an error
+    auto size = segment_size(cfg_.slot_count(), cfg_.slot_size());
+    int err = ::posix_fallocate(fd, 0, size);
+    if (err != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(name_.c_str());
+        throw(SharedMemoryException("Failed to reserve " + std::to_string(size) +
+                                    " bytes for shared memory segment " + name_ + ": " +
+                                    std::strerror(err)));
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    err = errno;
+    ::close(fd);
+
+    if (addr == MAP_FAILED)
+    {
+        ::shm_unlink(name_.c_str());
+        throw(SharedMemoryException("Failed to map shared memory segment " + name_ + ": " +
+                                    std::strerror(err)));
+    }
+
+    mapping_.reset(new detail::SharedMemoryMapping(addr, size));
+    add_live_segment(name_);
+
+    auto& segment = *mapping_->segment();
+    segment.magic = segment_magic;
+    segment.version = segment_version;
+    segment.slot_count = cfg_.slot_count();
+    segment.slot_size = cfg_.slot_size();
+    for (std::uint32_t i = 0; i < cfg_.slot_count(); ++i)
+    {
+        auto* slot = new (mapping_->slot(i)) detail::SharedMemorySlotHeader;
+        slot->generation = 0;
+        slot->readers = 0;
+        slot->size = 0;
+    }
+    // never written slots can be used immediately
+    slot_written_.resize(cfg_.slot_count(), std::chrono::steady_clock::time_point::min());
+
+    glog.is_debug1() && glog << "Created shared memory segment " << name_ << " ("
+                             << cfg_.slot_count() << " slots of " << cfg_.slot_size()
+                             << " bytes)" << std::endl;
+}
+
+goby::zeromq::SharedMemoryWriter::~SharedMemoryWriter()
+{
+    ::shm_unlink(name_.c_str());
+    remove_live_segment(name_);
+}
+
+std::string goby::zeromq::SharedMemoryWriter::unique_name(const std::string& platform)
+{
+    std::random_device rd;
+    std::stringstream ss;
+    ss << std::hex << rd() << rd();
+    return name_prefix(platform) + std::to_string(getpid()) + "_" + ss.str();
+}
+
+void goby::zeromq::SharedMemoryWriter::remove_stale(const std::string& platform)
+{
+    // shm_open names are files in /dev/shm on Linux
+    DIR* dir = ::opendir("/dev/shm");
+    if (!dir)
+        return;
+
+    // without the leading '/'
+    const std::string prefix = name_prefix(platform).substr(1);
+    while (const struct dirent* entry = ::readdir(dir))
+    {
+        std::string file(entry->d_name);
+        if (file.compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        // {pid}_{hex}
+        auto pid_end = file.find('_', prefix.size());
+        if (pid_end == std::string::npos || pid_end == prefix.size() || pid_end + 1 == file.size())
+            continue;
+        auto is_digit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)); };
+        auto is_xdigit = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)); };
+        if (!std::all_of(file.begin() + prefix.size(), file.begin() + pid_end, is_digit) ||
+            !std::all_of(file.begin() + pid_end + 1, file.end(), is_xdigit) ||
+            pid_end - prefix.size() > 9)
+            continue;
+
+        pid_t pid = std::stoi(file.substr(prefix.size(), pid_end - prefix.size()));
+        if (pid == getpid() || ::kill(pid, 0) == 0 || errno != ESRCH)
+            continue;
+
+        glog.is_debug1() && glog << "Removing shared memory segment /" << file
+                                 << " of exited process " << pid << std::endl;
+        ::shm_unlink(("/" + file).c_str());
+    }
+    ::closedir(dir);
+}
+
+bool goby::zeromq::SharedMemoryWriter::write(const std::string& identifier, const char* bytes,
+                                             std::size_t size,
+                                             protobuf::SharedMemoryDescriptor* descriptor)
+{
+    std::size_t total_size = identifier.size() + size;
+    if (total_size > cfg_.slot_size())
+        return false;
+
+    auto now = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0, n = cfg_.slot_count(); i < n; ++i)
+    {
+        std::uint32_t slot_index = (next_slot_ + i) % n;
+        if (!reclaim(slot_index, now))
+            continue;
+
+        auto* slot = mapping_->slot(slot_index);
+        char* data = reinterpret_cast<char*>(slot + 1);
+        std::memcpy(data, identifier.data(), identifier.size());
+        std::memcpy(data + identifier.size(), bytes, size);
+        slot->size = total_size;
+
+        descriptor->set_segment(name_);
+        descriptor->set_slot(slot_index);
+        descriptor->set_generation(slot->generation.load());
+        descriptor->set_size(total_size);
+
+        slot_written_[slot_index] = now;
+        next_slot_ = (slot_index + 1) % n;
+        return true;
+    }
+
+    glog.is_debug2() && glog << "No free slot in shared memory segment " << name_ << std::endl;
+    return false;
+}
+
+bool goby::zeromq::SharedMemoryWriter::reclaim(std::uint32_t slot_index,
+                                               std::chrono::steady_clock::time_point now)
+{
+    auto* slot = mapping_->slot(slot_index);
+    if (slot->readers.load() != 0)
+        return false;
+
+    // the descriptor for the current contents may still be on its way to some of the subscribers
+    // (even if others have already read it)
+    if (now < slot_written_[slot_index] + std::chrono::milliseconds(cfg_.min_slot_reuse_ms()))
+        return false;
+
+    // invalidate the previous contents for readers that have not yet acquired the slot
+    slot->generation.store(++generation_);
+
+    // a reader may have acquired the slot (and validated the previous generation) between the first check and the generation change
+    return slot->readers.load() == 0;
+}
+
+//
+// SharedMemoryReader
+//
+
+std::unique_ptr<goby::zeromq::SharedMemoryReader::View>
+goby::zeromq::SharedMemoryReader::acquire(const protobuf::SharedMemoryDescriptor& descriptor)
+{
+    expire_unused();
+
+    auto mapping = map(descriptor.segment());
+    if (!mapping)
+        return nullptr;
+
+    auto* slot = mapping->slot(descriptor.slot());
+    if (!slot)
+    {
+        glog.is_warn() && glog << "Invalid shared memory descriptor: "
+                               << descriptor.ShortDebugString() << std::endl;
+        return nullptr;
+    }
+
+    // pin the slot, then check that it was not reused before we pinned it
+    slot->readers.fetch_add(1);
+    std::unique_ptr<View> view(new View(std::move(mapping), slot));
+    if (slot->generation.load() != descriptor.generation() || slot->size != descriptor.size())
+    {
+        ++dropped_;
+        glog.is_warn() && glog << "Shared memory slot was reused before it could be read, "
+                                  "dropping publication (" << dropped_ << " dropped so far): "
+                               << descriptor.ShortDebugString() << std::endl;
+        return nullptr;
+    }
+    return view;
+}
+
+std::shared_ptr<goby::zeromq::detail::SharedMemoryMapping>
+goby::zeromq::SharedMemoryReader::map(const std::string& name)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto it = segments_.find(name);
+    if (it != segments_.end())
+    {
+        it->second.last_used = now;
+        return it->second.mapping;
+    }
+
+    std::shared_ptr<detail::SharedMemoryMapping> mapping;
+    std::string error;
+
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    struct stat st;
+    if (fd == -1 || ::fstat(fd, &st) == -1)
+    {
+        error = std::strerror(errno);
+    }
+    else if (static_cast<std::size_t>(st.st_size) < header_size)
+    {
+        error = "segment too small";
+    }
+    else
+    {
+        void* addr =
+            ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            error = std::strerror(errno);
+        }
+        else
+        {
+            mapping = std::make_shared<detail::SharedMemoryMapping>(addr, st.st_size);
+            const auto& segment = *mapping->segment();
+            if (segment.magic != segment_magic || segment.version != segment_version ||
+                segment_size(segment.slot_count, segment.slot_size) >
+                    static_cast<std::uint64_t>(st.st_size))
+            {
+                error = "invalid segment header";
+                mapping.reset();
+            }
+        }
+    }
+    if (fd != -1)
+        ::close(fd);
+
+    // also cache failures so that we do not retry (and warn) for every publication
+    if (!mapping)
+        glog.is_warn() && glog << "Failed to map shared memory segment " << name << " ("
+                               << error << "), dropping publications that use it" << std::endl;
+
+    segments_.insert(std::make_pair(name, Segment{mapping, now}));
+    return mapping;
+}
+
+void goby::zeromq::SharedMemoryReader::expire_unused()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_expire_)
+        return;
+    next_expire_ = now + std::chrono::seconds(1);
+
+    // unmap segments with no Views that have not been used recently (e.g. the writer has exited), so that their memory can be freed
+    for (auto it = segments_.begin(); it != segments_.end();)
+    {
+        if (it->second.mapping.use_count() <= 1 && now > it->second.last_used + segment_expire_time)
+            it = segments_.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,196 @@
+// Copyright 2023:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Goby Underwater Autonomy Project Libraries
+// ("The Goby Libraries").
+//
+// The Goby Libraries are free software: you can redistribute them and/or modify
+// them under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// The Goby Libraries are distributed in the hope that they will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Goby.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOBY_ZEROMQ_TRANSPORT_SHARED_MEMORY_H
+#define GOBY_ZEROMQ_TRANSPORT_SHARED_MEMORY_H
+
+#include <atomic>        // for atomic
+#include <chrono>        // for steady_clock
+#include <cstdint>       // for uint64_t, uint32_t
+#include <memory>        // for shared_ptr, unique_ptr
+#include <string>        // for string
+#include <unordered_map> // for unordered_map
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include "goby/exception.h"                              // for Exception
+#include "goby/zeromq/protobuf/interprocess_config.pb.h" // for SharedMemoryConfig
+#include "goby/zeromq/protobuf/interprocess_zeromq.pb.h" // for SharedMemoryDescriptor
+
+namespace goby
+{
+namespace zeromq
+{
+namespace detail
+{
+/// \brief Header at the start of each slot of a shared memory segment
+struct SharedMemorySlotHeader
+{
+    // changed by the writer each time the slot is reused; readers compare it to SharedMemoryDescriptor::generation
+    std::atomic<std::uint64_t> generation;
+    // number of readers that currently reference the slot's contents
+    std::atomic<std::uint32_t> readers;
+    std::uint32_t reserved;
+    std::uint64_t size;
+};
+
+/// \brief Header at the start of a shared memory segment
+struct SharedMemorySegmentHeader
+{
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t slot_count;
+    std::uint64_t slot_size;
+};
+
+/// \brief A mapped shared memory segment (unmapped on destruction)
+class SharedMemoryMapping
+{
+  public:
+    SharedMemoryMapping(void* addr, std::size_t size) : addr_(addr), size_(size) {}
+    ~SharedMemoryMapping();
+    SharedMemoryMapping(const SharedMemoryMapping&) = delete;
+    SharedMemoryMapping& operator=(const SharedMemoryMapping&) = delete;
+
+    SharedMemorySegmentHeader* segment() { return static_cast<SharedMemorySegmentHeader*>(addr_); }
+    /// \brief Returns the header of the given slot (the data follow the header), or nullptr if slot is out of range
+    SharedMemorySlotHeader* slot(std::uint32_t slot);
+
+  private:
+    void* addr_;
+    std::size_t size_;
+};
+} // namespace detail
+
+/// \brief Thrown on failure to create or map a shared memory segment
+class SharedMemoryException : public goby::Exception
+{
+  public:
+    SharedMemoryException(const std::string& s) : Exception(s) {}
+};
+
+/// \brief Writes large publications into a shared memory (/dev/shm) segment owned by this process, so that only a small SharedMemoryDescriptor has to be sent over ZeroMQ
+///
+/// The segment is divided into a fixed number of equally sized slots, which are reused in turn. A slot is only reused if no reader is referencing it (see SharedMemoryReader), and its contents were written at least SharedMemoryConfig::min_slot_reuse_ms ago (so that descriptors still on their way to any of the subscribers remain valid, as the writer does not know how many subscribers there are); otherwise the next slot is tried, and if none are free write() returns false so that the caller can send the data over ZeroMQ instead. A reader that exits abnormally while referencing a slot leaves that slot unavailable for the lifetime of the writer.
+class SharedMemoryWriter
+{
+  public:
+    /// \param cfg Segment configuration
+    /// \param name Name of the segment (as given to shm_open, e.g. "/goby_platform_1234_5f3a"). This should be unique for each writer, as readers cache segments by name.
+    /// \throw SharedMemoryException if the segment cannot be created, or its memory cannot be reserved (e.g. /dev/shm is too small)
+    SharedMemoryWriter(const protobuf::SharedMemoryConfig& cfg, std::string name);
+    /// \brief Unlinks the segment (readers that have it mapped can continue to use it)
+    ///
+    /// Segments are also unlinked if the process calls exit() (e.g. glog.is_die()) without destroying the writer. Segments left behind by a process that was killed or crashed are removed by remove_stale().
+    ~SharedMemoryWriter();
+
+    SharedMemoryWriter(const SharedMemoryWriter&) = delete;
+    SharedMemoryWriter& operator=(const SharedMemoryWriter&) = delete;
+
+    /// \brief Should this publication be written to shared memory?
+    bool use_for(std::size_t size) const { return size >= cfg_.threshold(); }
+
+    /// \brief Write identifier followed by bytes into a free slot
+    ///
+    /// \param identifier '\0' terminated identifier
+    /// \param bytes Data to write
+    /// \param size Size of bytes
+    /// \param descriptor Set to the location of the data on success
+    /// \return true if the data were written, false if they do not fit in a slot or no slot is free
+    bool write(const std::string& identifier, const char* bytes, std::size_t size,
+               protobuf::SharedMemoryDescriptor* descriptor);
+
+    const std::string& name() const { return name_; }
+
+    /// \brief Returns a segment name for a new writer in this process that is not reused by later writers (even if the pid is reused)
+    static std::string unique_name(const std::string& platform);
+
+    /// \brief Unlinks the segments named by unique_name() for this platform whose process no longer exists (e.g. it was killed or crashed)
+    static void remove_stale(const std::string& platform);
+
+  private:
+    bool reclaim(std::uint32_t slot_index, std::chrono::steady_clock::time_point now);
+
+  private:
+    const protobuf::SharedMemoryConfig cfg_;
+    const std::string name_;
+    std::unique_ptr<detail::SharedMemoryMapping> mapping_;
+    std::vector<std::chrono::steady_clock::time_point> slot_written_;
+    std::uint32_t next_slot_{0};
+    std::uint64_t generation_{0};
+};
+
+/// \brief Maps shared memory segments referenced by received SharedMemoryDescriptors and provides access to their contents
+///
+/// Not thread-safe (used only by the InterProcessPortalReadThread), but View objects may be destroyed from any thread.
+class SharedMemoryReader
+{
+  public:
+    /// \brief Reference to the contents of a slot. The writer does not reuse the slot while this exists.
+    class View
+    {
+      public:
+        View(std::shared_ptr<detail::SharedMemoryMapping> mapping,
+             detail::SharedMemorySlotHeader* slot)
+            : mapping_(std::move(mapping)), slot_(slot)
+        {
+        }
+        ~View() { slot_->readers.fetch_sub(1); }
+        View(const View&) = delete;
+        View& operator=(const View&) = delete;
+
+        const char* data() const { return reinterpret_cast<const char*>(slot_ + 1); }
+        std::size_t size() const { return slot_->size; }
+
+      private:
+        std::shared_ptr<detail::SharedMemoryMapping> mapping_;
+        detail::SharedMemorySlotHeader* slot_;
+    };
+
+    /// \brief Acquire a reference to the data described by descriptor
+    ///
+    /// \return View of the data, or nullptr if the segment cannot be mapped or the slot has already been reused by the writer
+    std::unique_ptr<View> acquire(const protobuf::SharedMemoryDescriptor& descriptor);
+
+    /// \brief Number of publications dropped because their slot was reused before they were acquired
+    std::uint64_t dropped() const { return dropped_; }
+
+  private:
+    std::shared_ptr<detail::SharedMemoryMapping> map(const std::string& name);
+    void expire_unused();
+
+  private:
+    struct Segment
+    {
+        std::shared_ptr<detail::SharedMemoryMapping> mapping;
+        std::chrono::steady_clock::time_point last_used;
+    };
+    std::unordered_map<std::string, Segment> segments_;
+    std::chrono::steady_clock::time_point next_expire_{std::chrono::steady_clock::now()};
+    std::uint64_t dropped_{0};
+};
+
+} // namespace zeromq
+} // namespace goby
+
+#endif